@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""Binary payload bridge.
+
+Field nodes built with MQTT_PAYLOAD_FORMAT = MQTT_PAYLOAD_BINARY publish
+compact payloads on "<topic>/bin" (see interfacing/src/App/MQTT_APP/mqtt_codec.h).
+This bridge decodes them and republishes the usual JSON on "<topic>", so
+Telegraf and everything downstream stay unchanged. Records replayed from the
+node's offline log arrive on "<topic>/replay/bin" and go out on "<topic>/replay".
+
+    byte 0      version << 4 | message type
+    byte 1..2   field mask, little endian, bit n = field n present
+    ...         present fields in bit order, little endian, fixed width
+"""
+import os
+import sys
+import json
+import time
+import signal
+import struct
+
+import paho.mqtt.client as mqtt
+
+MQTT_HOST = os.getenv("MQTT_HOST", "127.0.0.1")
+MQTT_PORT = int(os.getenv("MQTT_PORT", "1883"))
+TOPIC_SUFFIX = "/bin"
+
+CODEC_VERSIONS = (1, 2)
+TYPE_TELEMETRY = 1
+TYPE_DECISION = 2
+TYPE_HEARTBEAT = 3
+
+# (bit, key, struct format, scale) in bit order; must match mqtt_codec.h
+TELEMETRY_FIELDS = [
+    (0, "soil_moisture", "<H", 10.0),
+    (1, "temperature", "<h", 10.0),
+    (2, "humidity", "<H", 10.0),
+    (3, "age_s", "<I", None),
+    (4, "ph", "<H", 100.0),
+    (5, "n", "<H", 10.0),
+    (6, "p", "<H", 10.0),
+    (7, "k", "<H", 10.0),
+    (8, "ts", "<I", None),
+]
+
+# Version 1 decisions have no zone; they all come from zone 0
+DECISION_FIELDS_V1 = [
+    (0, "decision", "<B", None),
+    (1, "timestamp", "<I", None),
+    (2, "ts", "<I", None),
+]
+
+DECISION_FIELDS = [
+    (0, "decision", "<B", None),
+    (1, "timestamp", "<I", None),
+    (2, "zone", "<B", None),
+    (3, "ts", "<I", None),
+]
+
+HEARTBEAT_FIELDS = [
+    (0, "online", "<B", None),
+]
+
+DECISION_NAMES = {0: "IRRIGATE", 1: "NO_IRRIGATION", 2: "CHECK_SYSTEM"}
+
+SCHEMAS = {
+    TYPE_TELEMETRY: TELEMETRY_FIELDS,
+    TYPE_DECISION: DECISION_FIELDS,
+    TYPE_HEARTBEAT: HEARTBEAT_FIELDS,
+}
+
+SCHEMAS_V1 = {**SCHEMAS, TYPE_DECISION: DECISION_FIELDS_V1}
+
+running = True
+
+
+def handle_sig(*_):
+    global running
+    running = False
+
+
+signal.signal(signal.SIGINT, handle_sig)
+signal.signal(signal.SIGTERM, handle_sig)
+
+
+def decode(payload: bytes):
+    """Return (message type, fields dict); raises ValueError on a bad payload."""
+    if len(payload) < 3:
+        raise ValueError("short payload")
+
+    version, msg_type = payload[0] >> 4, payload[0] & 0x0F
+    if version not in CODEC_VERSIONS:
+        raise ValueError(f"unsupported version {version}")
+    schemas = SCHEMAS_V1 if version == 1 else SCHEMAS
+    if msg_type not in schemas:
+        raise ValueError(f"unknown message type {msg_type}")
+
+    mask = struct.unpack_from("<H", payload, 1)[0]
+    offset = 3
+    fields = {}
+    known = 0
+    for bit, key, fmt, scale in schemas[msg_type]:
+        known |= 1 << bit
+        if not mask & (1 << bit):
+            continue
+        value = struct.unpack_from(fmt, payload, offset)[0]
+        offset += struct.calcsize(fmt)
+        fields[key] = round(value / scale, 2) if scale else value
+
+    if mask & ~known:
+        # Newer firmware appended fields this bridge does not know yet
+        print(f"[bridge] ignoring unknown fields mask=0x{mask & ~known:04x}", flush=True)
+    return msg_type, fields
+
+
+def to_json(topic: str, msg_type: int, fields: dict) -> dict:
+    # farm/<site>/<node>/<kind>[/replay]
+    parts = topic.split("/")
+    site, node = (parts[1], parts[2]) if len(parts) >= 4 else ("", "")
+
+    if msg_type == TYPE_TELEMETRY:
+        return {"site": site, "node": node, **fields}
+    if msg_type == TYPE_HEARTBEAT:
+        return {"site": site, "node": node, "online": bool(fields.get("online", 0))}
+    # Decision keeps the firmware's JSON shape
+    out = {}
+    if "timestamp" in fields:
+        out["timestamp"] = fields["timestamp"]
+    out["decision"] = DECISION_NAMES.get(fields.get("decision"), "UNKNOWN")
+    out["zone"] = fields.get("zone", 0)
+    if "ts" in fields:
+        out["ts"] = fields["ts"]
+    return out
+
+
+def on_connect(client, userdata, flags, reason_code, properties=None):
+    print(f"[bridge] connected rc={reason_code} host={MQTT_HOST}:{MQTT_PORT}", flush=True)
+    client.subscribe([("farm/+/+/+" + TOPIC_SUFFIX, 1), ("farm/+/+/+/replay" + TOPIC_SUFFIX, 1)])
+
+
+def on_message(client, userdata, msg):
+    try:
+        msg_type, fields = decode(msg.payload)
+    except (ValueError, struct.error) as err:
+        print(f"[bridge] drop {msg.topic}: {err}", flush=True)
+        return
+
+    topic = msg.topic[: -len(TOPIC_SUFFIX)]
+    client.publish(topic, json.dumps(to_json(topic, msg_type, fields)), qos=msg.qos)
+
+
+def main():
+    client = mqtt.Client(client_id="soilmind-binary-bridge", protocol=mqtt.MQTTv311)
+    client.on_connect = on_connect
+    client.on_message = on_message
+    client.connect(MQTT_HOST, MQTT_PORT, keepalive=30)
+    client.loop_start()
+    try:
+        while running:
+            time.sleep(1)
+    finally:
+        client.loop_stop()
+        client.disconnect()
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except Exception as e:
+        print(f"[bridge] fatal: {e}", file=sys.stderr)
+        raise
@@ -0,0 +1,337 @@
+#include <Arduino.h>
+#include <benchmark/benchmark.h>
+#include "HostSim.h"
+#include "../src/APP_Cfg.h"
+#include "../src/App/SensorBus/SensorBus.h"
+#include "../src/App/ZoneManager/ZoneManager.h"
+#include "../src/App/OfflineLog/OfflineLog.h"
+#include "../src/App/ML/ML.h"
+#include "../src/App/MQTT_APP/mqtt_app.h"
+#include "../src/App/MQTT_APP/mqtt_payload.h"
+#include "../src/Hal/MQTT/mqtt_core.h"
+#include "../src/Hal/WIFI/wifi.h"
+
+// Host micro-benchmarks of the firmware hot paths. Besides the time per
+// iteration every case reports allocs/op and bytes/op from the counting
+// allocator of the shim, so a change that brings the heap back into a hot
+// path shows up next to the one that makes it slower.
+//
+//   interfacing_bench [--benchmark_filter=REGEX] [--benchmark_format=json] ...
+
+extern SensorHistory history[ZONE_COUNT];
+
+// Heap use between Start() and Stop(), less whatever ran with the timer paused
+class HeapCounter
+{
+public:
+    explicit HeapCounter(benchmark::State& state) : state(state), allocations(0), bytes(0) {}
+
+    void Start() { begin = HostSim_GetHeap(); }
+    void Stop() { add(); report(); }
+
+    // Around PauseTiming()/ResumeTiming()
+    void Pause() { add(); }
+    void Resume() { begin = HostSim_GetHeap(); }
+
+private:
+    benchmark::State& state;
+    HostSim_Heap_t begin;
+    uint64_t allocations;
+    uint64_t bytes;
+
+    void add()
+    {
+        HostSim_Heap_t now = HostSim_GetHeap();
+        allocations += now.allocations - begin.allocations;
+        bytes += now.allocatedBytes - begin.allocatedBytes;
+    }
+
+    void report()
+    {
+        state.counters["allocs/op"] = benchmark::Counter((double)allocations, benchmark::Counter::kAvgIterations);
+        state.counters["bytes/op"] = benchmark::Counter((double)bytes, benchmark::Counter::kAvgIterations);
+    }
+};
+
+// Fresh GOOD readings on every channel the telemetry and ML paths read
+static void publishSensors(float moisture)
+{
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        SensorBus_Publish(SensorBus_ZoneMoistureChannel(zone), moisture);
+    }
+    SensorBus_Publish(SENSOR_CH_TEMPERATURE, 24.0f);
+    SensorBus_Publish(SENSOR_CH_HUMIDITY, 55.0f);
+}
+
+// Let the device send everything it queued
+static void drainOutbox(void)
+{
+    for (int i = 0; i < 100 && MQTT_OutboxPending() > 0; i++)
+    {
+        mqtt_net_main();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Sensor ring and bus
+// ---------------------------------------------------------------------------
+static void BM_SensorRingPushRead(benchmark::State& state)
+{
+    static SensorRing<SensorReading_t, 32> ring;
+    SensorReading_t in = {21.5f, 0, 0};
+    SensorReading_t out;
+    uint32_t cursor = ring.published();
+    uint32_t lost = 0;
+    HeapCounter heap(state);
+
+    heap.Start();
+    for (auto _ : state)
+    {
+        in.seq++;
+        ring.push(in);
+        ring.readFrom(&cursor, &out, &lost);
+        benchmark::DoNotOptimize(out);
+    }
+    heap.Stop();
+}
+BENCHMARK(BM_SensorRingPushRead);
+
+// One reading fanned out to every consumer cursor
+static void BM_SensorBusPublishRead(benchmark::State& state)
+{
+    SensorReading_t reading;
+    HeapCounter heap(state);
+    float value = 0.0f;
+
+    heap.Start();
+    for (auto _ : state)
+    {
+        SensorBus_Publish(SENSOR_CH_TEMPERATURE, value);
+        for (uint8_t c = 0; c < SENSORBUS_CONSUMER_COUNT; c++)
+        {
+            SensorBus_ReadNext((SensorBusConsumer_t)c, SENSOR_CH_TEMPERATURE, &reading);
+            benchmark::DoNotOptimize(reading);
+        }
+        value += 0.25f;
+    }
+    heap.Stop();
+}
+BENCHMARK(BM_SensorBusPublishRead);
+
+// ---------------------------------------------------------------------------
+// ML: history window, features, inference
+// ---------------------------------------------------------------------------
+static void BM_HistoryFeatures(benchmark::State& state)
+{
+    SensorHistory h;
+    float features[NUM_FEATURES];
+    HeapCounter heap(state);
+    uint32_t i = 0;
+
+    h.init();
+    heap.Start();
+    for (auto _ : state)
+    {
+        h.addReading(20.0f + (i & 7), 200.0f + (i & 15));
+        // Model order, as the ML module extracts them
+        features[0] = h.getTemp(0);
+        features[1] = h.getMoisture(0);
+        features[2] = h.tempMean();
+        features[3] = h.moistureMean();
+        features[4] = h.tempTrend();
+        features[5] = h.moistureTrend();
+        features[6] = h.getMoisture(1);
+        features[7] = h.getMoisture(2);
+        benchmark::DoNotOptimize(features);
+        i++;
+    }
+    heap.Stop();
+}
+BENCHMARK(BM_HistoryFeatures);
+
+// Features, folded scaling/quantization, one Invoke, for one zone
+static void BM_MLRunInference(benchmark::State& state)
+{
+    HeapCounter heap(state);
+    for (uint8_t i = 0; i < HISTORY_SIZE; i++)
+    {
+        history[0].addReading(24.0f, 250.0f - 10.0f * i);
+    }
+
+    heap.Start();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ML_RunInference(0));
+    }
+    heap.Stop();
+}
+BENCHMARK(BM_MLRunInference);
+
+// One Invoke of a batch of 1..BENCH_ML_ROWS rows, on an interpreter planned
+// for exactly that batch from the patched model. per_row is time per row.
+#define BENCH_ML_ROWS 16
+
+static void BM_MLRunInferenceBatch(benchmark::State& state)
+{
+    const uint16_t rows = (uint16_t)state.range(0);
+    alignas(16) static uint8_t modelCopy[sizeof(irrigation_model)];
+    alignas(16) static uint8_t arena[kTensorArenaSize];
+    static float features[BENCH_ML_ROWS][NUM_FEATURES];
+    static float probabilities[BENCH_ML_ROWS];
+    HeapCounter heap(state);
+
+    if (!ML_BenchPlan(rows, modelCopy, arena, sizeof(arena)))
+    {
+        state.SkipWithError("ML_BenchPlan failed");
+        return;
+    }
+    for (uint16_t r = 0; r < rows; r++)
+    {
+        for (uint8_t i = 0; i < NUM_FEATURES; i++)
+        {
+            features[r][i] = featureMeans[i] + featureStds[i] * (float)(r - BENCH_ML_ROWS / 2) / BENCH_ML_ROWS;
+        }
+    }
+
+    heap.Start();
+    for (auto _ : state)
+    {
+        ML_BenchInvoke(features, rows, probabilities);
+        benchmark::DoNotOptimize(probabilities);
+    }
+    heap.Stop();
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.counters["per_row"] = benchmark::Counter((double)state.iterations() * rows,
+                                                   benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_MLRunInferenceBatch)->DenseRange(1, BENCH_ML_ROWS);
+
+// ---------------------------------------------------------------------------
+// MQTT: telemetry out, messages in
+// ---------------------------------------------------------------------------
+static void BM_TelemetryPayload(benchmark::State& state)
+{
+    JsonBuffer<MQTT_TELEMETRY_JSON_SIZE> json;
+    HeapCounter heap(state);
+    uint32_t i = 0;
+
+    heap.Start();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(MQTT_Payload_Telemetry(&json, 40.0f + (i & 31), 23.0f, 55.5f, 0));
+        i++;
+    }
+    heap.Stop();
+}
+BENCHMARK(BM_TelemetryPayload);
+
+// Bus read, payload and outbox copy; the network lane sending it is paused
+// out of the measurement every MQTT_OUTBOX_LOW_DEPTH messages
+static void BM_MQTT_APP_PublishTelemetry(benchmark::State& state)
+{
+    HeapCounter heap(state);
+    uint32_t i = 0;
+
+    if (!MQTT_IsConnected())
+    {
+        state.SkipWithError("MQTT not connected");
+        return;
+    }
+    publishSensors(40.0f);
+    drainOutbox();
+
+    heap.Start();
+    for (auto _ : state)
+    {
+        MQTT_APP_PublishTelemetry();
+        if (++i % MQTT_OUTBOX_LOW_DEPTH == 0)
+        {
+            state.PauseTiming();
+            heap.Pause();
+            drainOutbox();
+            publishSensors(40.0f + (i & 31));
+            heap.Resume();
+            state.ResumeTiming();
+        }
+    }
+    heap.Stop();
+    drainOutbox();
+}
+BENCHMARK(BM_MQTT_APP_PublishTelemetry);
+
+// Incoming PUBLISH as PubSubClient::loop() hands it over: size check,
+// topic dispatch and the handler
+static void benchCallback(benchmark::State& state, const char* topicText, const char* payloadText)
+{
+    char topic[MQTT_HANDLER_TOPIC_MAX];
+    uint8_t payload[MQTT_MAX_PAYLOAD_SIZE];
+    unsigned int length = (unsigned int)strlen(payloadText);
+    HeapCounter heap(state);
+
+    strncpy(topic, topicText, sizeof(topic) - 1);
+    topic[sizeof(topic) - 1] = '\0';
+    memcpy(payload, payloadText, length);
+
+    heap.Start();
+    for (auto _ : state)
+    {
+        if (!HostSim_CallMqttCallback(topic, payload, length))
+        {
+            state.SkipWithError("MQTT callback not set");
+            break;
+        }
+    }
+    heap.Stop();
+    drainOutbox();
+}
+BENCHMARK_CAPTURE(benchCallback, pump_exact, MQTT_TOPIC_PUMP_CONTROL, "AUTO");
+BENCHMARK_CAPTURE(benchCallback, zone_wildcard, "farm/site1/nodeA/zone/1/cmd", "AUTO");
+BENCHMARK_CAPTURE(benchCallback, no_handler, "farm/site1/nodeA/unknown", "AUTO");
+
+// ---------------------------------------------------------------------------
+// The modules the cases touch, initialized as setup() does, and an MQTT
+// session with the in-process broker
+// ---------------------------------------------------------------------------
+static bool benchSetup(void)
+{
+    HostSim_SetSerialOutput(false);
+
+    SensorBus_Init();
+    ZoneManager_Init();
+    OfflineLog_Init();
+    if (!ML_Init())
+    {
+        return false;
+    }
+    publishSensors(40.0f);
+
+    // WiFi up, then the MQTT session, as the NET lane would step them
+    MQTT_APP_Setup();
+    for (int i = 0; i < 500 && !MQTT_IsConnected(); i++)
+    {
+        wifi_loop();
+        mqtt_net_main();
+        delay(10);
+    }
+    drainOutbox();
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    HostSim_SetFsRoot("host_fs_bench");
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    if (!benchSetup())
+    {
+        fprintf(stderr, "bench: firmware setup failed\n");
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <Arduino.h>
+#include <unistd.h>
+#include "HostSim.h"
+#include "../src/APP_Cfg.h"
+
+// Runs the sketch on Linux: setup() and loop() on an Arduino-style loop task,
+// for a fixed time or until killed.
+//
+//   interfacing_host [--seconds N] [--speed X] [--fs DIR] [--offline]
+//                    [--moisture RAW] [--dht TEMP,HUM] [--mqtt-log]
+
+void setup(void);
+void loop(void);
+
+static void loopTask(void* parameter)
+{
+    (void)parameter;
+    setup();
+    for (;;)
+    {
+        loop();
+    }
+}
+
+static void printPublish(const char* topic, const uint8_t* payload, size_t length, uint8_t qos, bool retain)
+{
+    Serial.printf("[BROKER] %s q%u%s %.*s\n", topic, (unsigned)qos, retain ? " r" : "",
+                  (int)length, (const char*)payload);
+}
+
+static void usage(const char* program)
+{
+    fprintf(stderr,
+            "usage: %s [--seconds N] [--speed X] [--fs DIR] [--offline]\n"
+            "          [--moisture RAW] [--dht TEMP,HUM] [--mqtt-log]\n",
+            program);
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 0.0;
+    static const uint8_t moisturePins[] = ZONE_MOISTURE_PINS;
+    uint16_t moistureRaw = 2000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--seconds") == 0 && value != NULL)
+        {
+            seconds = atof(value);
+            i++;
+        }
+        else if (strcmp(arg, "--speed") == 0 && value != NULL)
+        {
+            HostSim_SetSpeed(atof(value));
+            i++;
+        }
+        else if (strcmp(arg, "--fs") == 0 && value != NULL)
+        {
+            HostSim_SetFsRoot(value);
+            i++;
+        }
+        else if (strcmp(arg, "--moisture") == 0 && value != NULL)
+        {
+            moistureRaw = (uint16_t)atoi(value);
+            i++;
+        }
+        else if (strcmp(arg, "--dht") == 0 && value != NULL)
+        {
+            float temperature = NAN;
+            float humidity = NAN;
+            sscanf(value, "%f,%f", &temperature, &humidity);
+            HostSim_SetDht(temperature, humidity);
+            i++;
+        }
+        else if (strcmp(arg, "--offline") == 0)
+        {
+            HostSim_SetLink(false);
+        }
+        else if (strcmp(arg, "--mqtt-log") == 0)
+        {
+            HostSim_SetPublishHook(printPublish);
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint8_t pin : moisturePins)
+    {
+        HostSim_SetAnalog(pin, moistureRaw);
+    }
+
+    xTaskCreate(loopTask, "loopTask", 8192, NULL, 1, NULL);
+
+    if (seconds <= 0.0)
+    {
+        for (;;)
+        {
+            pause();
+        }
+    }
+    // Simulated seconds; the tasks never return, so leave without destructors
+    delay((uint32_t)(seconds * 1000.0));
+    Serial.flush();
+    fflush(stdout);
+    _exit(0);
+}
@@ -0,0 +1,515 @@
+#include <Arduino.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "HostSim.h"
+#include "../src/APP_Cfg.h"
+#include "../src/App/SensorBus/SensorBus.h"
+#include "../src/App/SoilMoisture/SoilMoisture.h"
+#include "../src/App/DHT/DHT11.h"
+#include "../src/App/ZoneManager/ZoneManager.h"
+#include "../src/App/OfflineLog/OfflineLog.h"
+#include "../src/App/ML/ML.h"
+#include "../src/App/MQTT_APP/mqtt_app.h"
+#include "../src/Hal/MQTT/mqtt_core.h"
+#include "../src/Hal/WIFI/wifi.h"
+
+// Replays a dataset from AI/ through the edge pipeline, one CSV row per
+// history step (SCHED_ML_HISTORY_PERIOD_MS) on a stepped clock:
+//
+//   row -> probe ADC / DHT -> SoilMoisture_main, DHT11_main -> SensorBus
+//       -> mqtt_main -> ML_UpdateHistory (SensorHistory) -> ML_RunDecision
+//       -> ZoneManager_main -> MQTT outbox -> in-process broker
+//
+// Every zone's probe reads the row. Each job runs once per step in lane
+// order on this thread, so a run is repeatable. The decisions are taken
+// as the broker receives them and compared with the notebook pipeline:
+// the same model fed the notebook's float features (rolling mean and
+// diff over 4 rows, lags 1 and 2) straight from the CSV, irrigate above
+// 0.5. Where the dataset has a label the accuracy of both is reported.
+//
+//   interfacing_replay [--dataset NAME] [--csv PATH] [--rows N] [--trace FILE]
+
+#define REPLAY_WINDOW           4       // notebook window_size
+#define REPLAY_HUMIDITY         55.0f   // for datasets without humidity
+#define REPLAY_NO_DECISION      -1
+
+typedef enum
+{
+    MOISTURE_PROBE_UNITS,   // the training data's raw probe scale (ML_MOISTURE_MIN..MAX)
+    MOISTURE_PERCENT
+} ReplayMoisture_t;
+
+typedef struct
+{
+    const char* name;
+    const char* file;                   // under REPLAY_DATA_DIR
+    const char* temperatureColumn;
+    const char* moistureColumn;
+    ReplayMoisture_t moistureUnit;
+    const char* humidityColumn;         // NULL: REPLAY_HUMIDITY
+    const char* labelColumn;            // NULL: no ground truth
+    const char* labelIrrigate;          // label value that means water
+    uint8_t labelAhead;                 // rows the label looks ahead
+} ReplayDataset_t;
+
+// The first one is the data the deployed model was trained on; the others
+// share its temperature and soil moisture columns but not its labels
+static const ReplayDataset_t datasets[] = {
+    {"scheduling", "irrigation_model_v2/Irrigation Scheduling.csv", "temperature", "soilmiosture",
+     MOISTURE_PROBE_UNITS, NULL, "status", "1", 2},
+    {"irrigation", "irrigation_model_v1/irrigation_dataset.csv", "temperature", "soil_moisture",
+     MOISTURE_PERCENT, "humidity", "irrigation", "1", 0},
+    {"plant_health", "plant_health_model/plant_health.csv", "temperature", "soil_moisture",
+     MOISTURE_PERCENT, NULL, "stress_type", "water_stress", 0},
+};
+
+typedef struct
+{
+    float temperature;
+    float moisture;             // probe units
+    float humidity;
+    int8_t label;               // 1 water, 0 not, -1 none
+} ReplayRow_t;
+
+// Device decisions per row and zone, filled in by the broker hook
+static std::vector<int8_t> deviceDecisions;
+static size_t currentRow = 0;
+static uint32_t unexpectedDecisions = 0;
+
+// ---------------------------------------------------------------------------
+// Dataset
+// ---------------------------------------------------------------------------
+static std::vector<std::string> splitCsv(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ','))
+    {
+        if (!field.empty() && field.back() == '\r')
+        {
+            field.pop_back();
+        }
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+static int columnOf(const std::vector<std::string>& header, const char* name)
+{
+    for (size_t i = 0; name != NULL && i < header.size(); i++)
+    {
+        if (header[i] == name)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// Rows with a missing or unreadable temperature or moisture are skipped
+static bool loadDataset(const ReplayDataset_t* dataset, const std::string& path, size_t maxRows,
+                        std::vector<ReplayRow_t>* rows, size_t* skipped)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line))
+    {
+        fprintf(stderr, "replay: cannot read %s\n", path.c_str());
+        return false;
+    }
+    std::vector<std::string> header = splitCsv(line);
+    int temperatureColumn = columnOf(header, dataset->temperatureColumn);
+    int moistureColumn = columnOf(header, dataset->moistureColumn);
+    int humidityColumn = columnOf(header, dataset->humidityColumn);
+    int labelColumn = columnOf(header, dataset->labelColumn);
+    if (temperatureColumn < 0 || moistureColumn < 0)
+    {
+        fprintf(stderr, "replay: %s has no %s/%s columns\n", path.c_str(), dataset->temperatureColumn,
+                dataset->moistureColumn);
+        return false;
+    }
+
+    *skipped = 0;
+    while (rows->size() < maxRows && std::getline(file, line))
+    {
+        std::vector<std::string> fields = splitCsv(line);
+        char* end = NULL;
+        ReplayRow_t row;
+        if ((int)fields.size() <= temperatureColumn || (int)fields.size() <= moistureColumn)
+        {
+            (*skipped)++;
+            continue;
+        }
+        row.temperature = strtof(fields[temperatureColumn].c_str(), &end);
+        bool ok = end != fields[temperatureColumn].c_str();
+        row.moisture = strtof(fields[moistureColumn].c_str(), &end);
+        ok = ok && end != fields[moistureColumn].c_str();
+        if (!ok)
+        {
+            (*skipped)++;
+            continue;
+        }
+        if (dataset->moistureUnit == MOISTURE_PERCENT)
+        {
+            row.moisture = ML_MOISTURE_MIN + row.moisture * (ML_MOISTURE_MAX - ML_MOISTURE_MIN) / 100.0f;
+        }
+        row.humidity = REPLAY_HUMIDITY;
+        if (humidityColumn >= 0 && (int)fields.size() > humidityColumn && !fields[humidityColumn].empty())
+        {
+            row.humidity = strtof(fields[humidityColumn].c_str(), NULL);
+        }
+        row.label = -1;
+        if (labelColumn >= 0 && (int)fields.size() > labelColumn)
+        {
+            // "1" and "1.0" alike for numeric labels
+            const std::string& value = fields[labelColumn];
+            char* numberEnd = NULL;
+            double number = strtod(value.c_str(), &numberEnd);
+            bool numeric = numberEnd != value.c_str() && *numberEnd == '\0';
+            row.label = numeric ? (number == atof(dataset->labelIrrigate)) : (value == dataset->labelIrrigate);
+        }
+        rows->push_back(row);
+    }
+    return true;
+}
+
+// Raw ADC count the probe gives at this moisture: the inverse of the
+// SoilMoisture and ML scaling, rounded like a real conversion
+static uint16_t probeRaw(float moisture)
+{
+    float percent = (moisture - ML_MOISTURE_MIN) * 100.0f / (ML_MOISTURE_MAX - ML_MOISTURE_MIN);
+    float raw = DRY_VALUE + percent * (WET_VALUE - DRY_VALUE) / 100.0f;
+    return (uint16_t)lrintf(raw < 0.0f ? 0.0f : (raw > 4095.0f ? 4095.0f : raw));
+}
+
+// ---------------------------------------------------------------------------
+// Device
+// ---------------------------------------------------------------------------
+static void onPublish(const char* topic, const uint8_t* payload, size_t length, uint8_t qos, bool retain)
+{
+    (void)qos;
+    (void)retain;
+    if (strcmp(topic, MQTT_TOPIC_IRRIGATION_DECISION) != 0)
+    {
+        return;
+    }
+    std::string text((const char*)payload, length);
+    size_t zoneAt = text.find("\"zone\":");
+    unsigned long zone = zoneAt != std::string::npos ? strtoul(text.c_str() + zoneAt + 7, NULL, 10) : 0;
+    size_t slot = currentRow * ZONE_COUNT + zone;
+    if (zone >= ZONE_COUNT || slot >= deviceDecisions.size())
+    {
+        unexpectedDecisions++;
+        return;
+    }
+    deviceDecisions[slot] = text.find("\"decision\":\"IRRIGATE\"") != std::string::npos ? 1 : 0;
+}
+
+// Modules as setup() brings them up, then an MQTT session with the broker
+static bool deviceSetup(void)
+{
+    SensorBus_Init();
+    SoilMoisture_Init();
+    DHT11_init();
+    ZoneManager_Init();
+    if (!ML_Init())
+    {
+        return false;
+    }
+    OfflineLog_Init();
+    MQTT_APP_Setup();
+    for (int i = 0; i < 500 && !MQTT_IsConnected(); i++)
+    {
+        wifi_loop();
+        mqtt_net_main();
+        delay(SCHED_MQTT_NET_PERIOD_MS);
+    }
+    return MQTT_IsConnected();
+}
+
+// One history step: the jobs of every lane once, in lane order, then the
+// network lane until the outbox is empty
+static void deviceStep(const ReplayRow_t* row)
+{
+    static const uint8_t moisturePins[] = ZONE_MOISTURE_PINS;
+    uint16_t raw = probeRaw(row->moisture);
+    for (uint8_t pin : moisturePins)
+    {
+        HostSim_SetAnalog(pin, raw);
+    }
+    HostSim_SetDht(row->temperature, row->humidity);
+
+    SoilMoisture_main();
+    DHT11_main();
+    mqtt_main();
+    ML_UpdateHistory();
+    ML_RunDecision();
+    ZoneManager_main();
+    for (int i = 0; i < 100 && MQTT_OutboxPending() > 0; i++)
+    {
+        mqtt_net_main();
+    }
+
+    HostSim_AdvanceClock(SCHED_ML_HISTORY_PERIOD_MS);
+}
+
+// ---------------------------------------------------------------------------
+// Notebook pipeline
+// ---------------------------------------------------------------------------
+// Irrigate (1), not (0), or REPLAY_NO_DECISION for the first rows, which
+// the notebook drops for want of a full window
+static bool notebookDecisions(const std::vector<ReplayRow_t>& rows, std::vector<int8_t>* decisions)
+{
+    static float features[ML_BATCH_MAX][NUM_FEATURES];
+    static float probabilities[ML_BATCH_MAX];
+
+    decisions->assign(rows.size(), REPLAY_NO_DECISION);
+    size_t first = REPLAY_WINDOW;
+    for (size_t start = first; start < rows.size(); start += ML_BATCH_MAX)
+    {
+        uint16_t count = (uint16_t)std::min<size_t>(ML_BATCH_MAX, rows.size() - start);
+        for (uint16_t r = 0; r < count; r++)
+        {
+            size_t i = start + r;
+            float temperatureSum = 0.0f;
+            float moistureSum = 0.0f;
+            for (size_t k = 0; k < REPLAY_WINDOW; k++)
+            {
+                temperatureSum += rows[i - k].temperature;
+                moistureSum += rows[i - k].moisture;
+            }
+            features[r][0] = rows[i].temperature;
+            features[r][1] = rows[i].moisture;
+            features[r][2] = temperatureSum / REPLAY_WINDOW;
+            features[r][3] = moistureSum / REPLAY_WINDOW;
+            features[r][4] = rows[i].temperature - rows[i - REPLAY_WINDOW].temperature;
+            features[r][5] = rows[i].moisture - rows[i - REPLAY_WINDOW].moisture;
+            features[r][6] = rows[i - 1].moisture;
+            features[r][7] = rows[i - 2].moisture;
+        }
+        if (!ML_RunInferenceBatch(features, count, probabilities))
+        {
+            return false;
+        }
+        for (uint16_t r = 0; r < count; r++)
+        {
+            (*decisions)[start + r] = probabilities[r] > 0.5f ? 1 : 0;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Report
+// ---------------------------------------------------------------------------
+static double percent(uint64_t part, uint64_t whole)
+{
+    return whole > 0 ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+static void report(const ReplayDataset_t* dataset, const std::vector<ReplayRow_t>& rows,
+                   const std::vector<int8_t>& notebook, double wallS)
+{
+    uint64_t published = 0;
+    uint64_t irrigate = 0;
+    uint64_t compared = 0;
+    uint64_t agree = 0;
+    uint64_t deviceOnly = 0;
+    uint64_t notebookOnly = 0;
+    uint64_t labelled = 0;
+    uint64_t deviceCorrect = 0;
+    uint64_t notebookCorrect = 0;
+
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        int8_t label = i + dataset->labelAhead < rows.size() ? rows[i + dataset->labelAhead].label : -1;
+        for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+        {
+            int8_t device = deviceDecisions[i * ZONE_COUNT + zone];
+            if (device == REPLAY_NO_DECISION)
+            {
+                continue;
+            }
+            published++;
+            irrigate += device;
+            if (notebook[i] == REPLAY_NO_DECISION)
+            {
+                continue;
+            }
+            compared++;
+            agree += device == notebook[i];
+            deviceOnly += device > notebook[i];
+            notebookOnly += device < notebook[i];
+            if (label >= 0)
+            {
+                labelled++;
+                deviceCorrect += device == label;
+                notebookCorrect += notebook[i] == label;
+            }
+        }
+    }
+
+    uint64_t samples = (uint64_t)rows.size() * ZONE_COUNT;
+    double simulatedS = (double)rows.size() * SCHED_ML_HISTORY_PERIOD_MS / 1000.0;
+    printf("dataset      %s, %zu rows x %d zones, %.1f h simulated\n", dataset->name, rows.size(),
+           ZONE_COUNT, simulatedS / 3600.0);
+    printf("throughput   %.0f samples/s (%.3f s wall, %.0fx real time)\n", samples / wallS, wallS,
+           simulatedS / wallS);
+    printf("decisions    %llu of %llu published, %.1f%% irrigate%s\n", (unsigned long long)published,
+           (unsigned long long)samples, percent(irrigate, published),
+           unexpectedDecisions > 0 ? ", unexpected ones seen" : "");
+    printf("notebook     %.2f%% agreement over %llu (device only irrigates %llu, notebook only %llu)\n",
+           percent(agree, compared), (unsigned long long)compared, (unsigned long long)deviceOnly,
+           (unsigned long long)notebookOnly);
+    if (labelled > 0)
+    {
+        printf("label        %s == %s, %u ahead: device %.2f%%, notebook %.2f%% accuracy over %llu\n",
+               dataset->labelColumn, dataset->labelIrrigate, dataset->labelAhead,
+               percent(deviceCorrect, labelled), percent(notebookCorrect, labelled),
+               (unsigned long long)labelled);
+    }
+}
+
+// row, temperature, moisture, probe raw, notebook, device decision per zone
+static bool writeTrace(const char* path, const std::vector<ReplayRow_t>& rows, const std::vector<int8_t>& notebook)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+    fprintf(file, "row,temperature,moisture,raw,label,notebook");
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        fprintf(file, ",zone%u", zone);
+    }
+    fprintf(file, "\n");
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        fprintf(file, "%zu,%.2f,%.1f,%u,%d,%d", i, rows[i].temperature, rows[i].moisture,
+                probeRaw(rows[i].moisture), rows[i].label, notebook[i]);
+        for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+        {
+            fprintf(file, ",%d", deviceDecisions[i * ZONE_COUNT + zone]);
+        }
+        fprintf(file, "\n");
+    }
+    fclose(file);
+    return true;
+}
+
+static void usage(const char* program)
+{
+    fprintf(stderr, "usage: %s [--dataset NAME] [--csv PATH] [--rows N] [--trace FILE]\n  datasets:", program);
+    for (const ReplayDataset_t& dataset : datasets)
+    {
+        fprintf(stderr, " %s", dataset.name);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char** argv)
+{
+    const ReplayDataset_t* dataset = &datasets[0];
+    std::string path;
+    size_t maxRows = SIZE_MAX;
+    const char* tracePath = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--dataset") == 0 && value != NULL)
+        {
+            dataset = NULL;
+            for (const ReplayDataset_t& candidate : datasets)
+            {
+                if (strcmp(candidate.name, value) == 0)
+                {
+                    dataset = &candidate;
+                }
+            }
+            if (dataset == NULL)
+            {
+                usage(argv[0]);
+                return 2;
+            }
+            i++;
+        }
+        else if (strcmp(arg, "--csv") == 0 && value != NULL)
+        {
+            path = value;
+            i++;
+        }
+        else if (strcmp(arg, "--rows") == 0 && value != NULL)
+        {
+            maxRows = strtoul(value, NULL, 10);
+            i++;
+        }
+        else if (strcmp(arg, "--trace") == 0 && value != NULL)
+        {
+            tracePath = value;
+            i++;
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (path.empty())
+    {
+        path = std::string(REPLAY_DATA_DIR) + "/" + dataset->file;
+    }
+
+    std::vector<ReplayRow_t> rows;
+    size_t skipped = 0;
+    if (!loadDataset(dataset, path, maxRows, &rows, &skipped))
+    {
+        return 1;
+    }
+    if (skipped > 0)
+    {
+        printf("skipped      %zu unreadable rows\n", skipped);
+    }
+
+    // A board fresh from power-on: empty flash, readings exactly as set
+    std::filesystem::remove_all("host_fs_replay");
+    HostSim_SetFsRoot("host_fs_replay");
+    HostSim_SetSteppedClock();
+    HostSim_SetAdcContinuous(false);
+    HostSim_SetSerialOutput(false);
+    HostSim_SetPublishHook(onPublish);
+    if (!deviceSetup())
+    {
+        fprintf(stderr, "replay: firmware setup failed\n");
+        return 1;
+    }
+
+    deviceDecisions.assign(rows.size() * ZONE_COUNT, REPLAY_NO_DECISION);
+    auto start = std::chrono::steady_clock::now();
+    for (currentRow = 0; currentRow < rows.size(); currentRow++)
+    {
+        deviceStep(&rows[currentRow]);
+    }
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    std::vector<int8_t> notebook;
+    if (!notebookDecisions(rows, &notebook))
+    {
+        fprintf(stderr, "replay: notebook inference failed\n");
+        return 1;
+    }
+    report(dataset, rows, notebook, wall.count());
+    if (tracePath != NULL && !writeTrace(tracePath, rows, notebook))
+    {
+        fprintf(stderr, "replay: cannot write %s\n", tracePath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef HOST_ARDUTFLITE_H
+#define HOST_ARDUTFLITE_H
+
+// ArduTFLite pulls in TFLM; on the host that is the reference interpreter
+
+#include <Arduino.h>
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#endif // HOST_ARDUTFLITE_H
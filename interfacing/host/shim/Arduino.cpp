@@ -0,0 +1,422 @@
+#include <Arduino.h>
+#include <stdarg.h>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "HostSim.h"
+#include "HostInternal.h"
+
+#define HOST_PIN_COUNT      48
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+// One line at a time from any task
+static std::recursive_mutex serialMutex;
+static std::atomic<bool> serialOutput(true);
+
+// ---------------------------------------------------------------------------
+// Clock
+// ---------------------------------------------------------------------------
+static double clockSpeed = 1.0;
+static std::atomic<bool> clockStepped(false);
+static std::atomic<uint64_t> steppedUs(0);
+static HostSim_ClockHook_t clockHook = NULL;
+
+// First use, so static constructors elsewhere may already read the clock
+static std::chrono::steady_clock::time_point clockStart(void)
+{
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+void HostSim_SetSpeed(double speed)
+{
+    clockSpeed = speed > 0.0 ? speed : 1.0;
+}
+
+void HostSim_SetSteppedClock(void)
+{
+    steppedUs = HostClock_NowUs();
+    clockStepped = true;
+}
+
+void HostSim_AdvanceClock(uint32_t ms)
+{
+    steppedUs += (uint64_t)ms * 1000;
+    if (clockHook != NULL)
+    {
+        clockHook(millis());
+    }
+}
+
+void HostSim_SetClockHook(HostSim_ClockHook_t hook)
+{
+    clockHook = hook;
+}
+
+bool HostClock_Stepped(void)
+{
+    return clockStepped;
+}
+
+uint64_t HostClock_NowUs(void)
+{
+    if (clockStepped)
+    {
+        return steppedUs;
+    }
+    std::chrono::duration<double, std::micro> real = std::chrono::steady_clock::now() - clockStart();
+    return (uint64_t)(real.count() * clockSpeed);
+}
+
+std::chrono::steady_clock::time_point HostClock_After(uint64_t simUs)
+{
+    return std::chrono::steady_clock::now() +
+           std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+               std::chrono::duration<double, std::micro>((double)simUs / clockSpeed));
+}
+
+void HostClock_SleepUs(uint64_t simUs)
+{
+    if (clockStepped)
+    {
+        steppedUs += simUs;
+        if (clockHook != NULL)
+        {
+            clockHook(millis());
+        }
+        return;
+    }
+    std::this_thread::sleep_until(HostClock_After(simUs));
+}
+
+EspClass ESP;
+
+uint32_t EspClass::getCycleCount(void)
+{
+    std::chrono::nanoseconds real = std::chrono::steady_clock::now() - clockStart();
+    return (uint32_t)((uint64_t)real.count() * getCpuFreqMHz() / 1000);
+}
+
+unsigned long millis(void)
+{
+    return (unsigned long)(uint32_t)(HostClock_NowUs() / 1000);
+}
+
+unsigned long micros(void)
+{
+    return (unsigned long)(uint32_t)HostClock_NowUs();
+}
+
+void delay(uint32_t ms)
+{
+    HostClock_SleepUs((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    HostClock_SleepUs(us);
+}
+
+void yield(void)
+{
+    std::this_thread::yield();
+}
+
+// ---------------------------------------------------------------------------
+// Serial
+// ---------------------------------------------------------------------------
+void HardwareSerial::flush()
+{
+    if (port == 0)
+    {
+        fflush(stdout);
+    }
+}
+
+void HostSim_SetSerialOutput(bool enabled)
+{
+    serialOutput = enabled;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+    if (port == 0 && serialOutput)
+    {
+        std::lock_guard<std::recursive_mutex> lock(serialMutex);
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+int HardwareSerial::printf(const char* format, ...)
+{
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length > 0)
+    {
+        write((const uint8_t*)buffer, (size_t)length < sizeof(buffer) ? (size_t)length : sizeof(buffer) - 1);
+    }
+    return length;
+}
+
+// No String copy, so printing a literal costs no heap, as on the device
+size_t HardwareSerial::printLine(const char* s)
+{
+    std::lock_guard<std::recursive_mutex> lock(serialMutex);
+    return print(s) + print("\n");
+}
+
+// ---------------------------------------------------------------------------
+// GPIO, ADC, PWM
+// ---------------------------------------------------------------------------
+static std::atomic<int> digitalOut[HOST_PIN_COUNT];
+static std::atomic<int> analogOut[HOST_PIN_COUNT];
+static std::atomic<uint16_t> analogIn[HOST_PIN_COUNT];
+static uint8_t readResolution = 12;
+
+void HostSim_SetAnalog(uint8_t pin, uint16_t raw)
+{
+    if (pin < HOST_PIN_COUNT)
+    {
+        analogIn[pin] = raw;
+    }
+}
+
+int HostSim_GetDigital(uint8_t pin)
+{
+    return pin < HOST_PIN_COUNT ? digitalOut[pin].load() : LOW;
+}
+
+int HostSim_GetAnalogWrite(uint8_t pin)
+{
+    return pin < HOST_PIN_COUNT ? analogOut[pin].load() : 0;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin < HOST_PIN_COUNT)
+    {
+        digitalOut[pin] = value ? HIGH : LOW;
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return HostSim_GetDigital(pin);
+}
+
+// Simulated values are 12-bit; other resolutions are scaled like the real ADC
+static uint16_t scaledRead(uint8_t pin, uint8_t bits)
+{
+    uint16_t raw = pin < HOST_PIN_COUNT ? analogIn[pin].load() : 0;
+    return bits >= 12 ? (uint16_t)(raw << (bits - 12)) : (uint16_t)(raw >> (12 - bits));
+}
+
+uint16_t analogRead(uint8_t pin)
+{
+    return scaledRead(pin, readResolution);
+}
+
+void analogReadResolution(uint8_t bits)
+{
+    readResolution = bits;
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+    if (pin < HOST_PIN_COUNT)
+    {
+        analogOut[pin] = value;
+    }
+}
+
+void analogWriteResolution(uint8_t pin, uint8_t bits)
+{
+    (void)pin;
+    (void)bits;
+}
+
+void analogWriteFrequency(uint8_t pin, uint32_t freq)
+{
+    (void)pin;
+    (void)freq;
+}
+
+// Continuous ADC: a thread stands in for the DMA engine and calls the
+// "ISR" once per frame
+static std::atomic<bool> adcContAvailable(true);
+
+static struct
+{
+    uint8_t pins[HOST_PIN_COUNT];
+    size_t pinCount;
+    uint32_t frameUs;
+    uint8_t width;
+    void (*callback)(void);
+    std::atomic<bool> running;
+    std::thread worker;
+    adc_continuous_data_t frame[HOST_PIN_COUNT];
+} adcCont;
+
+void HostSim_SetAdcContinuous(bool available)
+{
+    adcContAvailable = available;
+}
+
+bool analogContinuous(const uint8_t pins[], size_t pinCount, uint32_t conversionsPerPin,
+                      uint32_t samplingFreqHz, void (*userAdcCallback)(void))
+{
+    if (!adcContAvailable || pinCount == 0 || pinCount > HOST_PIN_COUNT || samplingFreqHz == 0)
+    {
+        return false;
+    }
+    memcpy(adcCont.pins, pins, pinCount);
+    adcCont.pinCount = pinCount;
+    adcCont.frameUs = (uint32_t)((uint64_t)conversionsPerPin * pinCount * 1000000ULL / samplingFreqHz);
+    adcCont.callback = userAdcCallback;
+    if (adcCont.width == 0)
+    {
+        adcCont.width = 12;
+    }
+    return true;
+}
+
+bool analogContinuousRead(adc_continuous_data_t** buffer, uint32_t timeoutMs)
+{
+    (void)timeoutMs;
+    for (size_t i = 0; i < adcCont.pinCount; i++)
+    {
+        adcCont.frame[i].pin = adcCont.pins[i];
+        adcCont.frame[i].channel = (uint8_t)i;
+        adcCont.frame[i].avg_read_raw = scaledRead(adcCont.pins[i], adcCont.width);
+        adcCont.frame[i].avg_read_mvolts = (int)((uint32_t)scaledRead(adcCont.pins[i], 12) * 3300 / 4095);
+    }
+    *buffer = adcCont.frame;
+    return adcCont.pinCount > 0;
+}
+
+bool analogContinuousStart(void)
+{
+    if (adcCont.pinCount == 0 || adcCont.running)
+    {
+        return false;
+    }
+    adcCont.running = true;
+    adcCont.worker = std::thread([]() {
+        while (adcCont.running)
+        {
+            HostClock_SleepUs(adcCont.frameUs);
+            if (adcCont.callback != NULL)
+            {
+                adcCont.callback();
+            }
+        }
+    });
+    return true;
+}
+
+bool analogContinuousStop(void)
+{
+    if (!adcCont.running)
+    {
+        return false;
+    }
+    adcCont.running = false;
+    adcCont.worker.join();
+    return true;
+}
+
+bool analogContinuousDeinit(void)
+{
+    analogContinuousStop();
+    adcCont.pinCount = 0;
+    return true;
+}
+
+void analogContinuousSetWidth(uint8_t bits)
+{
+    adcCont.width = bits;
+}
+
+// ---------------------------------------------------------------------------
+// Random, time
+// ---------------------------------------------------------------------------
+static std::mt19937 randomEngine(0x5EED);
+static std::mutex randomMutex;
+
+long random(long howBig)
+{
+    return howBig > 0 ? random(0, howBig) : 0;
+}
+
+long random(long howSmall, long howBig)
+{
+    if (howSmall >= howBig)
+    {
+        return howSmall;
+    }
+    std::lock_guard<std::mutex> lock(randomMutex);
+    return howSmall + (long)(randomEngine() % (unsigned long)(howBig - howSmall));
+}
+
+void randomSeed(unsigned long seed)
+{
+    std::lock_guard<std::mutex> lock(randomMutex);
+    randomEngine.seed((uint32_t)seed);
+}
+
+uint32_t esp_random(void)
+{
+    std::lock_guard<std::mutex> lock(randomMutex);
+    return (uint32_t)randomEngine();
+}
+
+// time() is UTC: the host's at start, or what HostSim_SetTime() set, moved on
+// by the simulated clock, so a stepped clock steps it too
+static std::atomic<int64_t> utcBaseUs(INT64_MIN);
+
+void HostSim_SetTime(uint32_t utcS)
+{
+    utcBaseUs = (int64_t)utcS * 1000000 - (int64_t)HostClock_NowUs();
+}
+
+extern "C" time_t time(time_t* out) noexcept
+{
+    if (utcBaseUs.load() == INT64_MIN)
+    {
+        int64_t wallUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::system_clock::now().time_since_epoch()).count();
+        int64_t unset = INT64_MIN;
+        utcBaseUs.compare_exchange_strong(unset, wallUs - (int64_t)HostClock_NowUs());
+    }
+    time_t now = (time_t)((utcBaseUs.load() + (int64_t)HostClock_NowUs()) / 1000000);
+    if (out != NULL)
+    {
+        *out = now;
+    }
+    return now;
+}
+
+// Time is already set; see time() above
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2, const char* server3)
+{
+    (void)gmtOffsetSec;
+    (void)daylightOffsetSec;
+    (void)server1;
+    (void)server2;
+    (void)server3;
+}
@@ -0,0 +1,261 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Host stand-in for the arduino-esp32 core: enough of Arduino.h for App and
+// Hal to build and run on Linux. Pins, the ADC and the clock are simulated,
+// see HostSim.h for the test-side controls.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+#include <algorithm>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+typedef uint8_t byte;
+
+#define PROGMEM
+#define RTC_DATA_ATTR
+#define ARDUINO_ISR_ATTR
+
+#define HIGH            1
+#define LOW             0
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define INPUT_PULLUP    0x05
+
+#define DEC             10
+#define HEX             16
+#define SERIAL_8N1      0x800001c
+
+// ---------------------------------------------------------------------------
+// String
+// ---------------------------------------------------------------------------
+class String
+{
+public:
+    String() {}
+    String(const char* s) : str(s != NULL ? s : "") {}
+    String(const std::string& s) : str(s) {}
+    explicit String(char c) : str(1, c) {}
+    String(int value, unsigned char base = DEC) { fromLong(value, base); }
+    String(unsigned int value, unsigned char base = DEC) { fromUnsigned(value, base); }
+    String(long value, unsigned char base = DEC) { fromLong(value, base); }
+    String(unsigned long value, unsigned char base = DEC) { fromUnsigned(value, base); }
+    String(float value, unsigned char decimals = 2) { fromDouble(value, decimals); }
+    String(double value, unsigned char decimals = 2) { fromDouble(value, decimals); }
+
+    const char* c_str() const { return str.c_str(); }
+    unsigned int length() const { return (unsigned int)str.size(); }
+    bool isEmpty() const { return str.empty(); }
+
+    String& operator+=(const String& other) { str += other.str; return *this; }
+    String& operator+=(const char* other) { str += other; return *this; }
+    String& operator+=(char c) { str += c; return *this; }
+
+    bool operator==(const String& other) const { return str == other.str; }
+    bool operator==(const char* other) const { return str == other; }
+    bool operator!=(const String& other) const { return str != other.str; }
+    bool operator!=(const char* other) const { return str != other; }
+    char operator[](unsigned int index) const { return index < str.size() ? str[index] : '\0'; }
+
+    int indexOf(const char* what, unsigned int from = 0) const
+    {
+        size_t pos = str.find(what, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    int indexOf(char c, unsigned int from = 0) const
+    {
+        size_t pos = str.find(c, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    String substring(unsigned int from) const { return from < str.size() ? String(str.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        return from < to && from < str.size() ? String(str.substr(from, to - from)) : String();
+    }
+    bool startsWith(const char* prefix) const { return str.compare(0, strlen(prefix), prefix) == 0; }
+    long toInt() const { return strtol(str.c_str(), NULL, 10); }
+    float toFloat() const { return strtof(str.c_str(), NULL); }
+    void trim()
+    {
+        size_t first = str.find_first_not_of(" \t\r\n");
+        size_t last = str.find_last_not_of(" \t\r\n");
+        str = first == std::string::npos ? std::string() : str.substr(first, last - first + 1);
+    }
+
+private:
+    std::string str;
+
+    void fromLong(long value, unsigned char base)
+    {
+        if (base == DEC)
+        {
+            str = std::to_string(value);
+        }
+        else
+        {
+            fromUnsigned((unsigned long)value, base);
+        }
+    }
+    void fromUnsigned(unsigned long value, unsigned char base)
+    {
+        char buffer[72];
+        char* p = &buffer[sizeof(buffer) - 1];
+        *p = '\0';
+        do
+        {
+            unsigned digit = value % base;
+            *--p = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+            value /= base;
+        } while (value != 0);
+        str = p;
+    }
+    void fromDouble(double value, unsigned char decimals)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+        str = buffer;
+    }
+};
+
+inline String operator+(const String& a, const String& b) { String s(a); s += b; return s; }
+inline String operator+(const String& a, const char* b) { String s(a); s += b; return s; }
+inline String operator+(const char* a, const String& b) { String s(a); s += b; return s; }
+
+// ---------------------------------------------------------------------------
+// Serial: port 0 prints to stdout, other ports are open but silent
+// ---------------------------------------------------------------------------
+class HardwareSerial
+{
+public:
+    HardwareSerial(int port) : port(port) {}
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1)
+    {
+        (void)baud; (void)config; (void)rxPin; (void)txPin;
+    }
+    void end() {}
+    void flush();
+    int available() { return 0; }
+    int read() { return -1; }
+    String readStringUntil(char terminator) { (void)terminator; return String(); }
+
+    size_t write(const uint8_t* buffer, size_t size);
+    size_t write(uint8_t c) { return write(&c, 1); }
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned int value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(double value, int decimals = 2) { return print(String(value, (unsigned char)decimals)); }
+
+    size_t println() { return print("\n"); }
+    template <typename T> size_t println(const T& value) { return printLine(String(value)); }
+    size_t println(const char* s) { return printLine(s); }
+    size_t println(int value, int base) { return printLine(String(value, (unsigned char)base)); }
+    size_t println(double value, int decimals) { return printLine(String(value, (unsigned char)decimals)); }
+
+    operator bool() const { return true; }
+
+private:
+    int port;
+
+    size_t printLine(const String& s) { return printLine(s.c_str()); }
+    size_t printLine(const char* s);
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+// ---------------------------------------------------------------------------
+// Time
+// ---------------------------------------------------------------------------
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield(void);
+
+// ---------------------------------------------------------------------------
+// GPIO, ADC, PWM
+// ---------------------------------------------------------------------------
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+uint16_t analogRead(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+void analogWrite(uint8_t pin, int value);
+void analogWriteResolution(uint8_t pin, uint8_t bits);
+void analogWriteFrequency(uint8_t pin, uint32_t freq);
+
+// Continuous (DMA) ADC of arduino-esp32 3.x; frames are produced from the
+// simulated analogRead() values on a host thread
+typedef struct
+{
+    uint8_t pin;
+    uint8_t channel;
+    int avg_read_raw;
+    int avg_read_mvolts;
+} adc_continuous_data_t;
+
+bool analogContinuous(const uint8_t pins[], size_t pinCount, uint32_t conversionsPerPin,
+                      uint32_t samplingFreqHz, void (*userAdcCallback)(void));
+bool analogContinuousRead(adc_continuous_data_t** buffer, uint32_t timeoutMs);
+bool analogContinuousStart(void);
+bool analogContinuousStop(void);
+bool analogContinuousDeinit(void);
+void analogContinuousSetWidth(uint8_t bits);
+
+// ---------------------------------------------------------------------------
+// Math helpers
+// ---------------------------------------------------------------------------
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+template <typename T, typename L, typename H>
+inline T constrain(T x, L low, H high)
+{
+    return x < (T)low ? (T)low : (x > (T)high ? (T)high : x);
+}
+
+using std::min;
+using std::max;
+
+// ---------------------------------------------------------------------------
+// ESP-IDF bits Arduino.h pulls in
+// ---------------------------------------------------------------------------
+uint32_t esp_random(void);
+
+// Esp.h: the cycle counter ticks at the nominal CPU clock on the host's real
+// (unscaled) time, so cycle-based timings read like on the device
+class EspClass
+{
+public:
+    uint32_t getCycleCount(void);
+    uint32_t getCpuFreqMHz(void) { return 240; }
+};
+
+extern EspClass ESP;
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2 = NULL, const char* server3 = NULL);
+
+#endif // HOST_ARDUINO_H
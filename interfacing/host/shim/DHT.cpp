@@ -0,0 +1,25 @@
+#include <DHT.h>
+#include <atomic>
+#include "HostSim.h"
+
+static std::atomic<float> dhtTemperature(24.0f);
+static std::atomic<float> dhtHumidity(55.0f);
+
+void HostSim_SetDht(float temperature, float humidity)
+{
+    dhtTemperature = temperature;
+    dhtHumidity = humidity;
+}
+
+float DHT::readTemperature(bool fahrenheit, bool force)
+{
+    (void)force;
+    float celsius = dhtTemperature;
+    return fahrenheit ? celsius * 1.8f + 32.0f : celsius;
+}
+
+float DHT::readHumidity(bool force)
+{
+    (void)force;
+    return dhtHumidity;
+}
@@ -0,0 +1,26 @@
+#ifndef HOST_DHT_H
+#define HOST_DHT_H
+
+// Host DHT sensor library: readings come from HostSim_SetDht()
+
+#include <Arduino.h>
+
+#define DHT11   11
+#define DHT12   12
+#define DHT21   21
+#define DHT22   22
+
+class DHT
+{
+public:
+    DHT(uint8_t pin, uint8_t type, uint8_t count = 6) : pin(pin), type(type) { (void)count; }
+    void begin(uint8_t usecMinPulse = 55) { (void)usecMinPulse; }
+    float readTemperature(bool fahrenheit = false, bool force = false);
+    float readHumidity(bool force = false);
+
+private:
+    uint8_t pin;
+    uint8_t type;
+};
+
+#endif // HOST_DHT_H
@@ -0,0 +1,77 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+// Host FS: fs::FS and fs::File over a directory of the host file system
+
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ       "r"
+#define FILE_WRITE      "w"
+#define FILE_APPEND     "a"
+
+namespace fs
+{
+
+struct FileImpl;
+
+enum SeekMode
+{
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class File
+{
+public:
+    File() {}
+    explicit File(std::shared_ptr<FileImpl> impl) : impl(impl) {}
+
+    size_t write(uint8_t b) { return write(&b, 1); }
+    size_t write(const uint8_t* buf, size_t size);
+    size_t read(uint8_t* buf, size_t size);
+    int read();
+    int available();
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void flush();
+    void close();
+    const char* name() const;
+    const char* path() const;
+    bool isDirectory() const;
+    File openNextFile(const char* mode = FILE_READ);
+    operator bool() const;
+
+private:
+    std::shared_ptr<FileImpl> impl;
+};
+
+class FS
+{
+public:
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    File open(const String& path, const char* mode = FILE_READ, bool create = false)
+    {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+    bool mkdir(const char* path);
+    bool rmdir(const char* path);
+
+protected:
+    // Host directory for "/", set by the concrete file system
+    virtual const char* root() = 0;
+    std::string hostPath(const char* path);
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif // HOST_FS_H
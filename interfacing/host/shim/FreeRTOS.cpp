@@ -0,0 +1,303 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <pthread.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include "HostInternal.h"
+
+// A task is a detached thread with a notification value, as in FreeRTOS
+struct HostTask
+{
+    std::string name;
+    uint32_t stackDepth;
+    TaskFunction_t code;
+    void* parameter;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t notifyValue = 0;
+    bool notifyPending = false;
+};
+
+struct HostSemaphore
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    UBaseType_t count;
+    UBaseType_t maxCount;
+};
+
+// Threads the shim did not start (main, the Arduino loop) get a task on first use
+static thread_local HostTask* currentTask = NULL;
+
+static HostTask* taskOf(TaskHandle_t task)
+{
+    if (task != NULL)
+    {
+        return task;
+    }
+    if (currentTask == NULL)
+    {
+        currentTask = new HostTask();
+        currentTask->name = "main";
+        currentTask->stackDepth = 0;
+        currentTask->code = NULL;
+        currentTask->parameter = NULL;
+    }
+    return currentTask;
+}
+
+// Wait on cv until ready() or the simulated timeout
+template <typename Ready>
+static bool waitTicks(std::unique_lock<std::mutex>& lock, std::condition_variable& cv,
+                      TickType_t ticks, Ready ready)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        cv.wait(lock, ready);
+        return true;
+    }
+    if (HostClock_Stepped())
+    {
+        // Nothing else moves a stepped clock: a wait that is not ready times out now
+        if (ready())
+        {
+            return true;
+        }
+        HostClock_SleepUs((uint64_t)ticks * 1000000 / configTICK_RATE_HZ);
+        return ready();
+    }
+    return cv.wait_until(lock, HostClock_After((uint64_t)ticks * 1000000 / configTICK_RATE_HZ), ready);
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return 0;
+}
+
+static void* taskEntry(void* arg)
+{
+    HostTask* task = (HostTask*)arg;
+    currentTask = task;
+    pthread_setname_np(pthread_self(), task->name.substr(0, 15).c_str());
+    task->code(task->parameter);
+    // A FreeRTOS task must not return; treat it like vTaskDelete(NULL)
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* created,
+                                   BaseType_t core)
+{
+    (void)priority;
+    (void)core;
+
+    HostTask* task = new HostTask();
+    task->name = name != NULL ? name : "";
+    task->stackDepth = stackDepth;
+    task->code = code;
+    task->parameter = parameter;
+
+    // Plain pthreads: vTaskDelete(NULL) ends a task with pthread_exit()
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, taskEntry, task) != 0)
+    {
+        delete task;
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+    if (created != NULL)
+    {
+        *created = task;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* created)
+{
+    return xTaskCreatePinnedToCore(code, name, stackDepth, parameter, priority, created, 0);
+}
+
+// Another task cannot be stopped from outside; deleting yourself ends the thread.
+// The handle stays valid so late notifications are harmless.
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL || task == currentTask)
+    {
+        pthread_exit(NULL);
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    HostClock_SleepUs((uint64_t)ticks * 1000000 / configTICK_RATE_HZ);
+}
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment)
+{
+    *previousWake += increment;
+    int32_t remaining = (int32_t)(*previousWake - xTaskGetTickCount());
+    if (remaining > 0)
+    {
+        vTaskDelay((TickType_t)remaining);
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(HostClock_NowUs() * configTICK_RATE_HZ / 1000000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return taskOf(NULL);
+}
+
+const char* pcTaskGetName(TaskHandle_t task)
+{
+    return taskOf(task)->name.c_str();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    return taskOf(task)->stackDepth;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    HostTask* t = taskOf(task);
+    {
+        std::lock_guard<std::mutex> lock(t->mutex);
+        switch (action)
+        {
+            case eSetBits:
+                t->notifyValue |= value;
+                break;
+            case eIncrement:
+                t->notifyValue++;
+                break;
+            case eSetValueWithOverwrite:
+                t->notifyValue = value;
+                break;
+            case eSetValueWithoutOverwrite:
+                if (t->notifyPending)
+                {
+                    return pdFAIL;
+                }
+                t->notifyValue = value;
+                break;
+            case eNoAction:
+            default:
+                break;
+        }
+        t->notifyPending = true;
+    }
+    t->cv.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value,
+                           TickType_t ticksToWait)
+{
+    HostTask* t = taskOf(NULL);
+    std::unique_lock<std::mutex> lock(t->mutex);
+    if (!t->notifyPending)
+    {
+        t->notifyValue &= ~clearOnEntry;
+    }
+    bool notified = waitTicks(lock, t->cv, ticksToWait, [t]() { return t->notifyPending; });
+    if (value != NULL)
+    {
+        *value = t->notifyValue;
+    }
+    if (!notified)
+    {
+        return pdFALSE;
+    }
+    t->notifyValue &= ~clearOnExit;
+    t->notifyPending = false;
+    return pdTRUE;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    return xTaskNotify(task, 0, eIncrement);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken)
+{
+    xTaskNotify(task, 0, eIncrement);
+    if (higherPriorityTaskWoken != NULL)
+    {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait)
+{
+    HostTask* t = taskOf(NULL);
+    std::unique_lock<std::mutex> lock(t->mutex);
+    waitTicks(lock, t->cv, ticksToWait, [t]() { return t->notifyValue != 0; });
+    uint32_t value = t->notifyValue;
+    if (value != 0)
+    {
+        t->notifyValue = clearOnExit ? 0 : value - 1;
+    }
+    t->notifyPending = false;
+    return value;
+}
+
+// ---------------------------------------------------------------------------
+// Semaphores: counting underneath; a mutex starts full, a binary one empty.
+// No priority inheritance.
+// ---------------------------------------------------------------------------
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount)
+{
+    HostSemaphore* semaphore = new HostSemaphore();
+    semaphore->count = initialCount;
+    semaphore->maxCount = maxCount;
+    return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return xSemaphoreCreateCounting(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xSemaphoreCreateCounting(1, 0);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    if (!waitTicks(lock, semaphore->cv, ticksToWait, [semaphore]() { return semaphore->count > 0; }))
+    {
+        return pdFALSE;
+    }
+    semaphore->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    {
+        std::lock_guard<std::mutex> lock(semaphore->mutex);
+        if (semaphore->count >= semaphore->maxCount)
+        {
+            return pdFALSE;
+        }
+        semaphore->count++;
+    }
+    semaphore->cv.notify_one();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    delete semaphore;
+}
@@ -0,0 +1,20 @@
+#ifndef HOST_INTERNAL_H
+#define HOST_INTERNAL_H
+
+// Shared between the shim translation units only
+
+#include <stdint.h>
+#include <chrono>
+
+// HostSim_SetSteppedClock() was called: sleeps move the clock instead of waiting
+bool HostClock_Stepped(void);
+
+// Simulated time since start, scaled by HostSim_SetSpeed()
+uint64_t HostClock_NowUs(void);
+
+// Host clock point at which simUs of simulated time will have passed
+std::chrono::steady_clock::time_point HostClock_After(uint64_t simUs);
+
+void HostClock_SleepUs(uint64_t simUs);
+
+#endif // HOST_INTERNAL_H
@@ -0,0 +1,102 @@
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Test-side controls of the host shim. Firmware code never includes this;
+// host mains, benchmarks and replays use it to drive the simulated board.
+
+// ---------------------------------------------------------------------------
+// Clock: millis()/ticks run speed times faster than the host clock, and every
+// delay or timed wait is shortened to match. Set before setup().
+// ---------------------------------------------------------------------------
+void HostSim_SetSpeed(double speed);
+
+// Stepped clock for single-threaded drivers such as replays: time stands
+// still until HostSim_AdvanceClock() moves it, and a delay or a timed wait
+// that is not satisfied at once moves it by its own length instead of
+// waiting. Runs are then repeatable to the microsecond. Set before setup().
+void HostSim_SetSteppedClock(void);
+void HostSim_AdvanceClock(uint32_t ms);
+
+// Called each time the stepped clock moves, with the new millis(), on the
+// thread that moved it; lets a test change an input at a given time
+typedef void (*HostSim_ClockHook_t)(uint32_t nowMs);
+void HostSim_SetClockHook(HostSim_ClockHook_t hook);
+
+// UTC seconds time() returns now; it moves on with the clock. Defaults to the
+// host's time at start. Below 1600000000 the firmware takes it as not synced.
+void HostSim_SetTime(uint32_t utcS);
+
+// ---------------------------------------------------------------------------
+// Pins: raw ADC value returned for a pin (default 0), and the last output
+// ---------------------------------------------------------------------------
+void HostSim_SetAnalog(uint8_t pin, uint16_t raw);
+int HostSim_GetDigital(uint8_t pin);
+int HostSim_GetAnalogWrite(uint8_t pin);
+
+// Continuous (DMA) ADC available (default on). Off, analogContinuous() fails
+// and the firmware falls back to a blocking analogRead() per ADC_ReadValue(),
+// so a reading is exactly the value last set, with no sampling thread.
+void HostSim_SetAdcContinuous(bool available);
+
+// Serial port 0 on stdout (default on); off keeps the prints' cost but not the I/O
+void HostSim_SetSerialOutput(bool enabled);
+
+// DHT reading; NaN makes the next reads fail like a disconnected sensor
+void HostSim_SetDht(float temperature, float humidity);
+
+// ---------------------------------------------------------------------------
+// Sleep and reset
+// ---------------------------------------------------------------------------
+// Called as esp_light_sleep_start() or esp_deep_sleep_start() begins, with
+// the timer wakeup that is set, so a test can look at the board as it goes
+// to sleep
+typedef void (*HostSim_SleepHook_t)(uint64_t timerUs, bool deep);
+void HostSim_SetSleepHook(HostSim_SleepHook_t hook);
+
+// What esp_reset_reason() reports (an esp_reset_reason_t, default
+// ESP_RST_POWERON); set before calling a module's init again to model a reset
+void HostSim_SetResetReason(int reason);
+
+// ---------------------------------------------------------------------------
+// Network: one WiFi network and one in-process MQTT broker behind it
+// ---------------------------------------------------------------------------
+// Link down: WiFi drops, open sockets close and connects fail (default up)
+void HostSim_SetLink(bool up);
+bool HostSim_BrokerConnected(void);
+
+// Every PUBLISH the broker receives from the device
+typedef void (*HostSim_PublishHook_t)(const char* topic, const uint8_t* payload, size_t length,
+                                      uint8_t qos, bool retain);
+void HostSim_SetPublishHook(HostSim_PublishHook_t hook);
+
+// Broker -> device; false when the device is not connected or not subscribed
+bool HostSim_Inject(const char* topic, const uint8_t* payload, size_t length);
+
+// Hand a message straight to the callback the device set on its PubSubClient,
+// as loop() does for a received PUBLISH, without the broker or the socket.
+// false when no callback is set.
+bool HostSim_CallMqttCallback(char* topic, uint8_t* payload, unsigned int length);
+
+// ---------------------------------------------------------------------------
+// Storage: LittleFS lives in this directory (default ./host_fs)
+// ---------------------------------------------------------------------------
+void HostSim_SetFsRoot(const char* path);
+
+// ---------------------------------------------------------------------------
+// Heap: live bytes/blocks, and the number and total size of malloc/new calls
+// so far (sizes as the allocator rounded them)
+// ---------------------------------------------------------------------------
+typedef struct
+{
+    size_t liveBytes;
+    size_t liveBlocks;
+    uint64_t allocations;
+    uint64_t allocatedBytes;
+} HostSim_Heap_t;
+
+HostSim_Heap_t HostSim_GetHeap(void);
+
+#endif // HOST_SIM_H
@@ -0,0 +1,267 @@
+#include <LittleFS.h>
+#include <dirent.h>
+#include <errno.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include "HostSim.h"
+
+#define HOST_FS_DEFAULT_ROOT    "host_fs"
+#define HOST_FS_SIZE            (1024 * 1024)   // a 1 MB LittleFS partition
+
+fs::LittleFSFS LittleFS;
+
+static std::string fsRoot = HOST_FS_DEFAULT_ROOT;
+
+void HostSim_SetFsRoot(const char* path)
+{
+    fsRoot = path;
+}
+
+namespace fs
+{
+
+// A regular file, or a directory being listed
+struct FileImpl
+{
+    std::string path;       // as the firmware sees it
+    std::string hostPath;
+    std::string name;
+    FILE* file = NULL;
+    DIR* dir = NULL;
+
+    ~FileImpl()
+    {
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        if (dir != NULL)
+        {
+            closedir(dir);
+        }
+    }
+};
+
+std::string FS::hostPath(const char* path)
+{
+    std::string p = root();
+    if (path[0] != '/')
+    {
+        p += '/';
+    }
+    return p + path;
+}
+
+static std::shared_ptr<FileImpl> openImpl(const std::string& path, const std::string& hostPath, const char* mode)
+{
+    std::shared_ptr<FileImpl> impl = std::make_shared<FileImpl>();
+    impl->path = path;
+    impl->hostPath = hostPath;
+    size_t slash = path.find_last_of('/');
+    impl->name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+    struct stat st;
+    if (stat(hostPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+    {
+        impl->dir = opendir(hostPath.c_str());
+        return impl->dir != NULL ? impl : nullptr;
+    }
+
+    // "w"/"a" create the file like LittleFS does
+    impl->file = fopen(hostPath.c_str(), (std::string(mode) + "b").c_str());
+    return impl->file != NULL ? impl : nullptr;
+}
+
+File FS::open(const char* path, const char* mode, bool create)
+{
+    (void)create;
+    return File(openImpl(path, hostPath(path), mode));
+}
+
+bool FS::exists(const char* path)
+{
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path)
+{
+    return unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* from, const char* to)
+{
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path)
+{
+    return ::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool FS::rmdir(const char* path)
+{
+    return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+size_t File::write(const uint8_t* buf, size_t size)
+{
+    return impl && impl->file != NULL ? fwrite(buf, 1, size, impl->file) : 0;
+}
+
+size_t File::read(uint8_t* buf, size_t size)
+{
+    return impl && impl->file != NULL ? fread(buf, 1, size, impl->file) : 0;
+}
+
+int File::read()
+{
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int File::available()
+{
+    return impl && impl->file != NULL ? (int)(size() - position()) : 0;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    static const int whence[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return impl && impl->file != NULL && fseek(impl->file, (long)pos, whence[mode]) == 0;
+}
+
+size_t File::position() const
+{
+    return impl && impl->file != NULL ? (size_t)ftell(impl->file) : 0;
+}
+
+size_t File::size() const
+{
+    if (!impl || impl->file == NULL)
+    {
+        return 0;
+    }
+    fflush(impl->file);
+    struct stat st;
+    return fstat(fileno(impl->file), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::flush()
+{
+    if (impl && impl->file != NULL)
+    {
+        fflush(impl->file);
+    }
+}
+
+void File::close()
+{
+    impl.reset();
+}
+
+const char* File::name() const
+{
+    return impl ? impl->name.c_str() : "";
+}
+
+const char* File::path() const
+{
+    return impl ? impl->path.c_str() : "";
+}
+
+bool File::isDirectory() const
+{
+    return impl && impl->dir != NULL;
+}
+
+File File::openNextFile(const char* mode)
+{
+    if (!impl || impl->dir == NULL)
+    {
+        return File();
+    }
+    for (struct dirent* entry = readdir(impl->dir); entry != NULL; entry = readdir(impl->dir))
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+        {
+            continue;
+        }
+        std::string path = impl->path + (impl->path.back() == '/' ? "" : "/") + entry->d_name;
+        return File(openImpl(path, impl->hostPath + "/" + entry->d_name, mode));
+    }
+    return File();
+}
+
+File::operator bool() const
+{
+    return (bool)impl;
+}
+
+// ---------------------------------------------------------------------------
+// LittleFS
+// ---------------------------------------------------------------------------
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles,
+                       const char* partitionLabel)
+{
+    (void)basePath;
+    (void)maxOpenFiles;
+    (void)partitionLabel;
+    struct stat st;
+    if (stat(root(), &st) == 0)
+    {
+        return S_ISDIR(st.st_mode);
+    }
+    return formatOnFail && ::mkdir(root(), 0755) == 0;
+}
+
+static size_t walkBytes = 0;
+
+static int walkRemove(const char* path, const struct stat* st, int flag, struct FTW* ftw)
+{
+    (void)st;
+    (void)flag;
+    return ftw->level == 0 ? 0 : ::remove(path);
+}
+
+static int walkSize(const char* path, const struct stat* st, int flag, struct FTW* ftw)
+{
+    (void)path;
+    (void)ftw;
+    if (flag == FTW_F)
+    {
+        walkBytes += (size_t)st->st_size;
+    }
+    return 0;
+}
+
+bool LittleFSFS::format()
+{
+    return nftw(root(), walkRemove, 16, FTW_DEPTH | FTW_PHYS) == 0;
+}
+
+size_t LittleFSFS::totalBytes()
+{
+    return HOST_FS_SIZE;
+}
+
+size_t LittleFSFS::usedBytes()
+{
+    walkBytes = 0;
+    nftw(root(), walkSize, 16, FTW_PHYS);
+    return walkBytes;
+}
+
+void LittleFSFS::end()
+{
+}
+
+const char* LittleFSFS::root()
+{
+    return fsRoot.c_str();
+}
+
+} // namespace fs
@@ -0,0 +1,105 @@
+#include <Preferences.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef std::map<std::string, std::vector<uint8_t>> NvsSpace_t;
+
+static std::mutex nvsMutex;
+static std::map<std::string, NvsSpace_t> nvs;
+
+#define NVS_KEY_MAX     15
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel)
+{
+    (void)partitionLabel;
+    if (open || name == NULL || strlen(name) > NVS_KEY_MAX)
+    {
+        return false;
+    }
+    space = name;
+    this->readOnly = readOnly;
+    open = true;
+    return true;
+}
+
+void Preferences::end()
+{
+    open = false;
+}
+
+bool Preferences::clear()
+{
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    if (!open || readOnly)
+    {
+        return false;
+    }
+    nvs[space].clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key)
+{
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return open && !readOnly && nvs[space].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key)
+{
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return open && nvs[space].count(key) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length)
+{
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    if (!open || readOnly || key == NULL || strlen(key) > NVS_KEY_MAX || value == NULL || length == 0)
+    {
+        return 0;
+    }
+    const uint8_t* bytes = (const uint8_t*)value;
+    nvs[space][key].assign(bytes, bytes + length);
+    return length;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength)
+{
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    if (!open || key == NULL || buffer == NULL)
+    {
+        return 0;
+    }
+    NvsSpace_t& entries = nvs[space];
+    NvsSpace_t::iterator it = entries.find(key);
+    if (it == entries.end() || it->second.size() > maxLength)
+    {
+        return 0;
+    }
+    memcpy(buffer, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key)
+{
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    if (!open || key == NULL)
+    {
+        return 0;
+    }
+    NvsSpace_t& entries = nvs[space];
+    NvsSpace_t::iterator it = entries.find(key);
+    return it == entries.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value)
+{
+    return putBytes(key, &value, sizeof(value));
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue)
+{
+    uint32_t value = defaultValue;
+    return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+}
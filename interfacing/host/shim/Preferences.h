@@ -0,0 +1,32 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+// Host NVS: namespaces live in process memory, so every run starts erased
+
+#include <Arduino.h>
+
+class Preferences
+{
+public:
+    Preferences() : open(false), readOnly(false) {}
+    ~Preferences() { end(); }
+
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = NULL);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBytes(const char* key, const void* value, size_t length);
+    size_t getBytes(const char* key, void* buffer, size_t maxLength);
+    size_t getBytesLength(const char* key);
+    size_t putUInt(const char* key, uint32_t value);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+
+private:
+    std::string space;
+    bool open;
+    bool readOnly;
+};
+
+#endif // HOST_PREFERENCES_H
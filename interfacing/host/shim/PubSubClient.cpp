@@ -0,0 +1,408 @@
+#include <PubSubClient.h>
+#include "HostSim.h"
+
+#define MQTT_MAX_HEADER_SIZE    5
+
+// Callback of the device's client, for HostSim_CallMqttCallback()
+static void (*deviceCallback)(char*, uint8_t*, unsigned int) = NULL;
+
+PubSubClient::PubSubClient(Client& client)
+    : client(&client), buffer(NULL), bufferSize(0), domain(NULL), port(0), callback(NULL),
+      keepAliveS(MQTT_KEEPALIVE), socketTimeoutS(MQTT_SOCKET_TIMEOUT), nextMsgId(1),
+      lastOutActivity(0), lastInActivity(0), pingOutstanding(false), clientState(MQTT_DISCONNECTED)
+{
+    setBufferSize(MQTT_MAX_PACKET_SIZE);
+}
+
+PubSubClient::~PubSubClient()
+{
+    free(buffer);
+}
+
+PubSubClient& PubSubClient::setServer(const char* domain, uint16_t port)
+{
+    this->domain = domain;
+    this->port = port;
+    return *this;
+}
+
+PubSubClient& PubSubClient::setCallback(MQTT_CALLBACK_SIGNATURE)
+{
+    this->callback = callback;
+    deviceCallback = callback;
+    return *this;
+}
+
+bool HostSim_CallMqttCallback(char* topic, uint8_t* payload, unsigned int length)
+{
+    if (deviceCallback == NULL)
+    {
+        return false;
+    }
+    deviceCallback(topic, payload, length);
+    return true;
+}
+
+PubSubClient& PubSubClient::setKeepAlive(uint16_t keepAliveS)
+{
+    this->keepAliveS = keepAliveS;
+    return *this;
+}
+
+PubSubClient& PubSubClient::setSocketTimeout(uint16_t timeoutS)
+{
+    socketTimeoutS = timeoutS;
+    return *this;
+}
+
+bool PubSubClient::setBufferSize(uint16_t size)
+{
+    if (size == 0)
+    {
+        return false;
+    }
+    uint8_t* resized = (uint8_t*)realloc(buffer, size);
+    if (resized == NULL)
+    {
+        return false;
+    }
+    buffer = resized;
+    bufferSize = size;
+    return true;
+}
+
+// Fixed header in front of the body already at buffer[MQTT_MAX_HEADER_SIZE];
+// returns where the packet starts
+size_t PubSubClient::buildHeader(uint8_t header, size_t length)
+{
+    uint8_t lengthBytes[4];
+    uint8_t count = 0;
+    do
+    {
+        uint8_t digit = length & 0x7F;
+        length >>= 7;
+        lengthBytes[count++] = digit | (length > 0 ? 0x80 : 0x00);
+    } while (length > 0 && count < 4);
+
+    size_t start = MQTT_MAX_HEADER_SIZE - 1 - count;
+    buffer[start] = header;
+    memcpy(&buffer[start + 1], lengthBytes, count);
+    return start;
+}
+
+bool PubSubClient::sendPacket(uint8_t header, size_t length)
+{
+    size_t start = buildHeader(header, length);
+    size_t total = MQTT_MAX_HEADER_SIZE - start + length;
+    lastOutActivity = millis();
+    return client->write(&buffer[start], total) == total;
+}
+
+size_t PubSubClient::writeString(const char* string, size_t pos)
+{
+    size_t length = strlen(string);
+    buffer[pos++] = (uint8_t)(length >> 8);
+    buffer[pos++] = (uint8_t)length;
+    memcpy(&buffer[pos], string, length);
+    return pos + length;
+}
+
+bool PubSubClient::readByte(uint8_t* b)
+{
+    unsigned long start = millis();
+    while (!client->available())
+    {
+        if (!client->connected() || millis() - start >= (unsigned long)socketTimeoutS * 1000)
+        {
+            return false;
+        }
+        delay(1);
+    }
+    *b = (uint8_t)client->read();
+    return true;
+}
+
+// One packet body into buffer; false on timeout, and for a packet that does
+// not fit, which is consumed and dropped like PubSubClient does
+bool PubSubClient::readPacket(uint8_t* header, uint32_t* bodyLength)
+{
+    if (!readByte(header))
+    {
+        return false;
+    }
+    uint32_t length = 0;
+    uint32_t multiplier = 1;
+    uint8_t digit;
+    do
+    {
+        if (!readByte(&digit))
+        {
+            return false;
+        }
+        length += (uint32_t)(digit & 0x7F) * multiplier;
+        multiplier <<= 7;
+    } while ((digit & 0x80) != 0 && multiplier <= (1UL << 21));
+
+    bool fits = length <= bufferSize;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        uint8_t b;
+        if (!readByte(&b))
+        {
+            return false;
+        }
+        if (fits)
+        {
+            buffer[i] = b;
+        }
+    }
+    lastInActivity = millis();
+    *bodyLength = length;
+    return fits;
+}
+
+bool PubSubClient::connect(const char* id)
+{
+    return connect(id, NULL, NULL, NULL, 0, false, NULL, true);
+}
+
+bool PubSubClient::connect(const char* id, const char* user, const char* pass)
+{
+    return connect(id, user, pass, NULL, 0, false, NULL, true);
+}
+
+bool PubSubClient::connect(const char* id, const char* user, const char* pass, const char* willTopic,
+                           uint8_t willQos, bool willRetain, const char* willMessage, bool cleanSession)
+{
+    if (connected())
+    {
+        return true;
+    }
+
+    // Reuse an open socket, as PubSubClient does
+    if (!client->connected() && client->connect(domain, port) != 1)
+    {
+        clientState = MQTT_CONNECT_FAILED;
+        return false;
+    }
+
+    size_t pos = MQTT_MAX_HEADER_SIZE;
+    pos = writeString("MQTT", pos);
+    buffer[pos++] = MQTT_VERSION_3_1_1;
+
+    uint8_t flags = cleanSession ? 0x02 : 0x00;
+    if (willTopic != NULL)
+    {
+        flags |= 0x04 | (uint8_t)(willQos << 3) | (willRetain ? 0x20 : 0x00);
+    }
+    if (user != NULL)
+    {
+        flags |= 0x80;
+        if (pass != NULL)
+        {
+            flags |= 0x40;
+        }
+    }
+    buffer[pos++] = flags;
+    buffer[pos++] = (uint8_t)(keepAliveS >> 8);
+    buffer[pos++] = (uint8_t)keepAliveS;
+
+    pos = writeString(id, pos);
+    if (willTopic != NULL)
+    {
+        pos = writeString(willTopic, pos);
+        pos = writeString(willMessage != NULL ? willMessage : "", pos);
+    }
+    if (user != NULL)
+    {
+        pos = writeString(user, pos);
+        if (pass != NULL)
+        {
+            pos = writeString(pass, pos);
+        }
+    }
+
+    if (!sendPacket(0x10, pos - MQTT_MAX_HEADER_SIZE))
+    {
+        clientState = MQTT_CONNECT_FAILED;
+        client->stop();
+        return false;
+    }
+
+    uint8_t header = 0;
+    uint32_t length = 0;
+    if (!readPacket(&header, &length) || length != 2 || header != 0x20)
+    {
+        clientState = MQTT_CONNECTION_TIMEOUT;
+        client->stop();
+        return false;
+    }
+    if (buffer[1] != 0)
+    {
+        clientState = buffer[1];
+        client->stop();
+        return false;
+    }
+
+    nextMsgId = 1;
+    pingOutstanding = false;
+    lastInActivity = lastOutActivity = millis();
+    clientState = MQTT_CONNECTED;
+    return true;
+}
+
+void PubSubClient::disconnect()
+{
+    if (client->connected())
+    {
+        buffer[MQTT_MAX_HEADER_SIZE] = 0;
+        sendPacket(0xE0, 0);
+    }
+    clientState = MQTT_DISCONNECTED;
+    client->flush();
+    client->stop();
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload, bool retained)
+{
+    return publish(topic, (const uint8_t*)payload, payload != NULL ? strlen(payload) : 0, retained);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained)
+{
+    if (!connected() || MQTT_MAX_HEADER_SIZE + 2 + strlen(topic) + length > bufferSize)
+    {
+        return false;
+    }
+    size_t pos = writeString(topic, MQTT_MAX_HEADER_SIZE);
+    memcpy(&buffer[pos], payload, length);
+    pos += length;
+    return sendPacket(0x30 | (retained ? 0x01 : 0x00), pos - MQTT_MAX_HEADER_SIZE);
+}
+
+bool PubSubClient::subscribe(const char* topic, uint8_t qos)
+{
+    if (qos > 1 || !connected() || MQTT_MAX_HEADER_SIZE + 2 + 2 + strlen(topic) + 1 > bufferSize)
+    {
+        return false;
+    }
+    nextMsgId = nextMsgId == 0xFFFF ? 1 : nextMsgId + 1;
+    size_t pos = MQTT_MAX_HEADER_SIZE;
+    buffer[pos++] = (uint8_t)(nextMsgId >> 8);
+    buffer[pos++] = (uint8_t)nextMsgId;
+    pos = writeString(topic, pos);
+    buffer[pos++] = qos;
+    return sendPacket(0x82, pos - MQTT_MAX_HEADER_SIZE);
+}
+
+bool PubSubClient::unsubscribe(const char* topic)
+{
+    if (!connected() || MQTT_MAX_HEADER_SIZE + 2 + 2 + strlen(topic) > bufferSize)
+    {
+        return false;
+    }
+    nextMsgId = nextMsgId == 0xFFFF ? 1 : nextMsgId + 1;
+    size_t pos = MQTT_MAX_HEADER_SIZE;
+    buffer[pos++] = (uint8_t)(nextMsgId >> 8);
+    buffer[pos++] = (uint8_t)nextMsgId;
+    pos = writeString(topic, pos);
+    return sendPacket(0xA2, pos - MQTT_MAX_HEADER_SIZE);
+}
+
+// Keep-alive, then at most one incoming packet per call
+bool PubSubClient::loop()
+{
+    if (!connected())
+    {
+        return false;
+    }
+
+    unsigned long now = millis();
+    unsigned long keepAliveMs = (unsigned long)keepAliveS * 1000;
+    if (keepAliveMs > 0 && (now - lastInActivity > keepAliveMs || now - lastOutActivity > keepAliveMs))
+    {
+        if (pingOutstanding)
+        {
+            clientState = MQTT_CONNECTION_TIMEOUT;
+            client->stop();
+            return false;
+        }
+        buffer[MQTT_MAX_HEADER_SIZE] = 0;
+        sendPacket(0xC0, 0);
+        lastInActivity = now;
+        pingOutstanding = true;
+    }
+
+    if (!client->available())
+    {
+        return true;
+    }
+
+    uint8_t header = 0;
+    uint32_t length = 0;
+    if (!readPacket(&header, &length))
+    {
+        return true;
+    }
+
+    switch (header & 0xF0)
+    {
+        case 0x30:  // PUBLISH
+        {
+            uint8_t qos = (header >> 1) & 0x03;
+            uint16_t topicLength = (uint16_t)((buffer[0] << 8) | buffer[1]);
+            size_t payloadStart = 2 + topicLength + (qos > 0 ? 2 : 0);
+            if (payloadStart > length)
+            {
+                break;
+            }
+            uint16_t msgId = qos > 0 ? (uint16_t)((buffer[2 + topicLength] << 8) | buffer[3 + topicLength]) : 0;
+
+            // The topic moves down one byte to make room for its terminator
+            memmove(buffer, buffer + 2, topicLength);
+            buffer[topicLength] = '\0';
+            if (callback != NULL)
+            {
+                callback((char*)buffer, buffer + payloadStart, length - payloadStart);
+            }
+            if (qos == 1)
+            {
+                buffer[MQTT_MAX_HEADER_SIZE] = (uint8_t)(msgId >> 8);
+                buffer[MQTT_MAX_HEADER_SIZE + 1] = (uint8_t)msgId;
+                sendPacket(0x40, 2);
+            }
+            break;
+        }
+
+        case 0xC0:  // PINGREQ
+            sendPacket(0xD0, 0);
+            break;
+
+        case 0xD0:  // PINGRESP
+            pingOutstanding = false;
+            break;
+
+        default:
+            break;
+    }
+    return true;
+}
+
+bool PubSubClient::connected()
+{
+    if (client == NULL)
+    {
+        return false;
+    }
+    if (!client->connected())
+    {
+        if (clientState == MQTT_CONNECTED)
+        {
+            clientState = MQTT_CONNECTION_LOST;
+            client->flush();
+            client->stop();
+        }
+        return false;
+    }
+    return clientState == MQTT_CONNECTED;
+}
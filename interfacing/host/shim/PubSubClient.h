@@ -0,0 +1,74 @@
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+// Host PubSubClient: the subset of knolleary/PubSubClient the firmware uses,
+// speaking real MQTT 3.1.1 packets over the Client it is given. QoS 0
+// publish, subscribe, and incoming PUBLISH through the callback in loop().
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#define MQTT_VERSION_3_1_1          4
+#define MQTT_MAX_PACKET_SIZE        256
+#define MQTT_KEEPALIVE              15
+#define MQTT_SOCKET_TIMEOUT         15
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED              0
+
+#define MQTT_CALLBACK_SIGNATURE     void (*callback)(char*, uint8_t*, unsigned int)
+
+class PubSubClient
+{
+public:
+    explicit PubSubClient(Client& client);
+    ~PubSubClient();
+
+    PubSubClient& setServer(const char* domain, uint16_t port);
+    PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE);
+    PubSubClient& setKeepAlive(uint16_t keepAliveS);
+    PubSubClient& setSocketTimeout(uint16_t timeoutS);
+    bool setBufferSize(uint16_t size);
+    uint16_t getBufferSize() { return bufferSize; }
+
+    bool connect(const char* id);
+    bool connect(const char* id, const char* user, const char* pass);
+    bool connect(const char* id, const char* user, const char* pass, const char* willTopic,
+                 uint8_t willQos, bool willRetain, const char* willMessage, bool cleanSession = true);
+    void disconnect();
+
+    bool publish(const char* topic, const char* payload, bool retained = false);
+    bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained = false);
+    bool subscribe(const char* topic, uint8_t qos = 0);
+    bool unsubscribe(const char* topic);
+
+    bool loop();
+    bool connected();
+    int state() { return clientState; }
+
+private:
+    Client* client;
+    uint8_t* buffer;
+    uint16_t bufferSize;
+    const char* domain;
+    uint16_t port;
+    void (*callback)(char*, uint8_t*, unsigned int);
+    uint16_t keepAliveS;
+    uint16_t socketTimeoutS;
+    uint16_t nextMsgId;
+    unsigned long lastOutActivity;
+    unsigned long lastInActivity;
+    bool pingOutstanding;
+    int clientState;
+
+    size_t buildHeader(uint8_t header, size_t length);
+    bool sendPacket(uint8_t header, size_t length);
+    size_t writeString(const char* string, size_t pos);
+    bool readByte(uint8_t* b);
+    bool readPacket(uint8_t* header, uint32_t* bodyLength);
+};
+
+#endif // HOST_PUBSUBCLIENT_H
@@ -0,0 +1,479 @@
+#include <WiFi.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "HostSim.h"
+
+WiFiClass WiFi;
+
+// One TCP connection to the broker. Bytes the device writes are parsed as
+// MQTT packets by the broker, which queues its answers for the device to read.
+struct HostConnection
+{
+    std::deque<uint8_t> toDevice;
+    std::vector<uint8_t> fromDevice;
+    bool open = true;
+};
+
+typedef struct
+{
+    std::string filter;
+    uint8_t qos;
+} BrokerSub_t;
+
+static std::recursive_mutex brokerMutex;
+static std::shared_ptr<HostConnection> brokerConnection;
+static std::vector<BrokerSub_t> brokerSubs;
+static uint16_t brokerMsgId = 0;
+static HostSim_PublishHook_t publishHook = NULL;
+
+static std::atomic<bool> linkUp(true);
+static std::atomic<bool> wifiStarted(false);
+
+void HostSim_SetLink(bool up)
+{
+    linkUp = up;
+}
+
+void HostSim_SetPublishHook(HostSim_PublishHook_t hook)
+{
+    std::lock_guard<std::recursive_mutex> lock(brokerMutex);
+    publishHook = hook;
+}
+
+static bool connectionUp(const std::shared_ptr<HostConnection>& connection)
+{
+    return connection && connection->open && linkUp && connection == brokerConnection;
+}
+
+bool HostSim_BrokerConnected(void)
+{
+    std::lock_guard<std::recursive_mutex> lock(brokerMutex);
+    return connectionUp(brokerConnection);
+}
+
+// ---------------------------------------------------------------------------
+// Broker
+// ---------------------------------------------------------------------------
+static bool topicMatches(const char* filter, const char* topic)
+{
+    if (topic[0] == '$' && (filter[0] == '+' || filter[0] == '#'))
+    {
+        return false;
+    }
+    for (;;)
+    {
+        if (*filter == '#')
+        {
+            return true;
+        }
+        if (*filter == '+')
+        {
+            filter++;
+            while (*topic != '\0' && *topic != '/')
+            {
+                topic++;
+            }
+        }
+        else
+        {
+            while (*filter != '\0' && *filter != '/')
+            {
+                if (*filter++ != *topic++)
+                {
+                    return false;
+                }
+            }
+        }
+        if (*filter == '\0')
+        {
+            return *topic == '\0';
+        }
+        if (*topic != '/')
+        {
+            return *topic == '\0' && strcmp(filter, "/#") == 0;
+        }
+        filter++;
+        topic++;
+    }
+}
+
+static void brokerSend(uint8_t header, const std::vector<uint8_t>& body)
+{
+    std::deque<uint8_t>& out = brokerConnection->toDevice;
+    out.push_back(header);
+    size_t remaining = body.size();
+    do
+    {
+        uint8_t digit = remaining & 0x7F;
+        remaining >>= 7;
+        out.push_back(digit | (remaining > 0 ? 0x80 : 0x00));
+    } while (remaining > 0);
+    out.insert(out.end(), body.begin(), body.end());
+}
+
+static std::string readString(const uint8_t* body, size_t length, size_t* pos)
+{
+    if (*pos + 2 > length)
+    {
+        *pos = length + 1;
+        return std::string();
+    }
+    size_t n = ((size_t)body[*pos] << 8) | body[*pos + 1];
+    *pos += 2;
+    if (*pos + n > length)
+    {
+        *pos = length + 1;
+        return std::string();
+    }
+    std::string s((const char*)&body[*pos], n);
+    *pos += n;
+    return s;
+}
+
+static void brokerDeliver(const std::string& topic, const uint8_t* payload, size_t length)
+{
+    int qos = -1;
+    for (const BrokerSub_t& sub : brokerSubs)
+    {
+        if (topicMatches(sub.filter.c_str(), topic.c_str()) && sub.qos > qos)
+        {
+            qos = sub.qos;
+        }
+    }
+    if (qos < 0)
+    {
+        return;
+    }
+
+    std::vector<uint8_t> body;
+    body.push_back((uint8_t)(topic.size() >> 8));
+    body.push_back((uint8_t)topic.size());
+    body.insert(body.end(), topic.begin(), topic.end());
+    if (qos > 0)
+    {
+        brokerMsgId = brokerMsgId == 0xFFFF ? 1 : brokerMsgId + 1;
+        body.push_back((uint8_t)(brokerMsgId >> 8));
+        body.push_back((uint8_t)brokerMsgId);
+    }
+    body.insert(body.end(), payload, payload + length);
+    brokerSend(qos > 0 ? 0x32 : 0x30, body);
+}
+
+static void brokerHandle(uint8_t header, const uint8_t* body, size_t length)
+{
+    size_t pos = 0;
+    switch (header & 0xF0)
+    {
+        case 0x10:  // CONNECT
+        {
+            readString(body, length, &pos);     // protocol name
+            pos++;                              // level
+            uint8_t flags = pos < length ? body[pos] : 0;
+            if (flags & 0x02)
+            {
+                brokerSubs.clear();
+            }
+            brokerSend(0x20, {0x00, 0x00});
+            break;
+        }
+
+        case 0x30:  // PUBLISH
+        {
+            uint8_t qos = (header >> 1) & 0x03;
+            std::string topic = readString(body, length, &pos);
+            uint16_t msgId = 0;
+            if (qos > 0 && pos + 2 <= length)
+            {
+                msgId = (uint16_t)((body[pos] << 8) | body[pos + 1]);
+                pos += 2;
+            }
+            if (pos > length)
+            {
+                break;
+            }
+            if (publishHook != NULL)
+            {
+                publishHook(topic.c_str(), body + pos, length - pos, qos, (header & 0x01) != 0);
+            }
+            if (qos == 1)
+            {
+                brokerSend(0x40, {(uint8_t)(msgId >> 8), (uint8_t)msgId});
+            }
+            brokerDeliver(topic, body + pos, length - pos);
+            break;
+        }
+
+        case 0x80:  // SUBSCRIBE
+        {
+            std::vector<uint8_t> ack = {body[0], body[1]};
+            pos = 2;
+            while (pos < length)
+            {
+                std::string filter = readString(body, length, &pos);
+                if (pos >= length)
+                {
+                    break;
+                }
+                uint8_t qos = body[pos++];
+                qos = qos > 1 ? 1 : qos;
+                bool found = false;
+                for (BrokerSub_t& sub : brokerSubs)
+                {
+                    if (sub.filter == filter)
+                    {
+                        sub.qos = qos;
+                        found = true;
+                    }
+                }
+                if (!found)
+                {
+                    brokerSubs.push_back({filter, qos});
+                }
+                ack.push_back(qos);
+            }
+            brokerSend(0x90, ack);
+            break;
+        }
+
+        case 0xA0:  // UNSUBSCRIBE
+        {
+            pos = 2;
+            while (pos < length)
+            {
+                std::string filter = readString(body, length, &pos);
+                for (size_t i = 0; i < brokerSubs.size(); i++)
+                {
+                    if (brokerSubs[i].filter == filter)
+                    {
+                        brokerSubs.erase(brokerSubs.begin() + i);
+                        break;
+                    }
+                }
+            }
+            brokerSend(0xB0, {body[0], body[1]});
+            break;
+        }
+
+        case 0xC0:  // PINGREQ
+            brokerSend(0xD0, {});
+            break;
+
+        case 0xE0:  // DISCONNECT
+            brokerConnection->open = false;
+            break;
+
+        default:    // PUBACK for our QoS 1 deliveries and anything else
+            break;
+    }
+}
+
+// Split what the device wrote into whole packets
+static void brokerReceive(void)
+{
+    std::vector<uint8_t>& in = brokerConnection->fromDevice;
+    for (;;)
+    {
+        size_t pos = 1;
+        uint32_t remaining = 0;
+        uint32_t multiplier = 1;
+        bool lengthDone = false;
+        while (pos < in.size() && pos <= 4)
+        {
+            uint8_t digit = in[pos++];
+            remaining += (uint32_t)(digit & 0x7F) * multiplier;
+            multiplier <<= 7;
+            if ((digit & 0x80) == 0)
+            {
+                lengthDone = true;
+                break;
+            }
+        }
+        if (!lengthDone || in.size() < pos + remaining)
+        {
+            return;
+        }
+        std::vector<uint8_t> body(in.begin() + pos, in.begin() + pos + remaining);
+        uint8_t header = in[0];
+        in.erase(in.begin(), in.begin() + pos + remaining);
+        brokerHandle(header, body.data(), body.size());
+    }
+}
+
+bool HostSim_Inject(const char* topic, const uint8_t* payload, size_t length)
+{
+    std::lock_guard<std::recursive_mutex> lock(brokerMutex);
+    if (!connectionUp(brokerConnection))
+    {
+        return false;
+    }
+    size_t queued = brokerConnection->toDevice.size();
+    brokerDeliver(topic, payload, length);
+    return brokerConnection->toDevice.size() != queued;
+}
+
+// ---------------------------------------------------------------------------
+// WiFiClient
+// ---------------------------------------------------------------------------
+int WiFiClient::connect(const char* host, uint16_t port)
+{
+    (void)host;
+    (void)port;
+    std::lock_guard<std::recursive_mutex> lock(brokerMutex);
+    if (!linkUp || !wifiStarted)
+    {
+        return 0;
+    }
+    // The broker takes one client; a new connection replaces the old one
+    if (brokerConnection)
+    {
+        brokerConnection->open = false;
+    }
+    connection = std::make_shared<HostConnection>();
+    brokerConnection = connection;
+    return 1;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port)
+{
+    return connect(ip.toString().c_str(), port);
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port, int32_t timeoutMs)
+{
+    (void)timeoutMs;
+    return connect(ip, port);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port, int32_t timeoutMs)
+{
+    (void)timeoutMs;
+    return connect(host, port);
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size)
+{
+    std::lock_guard<std::recursive_mutex> lock(brokerMutex);
+    if (!connectionUp(connection))
+    {
+        return 0;
+    }
+    connection->fromDevice.insert(connection->fromDevice.end(), buf, buf + size);
+    brokerReceive();
+    return size;
+}
+
+int WiFiClient::available()
+{
+    std::lock_guard<std::recursive_mutex> lock(brokerMutex);
+    return connectionUp(connection) ? (int)connection->toDevice.size() : 0;
+}
+
+int WiFiClient::read()
+{
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size)
+{
+    std::lock_guard<std::recursive_mutex> lock(brokerMutex);
+    if (!connectionUp(connection))
+    {
+        return -1;
+    }
+    size_t n = 0;
+    while (n < size && !connection->toDevice.empty())
+    {
+        buf[n++] = connection->toDevice.front();
+        connection->toDevice.pop_front();
+    }
+    return (int)n;
+}
+
+int WiFiClient::peek()
+{
+    std::lock_guard<std::recursive_mutex> lock(brokerMutex);
+    return connectionUp(connection) && !connection->toDevice.empty() ? connection->toDevice.front() : -1;
+}
+
+void WiFiClient::stop()
+{
+    std::lock_guard<std::recursive_mutex> lock(brokerMutex);
+    if (connection)
+    {
+        connection->open = false;
+        connection.reset();
+    }
+}
+
+uint8_t WiFiClient::connected()
+{
+    std::lock_guard<std::recursive_mutex> lock(brokerMutex);
+    return connectionUp(connection) ? 1 : 0;
+}
+
+// ---------------------------------------------------------------------------
+// WiFi
+// ---------------------------------------------------------------------------
+wl_status_t WiFiClass::begin(const char* ssid, const char* password)
+{
+    (void)ssid;
+    (void)password;
+    wifiStarted = true;
+    return status();
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAp)
+{
+    (void)wifiOff;
+    (void)eraseAp;
+    wifiStarted = false;
+    return true;
+}
+
+bool WiFiClass::mode(wifi_mode_t mode)
+{
+    if (mode == WIFI_OFF)
+    {
+        wifiStarted = false;
+    }
+    return true;
+}
+
+wl_status_t WiFiClass::status()
+{
+    if (!wifiStarted)
+    {
+        return WL_DISCONNECTED;
+    }
+    return linkUp ? WL_CONNECTED : WL_NO_SSID_AVAIL;
+}
+
+IPAddress WiFiClass::localIP()
+{
+    return status() == WL_CONNECTED ? IPAddress(192, 168, 1, 50) : IPAddress();
+}
+
+int8_t WiFiClass::RSSI()
+{
+    return status() == WL_CONNECTED ? -55 : 0;
+}
+
+uint8_t* WiFiClass::macAddress(uint8_t* mac)
+{
+    static const uint8_t hostMac[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x01};
+    memcpy(mac, hostMac, sizeof(hostMac));
+    return mac;
+}
+
+String WiFiClass::macAddress()
+{
+    uint8_t mac[6];
+    macAddress(mac);
+    char buffer[18];
+    snprintf(buffer, sizeof(buffer), "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    return String(buffer);
+}
@@ -0,0 +1,111 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// Host WiFi: one network that is either up or down (HostSim_SetLink), and a
+// WiFiClient whose only reachable server is the in-process MQTT broker
+
+#include <Arduino.h>
+#include <deque>
+#include <memory>
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum
+{
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+class IPAddress
+{
+public:
+    IPAddress() : address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    operator uint32_t() const { return address; }
+    String toString() const
+    {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (unsigned)(address & 0xFF),
+                 (unsigned)((address >> 8) & 0xFF), (unsigned)((address >> 16) & 0xFF),
+                 (unsigned)(address >> 24));
+        return String(buffer);
+    }
+
+private:
+    uint32_t address;
+};
+
+class Client
+{
+public:
+    virtual ~Client() {}
+    virtual int connect(IPAddress ip, uint16_t port) = 0;
+    virtual int connect(const char* host, uint16_t port) = 0;
+    virtual size_t write(uint8_t b) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size) = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int read(uint8_t* buf, size_t size) = 0;
+    virtual int peek() = 0;
+    virtual void flush() = 0;
+    virtual void stop() = 0;
+    virtual uint8_t connected() = 0;
+    virtual operator bool() = 0;
+};
+
+struct HostConnection;
+
+class WiFiClient : public Client
+{
+public:
+    WiFiClient() {}
+
+    int connect(IPAddress ip, uint16_t port);
+    int connect(const char* host, uint16_t port);
+    int connect(IPAddress ip, uint16_t port, int32_t timeoutMs);
+    int connect(const char* host, uint16_t port, int32_t timeoutMs);
+
+    size_t write(uint8_t b) { return write(&b, 1); }
+    size_t write(const uint8_t* buf, size_t size);
+    int available();
+    int read();
+    int read(uint8_t* buf, size_t size);
+    int peek();
+    void flush() {}
+    void stop();
+    uint8_t connected();
+    operator bool() { return connected() != 0; }
+
+private:
+    std::shared_ptr<HostConnection> connection;
+};
+
+class WiFiClass
+{
+public:
+    wl_status_t begin(const char* ssid, const char* password = NULL);
+    bool disconnect(bool wifiOff = false, bool eraseAp = false);
+    bool mode(wifi_mode_t mode);
+    bool mode(int mode) { return this->mode((wifi_mode_t)mode); }
+    wl_status_t status();
+    IPAddress localIP();
+    int8_t RSSI();
+    uint8_t* macAddress(uint8_t* mac);
+    String macAddress();
+};
+
+extern WiFiClass WiFi;
+
+#endif // HOST_WIFI_H
@@ -0,0 +1,9 @@
+#ifndef HOST_ESP_ARDUINO_VERSION_H
+#define HOST_ESP_ARDUINO_VERSION_H
+
+// The shim follows arduino-esp32 3.x
+#define ESP_ARDUINO_VERSION_MAJOR   3
+#define ESP_ARDUINO_VERSION_MINOR   0
+#define ESP_ARDUINO_VERSION_PATCH   0
+
+#endif // HOST_ESP_ARDUINO_VERSION_H
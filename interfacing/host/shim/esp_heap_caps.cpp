@@ -0,0 +1,141 @@
+#include <esp_heap_caps.h>
+#include <malloc.h>
+#include <atomic>
+#include "HostSim.h"
+
+// DRAM the firmware sees on an ESP32 after the RTOS and WiFi took their share
+#define HOST_HEAP_SIZE      (300 * 1024)
+
+// glibc's own allocator underneath the counting wrappers
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+extern "C" void __libc_free(void* ptr);
+
+static std::atomic<size_t> liveBytes(0);
+static std::atomic<size_t> liveBlocks(0);
+static std::atomic<size_t> peakBytes(0);
+static std::atomic<uint64_t> allocations(0);
+static std::atomic<uint64_t> allocatedBytes(0);
+
+static void* counted(void* ptr)
+{
+    if (ptr != NULL)
+    {
+        size_t size = malloc_usable_size(ptr);
+        size_t bytes = liveBytes += size;
+        liveBlocks++;
+        allocations++;
+        allocatedBytes += size;
+        size_t peak = peakBytes;
+        while (bytes > peak && !peakBytes.compare_exchange_weak(peak, bytes))
+        {
+        }
+    }
+    return ptr;
+}
+
+static void released(void* ptr)
+{
+    if (ptr != NULL)
+    {
+        liveBytes -= malloc_usable_size(ptr);
+        liveBlocks--;
+    }
+}
+
+extern "C" void* malloc(size_t size)
+{
+    return counted(__libc_malloc(size));
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+    return counted(__libc_calloc(count, size));
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+    released(ptr);
+    void* resized = __libc_realloc(ptr, size);
+    if (resized == NULL && size != 0)
+    {
+        // The old block is still there
+        counted(ptr);
+        allocations--;
+        allocatedBytes -= malloc_usable_size(ptr);
+        return NULL;
+    }
+    return counted(resized);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size)
+{
+    return counted(__libc_memalign(alignment, size));
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size)
+{
+    return counted(__libc_memalign(alignment, size));
+}
+
+extern "C" int posix_memalign(void** out, size_t alignment, size_t size)
+{
+    void* ptr = counted(__libc_memalign(alignment, size));
+    if (ptr == NULL)
+    {
+        return 12;  // ENOMEM
+    }
+    *out = ptr;
+    return 0;
+}
+
+extern "C" void free(void* ptr)
+{
+    released(ptr);
+    __libc_free(ptr);
+}
+
+HostSim_Heap_t HostSim_GetHeap(void)
+{
+    HostSim_Heap_t heap = {liveBytes, liveBlocks, allocations, allocatedBytes};
+    return heap;
+}
+
+static size_t freeBytes(size_t live)
+{
+    return live < HOST_HEAP_SIZE ? HOST_HEAP_SIZE - live : 0;
+}
+
+void heap_caps_get_info(multi_heap_info_t* info, uint32_t caps)
+{
+    (void)caps;
+    size_t live = liveBytes;
+    info->total_free_bytes = freeBytes(live);
+    info->total_allocated_bytes = live;
+    info->largest_free_block = freeBytes(live);
+    info->minimum_free_bytes = freeBytes(peakBytes);
+    info->allocated_blocks = liveBlocks;
+    info->free_blocks = 1;
+    info->total_blocks = info->allocated_blocks + 1;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    (void)caps;
+    return freeBytes(liveBytes);
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    (void)caps;
+    return freeBytes(peakBytes);
+}
+
+// No fragmentation model: all free memory counts as one block
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    (void)caps;
+    return freeBytes(liveBytes);
+}
@@ -0,0 +1,31 @@
+#ifndef HOST_ESP_SLEEP_H
+#define HOST_ESP_SLEEP_H
+
+#include <stdint.h>
+
+typedef enum
+{
+    ESP_SLEEP_WAKEUP_UNDEFINED = 0,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP,
+    ESP_SLEEP_WAKEUP_GPIO,
+    ESP_SLEEP_WAKEUP_UART
+} esp_sleep_wakeup_cause_t;
+
+typedef int esp_err_t;
+#ifndef ESP_OK
+#define ESP_OK 0
+#endif
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs);
+// Light sleep waits out the timer; deep sleep would reset the chip, so the
+// host process ends there
+esp_err_t esp_light_sleep_start(void);
+void esp_deep_sleep_start(void) __attribute__((noreturn));
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void);
+
+#endif // HOST_ESP_SLEEP_H
@@ -0,0 +1,64 @@
+#include <Arduino.h>
+#include <esp_system.h>
+#include <esp_sleep.h>
+#include "HostSim.h"
+#include "HostInternal.h"
+
+static uint64_t sleepTimerUs = 0;
+static HostSim_SleepHook_t sleepHook = NULL;
+
+void HostSim_SetSleepHook(HostSim_SleepHook_t hook)
+{
+    sleepHook = hook;
+}
+
+static esp_reset_reason_t resetReason = ESP_RST_POWERON;
+
+void HostSim_SetResetReason(int reason)
+{
+    resetReason = (esp_reset_reason_t)reason;
+}
+
+esp_reset_reason_t esp_reset_reason(void)
+{
+    return resetReason;
+}
+
+void esp_restart(void)
+{
+    Serial.println("[HOST] esp_restart(), exiting");
+    Serial.flush();
+    exit(0);
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs)
+{
+    sleepTimerUs = timeUs;
+    return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start(void)
+{
+    if (sleepHook != NULL)
+    {
+        sleepHook(sleepTimerUs, false);
+    }
+    HostClock_SleepUs(sleepTimerUs);
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start(void)
+{
+    if (sleepHook != NULL)
+    {
+        sleepHook(sleepTimerUs, true);
+    }
+    Serial.printf("[HOST] Deep sleep for %llu us, exiting\n", (unsigned long long)sleepTimerUs);
+    Serial.flush();
+    exit(0);
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void)
+{
+    return ESP_SLEEP_WAKEUP_UNDEFINED;
+}
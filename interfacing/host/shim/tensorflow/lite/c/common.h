@@ -0,0 +1,57 @@
+#ifndef HOST_TFLITE_COMMON_H
+#define HOST_TFLITE_COMMON_H
+
+// The parts of the TFLite C API the firmware touches
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+    kTfLiteOk = 0,
+    kTfLiteError = 1
+} TfLiteStatus;
+
+typedef enum
+{
+    kTfLiteNoType = 0,
+    kTfLiteFloat32 = 1,
+    kTfLiteInt32 = 2,
+    kTfLiteUInt8 = 3,
+    kTfLiteInt64 = 4,
+    kTfLiteInt16 = 7,
+    kTfLiteInt8 = 9
+} TfLiteType;
+
+typedef struct
+{
+    int size;
+    int data[4];
+} TfLiteIntArray;
+
+typedef struct
+{
+    float scale;
+    int32_t zero_point;
+} TfLiteQuantizationParams;
+
+typedef union
+{
+    int32_t* i32;
+    float* f;
+    int8_t* int8;
+    uint8_t* uint8;
+    void* raw;
+    const void* raw_const;
+} TfLitePtrUnion;
+
+typedef struct
+{
+    TfLiteType type;
+    TfLitePtrUnion data;
+    TfLiteIntArray* dims;
+    TfLiteQuantizationParams params;
+    size_t bytes;
+} TfLiteTensor;
+
+#endif // HOST_TFLITE_COMMON_H
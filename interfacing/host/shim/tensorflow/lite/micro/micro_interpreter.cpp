@@ -0,0 +1,334 @@
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include <math.h>
+#include <stdio.h>
+
+namespace tflite
+{
+
+static const size_t kArenaAlignment = 16;
+
+static size_t typeSize(TfLiteType type)
+{
+    switch (type)
+    {
+        case kTfLiteFloat32:
+        case kTfLiteInt32:
+            return 4;
+        case kTfLiteInt64:
+            return 8;
+        case kTfLiteInt16:
+            return 2;
+        case kTfLiteInt8:
+        case kTfLiteUInt8:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static TfLiteType tensorType(TensorType type)
+{
+    switch (type)
+    {
+        case TensorType_FLOAT32: return kTfLiteFloat32;
+        case TensorType_INT32:   return kTfLiteInt32;
+        case TensorType_UINT8:   return kTfLiteUInt8;
+        case TensorType_INT64:   return kTfLiteInt64;
+        case TensorType_INT16:   return kTfLiteInt16;
+        case TensorType_INT8:    return kTfLiteInt8;
+        default:                 return kTfLiteNoType;
+    }
+}
+
+static BuiltinOperator opCode(const Model* model, const Operator* op)
+{
+    const OperatorCode* code = model->operator_codes()->Get(op->opcode_index());
+    int32_t builtin = code->builtin_code();
+    return (BuiltinOperator)(builtin > code->deprecated_builtin_code() ? builtin : code->deprecated_builtin_code());
+}
+
+static size_t flatSize(const TfLiteIntArray* dims)
+{
+    size_t size = 1;
+    for (int i = 0; i < dims->size; i++)
+    {
+        size *= (size_t)dims->data[i];
+    }
+    return size;
+}
+
+// Per-channel scale when the tensor has one per output row
+static float channelScale(const Tensor* tensor, uint32_t channel)
+{
+    const QuantizationParameters* q = tensor->quantization();
+    if (q == nullptr || q->scale() == nullptr || q->scale()->size() == 0)
+    {
+        return 1.0f;
+    }
+    return q->scale()->Get(q->scale()->size() > 1 ? channel : 0);
+}
+
+static int8_t saturate(long value, long low, long high)
+{
+    return (int8_t)(value < low ? low : (value > high ? high : value));
+}
+
+MicroInterpreter::MicroInterpreter(const Model* model, const MicroOpResolver& opResolver,
+                                   uint8_t* tensorArena, size_t tensorArenaSize,
+                                   void* resourceVariables, void* profiler)
+    : model(model), opResolver(opResolver), arena(tensorArena), arenaSize(tensorArenaSize),
+      arenaUsed(0), subgraph(nullptr), tensors(nullptr), allocated(false)
+{
+    (void)resourceVariables;
+    (void)profiler;
+}
+
+void* MicroInterpreter::arenaAlloc(size_t bytes)
+{
+    size_t start = (arenaUsed + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+    if (start + bytes > arenaSize)
+    {
+        return nullptr;
+    }
+    arenaUsed = start + bytes;
+    return arena + start;
+}
+
+TfLiteStatus MicroInterpreter::AllocateTensors()
+{
+    if (allocated)
+    {
+        return kTfLiteOk;
+    }
+    if (model->version() != TFLITE_SCHEMA_VERSION || model->subgraphs() == nullptr ||
+        model->subgraphs()->size() != 1)
+    {
+        fprintf(stderr, "[TFLM host] Unsupported model\n");
+        return kTfLiteError;
+    }
+    subgraph = model->subgraphs()->Get(0);
+
+    const flatbuffers::Vector<const Operator*>* ops = subgraph->operators();
+    for (uint32_t i = 0; ops != nullptr && i < ops->size(); i++)
+    {
+        BuiltinOperator code = opCode(model, ops->Get(i));
+        if (!opResolver.HasBuiltin(code) ||
+            (code != BuiltinOperator_FULLY_CONNECTED && code != BuiltinOperator_LOGISTIC))
+        {
+            fprintf(stderr, "[TFLM host] Operator %d not registered or not implemented\n", (int)code);
+            return kTfLiteError;
+        }
+    }
+
+    const flatbuffers::Vector<const Tensor*>* modelTensors = subgraph->tensors();
+    uint32_t count = modelTensors->size();
+    tensors = (TfLiteTensor*)arenaAlloc(sizeof(TfLiteTensor) * count);
+    TfLiteIntArray* dims = (TfLiteIntArray*)arenaAlloc(sizeof(TfLiteIntArray) * count);
+    if (tensors == nullptr || dims == nullptr)
+    {
+        fprintf(stderr, "[TFLM host] Arena too small\n");
+        return kTfLiteError;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const Tensor* source = modelTensors->Get(i);
+        TfLiteTensor* t = &tensors[i];
+        memset(t, 0, sizeof(*t));
+        t->type = tensorType(source->type());
+        t->dims = &dims[i];
+
+        const flatbuffers::Vector<int32_t>* shape = source->shape();
+        t->dims->size = shape != nullptr ? (int)shape->size() : 0;
+        if (t->dims->size > (int)(sizeof(t->dims->data) / sizeof(t->dims->data[0])))
+        {
+            fprintf(stderr, "[TFLM host] Tensor %u has too many dimensions\n", (unsigned)i);
+            return kTfLiteError;
+        }
+        for (int d = 0; d < t->dims->size; d++)
+        {
+            t->dims->data[d] = shape->Get(d);
+        }
+        t->bytes = flatSize(t->dims) * typeSize(t->type);
+
+        const QuantizationParameters* q = source->quantization();
+        if (q != nullptr && q->scale() != nullptr && q->scale()->size() > 0)
+        {
+            t->params.scale = q->scale()->Get(0);
+            t->params.zero_point = q->zero_point() != nullptr && q->zero_point()->size() > 0
+                                   ? (int32_t)q->zero_point()->Get(0) : 0;
+        }
+
+        // Constants point into the model, everything else gets arena space
+        const Buffer* buffer = model->buffers()->Get(source->buffer());
+        if (buffer != nullptr && buffer->data() != nullptr && buffer->data()->size() > 0)
+        {
+            t->data.raw_const = buffer->data()->Data();
+        }
+        else
+        {
+            t->data.raw = arenaAlloc(t->bytes);
+            if (t->data.raw == nullptr)
+            {
+                fprintf(stderr, "[TFLM host] Arena too small\n");
+                return kTfLiteError;
+            }
+            memset(t->data.raw, 0, t->bytes);
+        }
+    }
+
+    allocated = true;
+    return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreter::fullyConnected(const Operator* op)
+{
+    const flatbuffers::Vector<const Tensor*>* modelTensors = subgraph->tensors();
+    int32_t inputIndex = op->inputs()->Get(0);
+    int32_t filterIndex = op->inputs()->Get(1);
+    int32_t biasIndex = op->inputs()->size() > 2 ? op->inputs()->Get(2) : -1;
+    const TfLiteTensor* in = &tensors[inputIndex];
+    const TfLiteTensor* filter = &tensors[filterIndex];
+    const TfLiteTensor* bias = biasIndex >= 0 ? &tensors[biasIndex] : nullptr;
+    TfLiteTensor* out = &tensors[op->outputs()->Get(0)];
+
+    const int outDim = filter->dims->data[0];
+    const int inDim = filter->dims->data[1];
+    const int batches = (int)(flatSize(out->dims) / (size_t)outDim);
+    const FullyConnectedOptions* options = op->builtin_options_as_FullyConnectedOptions();
+    ActivationFunctionType activation = options != nullptr ? options->fused_activation_function()
+                                                            : ActivationFunctionType_NONE;
+
+    if (in->type == kTfLiteFloat32)
+    {
+        for (int b = 0; b < batches; b++)
+        {
+            for (int o = 0; o < outDim; o++)
+            {
+                float acc = bias != nullptr ? bias->data.f[o] : 0.0f;
+                for (int i = 0; i < inDim; i++)
+                {
+                    acc += in->data.f[b * inDim + i] * filter->data.f[o * inDim + i];
+                }
+                if (activation == ActivationFunctionType_RELU)
+                {
+                    acc = acc > 0.0f ? acc : 0.0f;
+                }
+                else if (activation == ActivationFunctionType_RELU6)
+                {
+                    acc = acc < 0.0f ? 0.0f : (acc > 6.0f ? 6.0f : acc);
+                }
+                else if (activation == ActivationFunctionType_RELU_N1_TO_1)
+                {
+                    acc = acc < -1.0f ? -1.0f : (acc > 1.0f ? 1.0f : acc);
+                }
+                out->data.f[b * outDim + o] = acc;
+            }
+        }
+        return kTfLiteOk;
+    }
+
+    if (in->type != kTfLiteInt8 || filter->type != kTfLiteInt8 || out->type != kTfLiteInt8)
+    {
+        return kTfLiteError;
+    }
+
+    // The fused activation is a clamp in the output's quantized domain
+    long low = -128;
+    long high = 127;
+    if (activation == ActivationFunctionType_RELU || activation == ActivationFunctionType_RELU6)
+    {
+        low = out->params.zero_point > low ? out->params.zero_point : low;
+    }
+    if (activation == ActivationFunctionType_RELU6)
+    {
+        long six = out->params.zero_point + lroundf(6.0f / out->params.scale);
+        high = six < high ? six : high;
+    }
+
+    const Tensor* filterSource = modelTensors->Get(filterIndex);
+    for (int o = 0; o < outDim; o++)
+    {
+        double scale = (double)in->params.scale * channelScale(filterSource, o) / out->params.scale;
+        for (int b = 0; b < batches; b++)
+        {
+            int32_t acc = bias != nullptr ? bias->data.i32[o] : 0;
+            for (int i = 0; i < inDim; i++)
+            {
+                acc += (in->data.int8[b * inDim + i] - in->params.zero_point) *
+                       (filter->data.int8[o * inDim + i] - filter->params.zero_point);
+            }
+            long q = lround(acc * scale) + out->params.zero_point;
+            out->data.int8[b * outDim + o] = saturate(q, low, high);
+        }
+    }
+    return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreter::logistic(const Operator* op)
+{
+    const TfLiteTensor* in = &tensors[op->inputs()->Get(0)];
+    TfLiteTensor* out = &tensors[op->outputs()->Get(0)];
+    size_t size = flatSize(out->dims);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if (in->type == kTfLiteFloat32)
+        {
+            out->data.f[i] = 1.0f / (1.0f + expf(-in->data.f[i]));
+        }
+        else if (in->type == kTfLiteInt8)
+        {
+            float x = (in->data.int8[i] - in->params.zero_point) * in->params.scale;
+            float y = 1.0f / (1.0f + expf(-x));
+            out->data.int8[i] = saturate(lroundf(y / out->params.scale) + out->params.zero_point, -128, 127);
+        }
+        else
+        {
+            return kTfLiteError;
+        }
+    }
+    return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreter::Invoke()
+{
+    if (!allocated)
+    {
+        return kTfLiteError;
+    }
+    const flatbuffers::Vector<const Operator*>* ops = subgraph->operators();
+    for (uint32_t i = 0; i < ops->size(); i++)
+    {
+        const Operator* op = ops->Get(i);
+        TfLiteStatus status = opCode(model, op) == BuiltinOperator_FULLY_CONNECTED ? fullyConnected(op)
+                                                                                   : logistic(op);
+        if (status != kTfLiteOk)
+        {
+            return status;
+        }
+    }
+    return kTfLiteOk;
+}
+
+TfLiteTensor* MicroInterpreter::input(size_t index)
+{
+    return allocated && index < inputs_size() ? &tensors[subgraph->inputs()->Get(index)] : nullptr;
+}
+
+TfLiteTensor* MicroInterpreter::output(size_t index)
+{
+    return allocated && index < outputs_size() ? &tensors[subgraph->outputs()->Get(index)] : nullptr;
+}
+
+size_t MicroInterpreter::inputs_size() const
+{
+    return subgraph != nullptr ? subgraph->inputs()->size() : 0;
+}
+
+size_t MicroInterpreter::outputs_size() const
+{
+    return subgraph != nullptr ? subgraph->outputs()->size() : 0;
+}
+
+} // namespace tflite
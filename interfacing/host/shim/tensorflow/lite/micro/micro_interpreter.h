@@ -0,0 +1,49 @@
+#ifndef HOST_TFLITE_MICRO_INTERPRETER_H
+#define HOST_TFLITE_MICRO_INTERPRETER_H
+
+// Host reference interpreter with the MicroInterpreter interface. Runs the
+// first subgraph of a model with the kernels in micro_mutable_op_resolver.h,
+// int8 and float32. Requantization is done in float rather than with TFLM's
+// fixed-point multipliers, so int8 outputs can differ by one step.
+// Tensor metadata and activations are carved from the arena, as on device.
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/micro/micro_op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite
+{
+
+class MicroInterpreter
+{
+public:
+    MicroInterpreter(const Model* model, const MicroOpResolver& opResolver, uint8_t* tensorArena,
+                     size_t tensorArenaSize, void* resourceVariables = nullptr, void* profiler = nullptr);
+
+    TfLiteStatus AllocateTensors();
+    TfLiteStatus Invoke();
+
+    TfLiteTensor* input(size_t index);
+    TfLiteTensor* output(size_t index);
+    size_t inputs_size() const;
+    size_t outputs_size() const;
+    size_t arena_used_bytes() const { return arenaUsed; }
+
+private:
+    const Model* model;
+    const MicroOpResolver& opResolver;
+    uint8_t* arena;
+    size_t arenaSize;
+    size_t arenaUsed;
+    const SubGraph* subgraph;
+    TfLiteTensor* tensors;
+    bool allocated;
+
+    void* arenaAlloc(size_t bytes);
+    TfLiteStatus fullyConnected(const Operator* op);
+    TfLiteStatus logistic(const Operator* op);
+};
+
+} // namespace tflite
+
+#endif // HOST_TFLITE_MICRO_INTERPRETER_H
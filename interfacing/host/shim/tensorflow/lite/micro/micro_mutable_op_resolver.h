@@ -0,0 +1,53 @@
+#ifndef HOST_TFLITE_MICRO_MUTABLE_OP_RESOLVER_H
+#define HOST_TFLITE_MICRO_MUTABLE_OP_RESOLVER_H
+
+#include "tensorflow/lite/micro/micro_op_resolver.h"
+
+namespace tflite
+{
+
+// Only the kernels the host interpreter implements can be added
+template <unsigned int tOpCount>
+class MicroMutableOpResolver : public MicroOpResolver
+{
+public:
+    MicroMutableOpResolver() : count(0) {}
+
+    TfLiteStatus AddFullyConnected() { return add(BuiltinOperator_FULLY_CONNECTED); }
+    TfLiteStatus AddLogistic() { return add(BuiltinOperator_LOGISTIC); }
+    TfLiteStatus AddRelu() { return add(BuiltinOperator_RELU); }
+
+    bool HasBuiltin(BuiltinOperator op) const
+    {
+        for (unsigned int i = 0; i < count; i++)
+        {
+            if (ops[i] == op)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    BuiltinOperator ops[tOpCount];
+    unsigned int count;
+
+    TfLiteStatus add(BuiltinOperator op)
+    {
+        if (HasBuiltin(op))
+        {
+            return kTfLiteOk;
+        }
+        if (count >= tOpCount)
+        {
+            return kTfLiteError;
+        }
+        ops[count++] = op;
+        return kTfLiteOk;
+    }
+};
+
+} // namespace tflite
+
+#endif // HOST_TFLITE_MICRO_MUTABLE_OP_RESOLVER_H
@@ -0,0 +1,20 @@
+#ifndef HOST_TFLITE_MICRO_OP_RESOLVER_H
+#define HOST_TFLITE_MICRO_OP_RESOLVER_H
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite
+{
+
+// Which builtin operators a model may use
+class MicroOpResolver
+{
+public:
+    virtual ~MicroOpResolver() {}
+    virtual bool HasBuiltin(BuiltinOperator op) const = 0;
+};
+
+} // namespace tflite
+
+#endif // HOST_TFLITE_MICRO_OP_RESOLVER_H
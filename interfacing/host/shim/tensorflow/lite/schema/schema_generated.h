@@ -0,0 +1,212 @@
+#ifndef HOST_TFLITE_SCHEMA_GENERATED_H
+#define HOST_TFLITE_SCHEMA_GENERATED_H
+
+// Read-only accessors for the TFLite flatbuffer schema, written by hand for
+// the fields the host interpreter needs. Same layout and names as the
+// flatc-generated header; little-endian host assumed.
+
+#include <stdint.h>
+#include <string.h>
+
+#define TFLITE_SCHEMA_VERSION 3
+
+namespace flatbuffers
+{
+
+typedef uint32_t uoffset_t;
+typedef int32_t soffset_t;
+typedef uint16_t voffset_t;
+
+template <typename T>
+inline T ReadScalar(const void* p)
+{
+    T value;
+    memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+template <typename T>
+inline void WriteScalar(void* p, T value)
+{
+    memcpy(p, &value, sizeof(T));
+}
+
+// Scalars are stored inline, tables behind an offset
+template <typename T>
+struct IndirectHelper
+{
+    typedef T return_type;
+    static const size_t element_stride = sizeof(T);
+    static T Read(const uint8_t* p, uoffset_t i) { return ReadScalar<T>(p + i * sizeof(T)); }
+};
+
+template <typename T>
+struct IndirectHelper<const T*>
+{
+    typedef const T* return_type;
+    static const size_t element_stride = sizeof(uoffset_t);
+    static const T* Read(const uint8_t* p, uoffset_t i)
+    {
+        p += i * sizeof(uoffset_t);
+        return reinterpret_cast<const T*>(p + ReadScalar<uoffset_t>(p));
+    }
+};
+
+template <typename T>
+class Vector
+{
+public:
+    uoffset_t size() const { return ReadScalar<uoffset_t>(this); }
+    typename IndirectHelper<T>::return_type Get(uoffset_t i) const { return IndirectHelper<T>::Read(Data(), i); }
+    const uint8_t* Data() const { return reinterpret_cast<const uint8_t*>(this) + sizeof(uoffset_t); }
+    const T* data() const { return reinterpret_cast<const T*>(Data()); }
+    void Mutate(uoffset_t i, const T& value) { WriteScalar(const_cast<uint8_t*>(Data()) + i * sizeof(T), value); }
+};
+
+class String : public Vector<char>
+{
+public:
+    const char* c_str() const { return reinterpret_cast<const char*>(Data()); }
+};
+
+class Table
+{
+public:
+    voffset_t GetOptionalFieldOffset(voffset_t field) const
+    {
+        const uint8_t* vtable = base() - ReadScalar<soffset_t>(base());
+        voffset_t vtableSize = ReadScalar<voffset_t>(vtable);
+        return field < vtableSize ? ReadScalar<voffset_t>(vtable + field) : 0;
+    }
+
+    template <typename T>
+    T GetField(voffset_t field, T defaultValue) const
+    {
+        voffset_t offset = GetOptionalFieldOffset(field);
+        return offset != 0 ? ReadScalar<T>(base() + offset) : defaultValue;
+    }
+
+    template <typename P>
+    P GetPointer(voffset_t field) const
+    {
+        voffset_t offset = GetOptionalFieldOffset(field);
+        if (offset == 0)
+        {
+            return nullptr;
+        }
+        const uint8_t* p = base() + offset;
+        return reinterpret_cast<P>(p + ReadScalar<uoffset_t>(p));
+    }
+
+private:
+    const uint8_t* base() const { return reinterpret_cast<const uint8_t*>(this); }
+};
+
+} // namespace flatbuffers
+
+namespace tflite
+{
+
+enum TensorType
+{
+    TensorType_FLOAT32 = 0,
+    TensorType_INT32 = 2,
+    TensorType_UINT8 = 3,
+    TensorType_INT64 = 4,
+    TensorType_INT16 = 7,
+    TensorType_INT8 = 9
+};
+
+enum BuiltinOperator
+{
+    BuiltinOperator_FULLY_CONNECTED = 9,
+    BuiltinOperator_LOGISTIC = 14,
+    BuiltinOperator_RELU = 19
+};
+
+enum ActivationFunctionType
+{
+    ActivationFunctionType_NONE = 0,
+    ActivationFunctionType_RELU = 1,
+    ActivationFunctionType_RELU_N1_TO_1 = 2,
+    ActivationFunctionType_RELU6 = 3
+};
+
+class QuantizationParameters : public flatbuffers::Table
+{
+public:
+    const flatbuffers::Vector<float>* scale() const { return GetPointer<const flatbuffers::Vector<float>*>(8); }
+    const flatbuffers::Vector<int64_t>* zero_point() const { return GetPointer<const flatbuffers::Vector<int64_t>*>(10); }
+};
+
+class Tensor : public flatbuffers::Table
+{
+public:
+    const flatbuffers::Vector<int32_t>* shape() const { return GetPointer<const flatbuffers::Vector<int32_t>*>(4); }
+    TensorType type() const { return (TensorType)GetField<int8_t>(6, 0); }
+    uint32_t buffer() const { return GetField<uint32_t>(8, 0); }
+    const flatbuffers::String* name() const { return GetPointer<const flatbuffers::String*>(10); }
+    const QuantizationParameters* quantization() const { return GetPointer<const QuantizationParameters*>(12); }
+    const flatbuffers::Vector<int32_t>* shape_signature() const { return GetPointer<const flatbuffers::Vector<int32_t>*>(18); }
+};
+
+class FullyConnectedOptions : public flatbuffers::Table
+{
+public:
+    ActivationFunctionType fused_activation_function() const { return (ActivationFunctionType)GetField<int8_t>(4, 0); }
+    bool keep_num_dims() const { return GetField<uint8_t>(8, 0) != 0; }
+};
+
+class Operator : public flatbuffers::Table
+{
+public:
+    uint32_t opcode_index() const { return GetField<uint32_t>(4, 0); }
+    const flatbuffers::Vector<int32_t>* inputs() const { return GetPointer<const flatbuffers::Vector<int32_t>*>(6); }
+    const flatbuffers::Vector<int32_t>* outputs() const { return GetPointer<const flatbuffers::Vector<int32_t>*>(8); }
+    const void* builtin_options() const { return GetPointer<const void*>(12); }
+    const FullyConnectedOptions* builtin_options_as_FullyConnectedOptions() const
+    {
+        return reinterpret_cast<const FullyConnectedOptions*>(builtin_options());
+    }
+};
+
+class OperatorCode : public flatbuffers::Table
+{
+public:
+    int8_t deprecated_builtin_code() const { return GetField<int8_t>(4, 0); }
+    BuiltinOperator builtin_code() const { return (BuiltinOperator)GetField<int32_t>(10, 0); }
+};
+
+class SubGraph : public flatbuffers::Table
+{
+public:
+    const flatbuffers::Vector<const Tensor*>* tensors() const { return GetPointer<const flatbuffers::Vector<const Tensor*>*>(4); }
+    const flatbuffers::Vector<int32_t>* inputs() const { return GetPointer<const flatbuffers::Vector<int32_t>*>(6); }
+    const flatbuffers::Vector<int32_t>* outputs() const { return GetPointer<const flatbuffers::Vector<int32_t>*>(8); }
+    const flatbuffers::Vector<const Operator*>* operators() const { return GetPointer<const flatbuffers::Vector<const Operator*>*>(10); }
+};
+
+class Buffer : public flatbuffers::Table
+{
+public:
+    const flatbuffers::Vector<uint8_t>* data() const { return GetPointer<const flatbuffers::Vector<uint8_t>*>(4); }
+};
+
+class Model : public flatbuffers::Table
+{
+public:
+    uint32_t version() const { return GetField<uint32_t>(4, 0); }
+    const flatbuffers::Vector<const OperatorCode*>* operator_codes() const { return GetPointer<const flatbuffers::Vector<const OperatorCode*>*>(6); }
+    const flatbuffers::Vector<const SubGraph*>* subgraphs() const { return GetPointer<const flatbuffers::Vector<const SubGraph*>*>(8); }
+    const flatbuffers::Vector<const Buffer*>* buffers() const { return GetPointer<const flatbuffers::Vector<const Buffer*>*>(12); }
+};
+
+inline const Model* GetModel(const void* buffer)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(buffer);
+    return reinterpret_cast<const Model*>(p + flatbuffers::ReadScalar<flatbuffers::uoffset_t>(p));
+}
+
+} // namespace tflite
+
+#endif // HOST_TFLITE_SCHEMA_GENERATED_H
@@ -0,0 +1,2 @@
+// The sketch itself, compiled as C++ the way arduino-cli does it
+#include "../interfacing.ino"
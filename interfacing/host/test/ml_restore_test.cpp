@@ -0,0 +1,175 @@
+#include <Arduino.h>
+#include <esp_system.h>
+#include <filesystem>
+#include "HostSim.h"
+#include "../src/APP_Cfg.h"
+#include "../src/App/SensorBus/SensorBus.h"
+#include "../src/App/SoilMoisture/SoilMoisture.h"
+#include "../src/App/DHT/DHT11.h"
+#include "../src/App/ZoneManager/ZoneManager.h"
+#include "../src/App/ML/ML.h"
+
+// ML history persisted across a reset. A copy is only taken over when its
+// age is known from a clock that survived the reset and is at most
+// ML_RESTORE_MAX_GAP_STEPS; the first update then fills the steps the node
+// was down. A reset is ML_Init() again with a watchdog reset reason; the RTC
+// copy lives on in the process like RTC memory does on the chip.
+//
+// Exits non-zero on the first failed check.
+
+#define TEST_UTC_S          1700000000UL
+#define TEST_MOISTURE_START 10      // percent, rises TEST_MOISTURE_STEP per history step
+#define TEST_MOISTURE_STEP  10      // multiples of 10 % are whole ADC counts
+
+#define CHECK(cond)                                                             \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return false;                                                       \
+        }                                                                       \
+    } while (0)
+
+extern SensorHistory history[ZONE_COUNT];
+
+static const uint8_t moisturePins[] = ZONE_MOISTURE_PINS;
+static uint8_t moisturePercent = TEST_MOISTURE_START;
+
+static float scaled(uint8_t percent)
+{
+    return ML_MOISTURE_MIN + (float)percent * (ML_MOISTURE_MAX - ML_MOISTURE_MIN) / 100.0f;
+}
+
+// Probe at the current moisture, one history step, then the clock moves on a step
+static void historyStep(void)
+{
+    uint16_t raw = (uint16_t)(DRY_VALUE + (int32_t)moisturePercent * (WET_VALUE - DRY_VALUE) / 100);
+    for (uint8_t pin : moisturePins)
+    {
+        HostSim_SetAnalog(pin, raw);
+    }
+    SoilMoisture_main();
+    DHT11_main();
+    ML_UpdateHistory();
+    HostSim_AdvanceClock(SCHED_ML_HISTORY_PERIOD_MS);
+    moisturePercent += TEST_MOISTURE_STEP;
+}
+
+// Fresh history on a running node: a reset that keeps nothing, then a full
+// window. A power-on clears RTC memory on the chip; here the copies an
+// earlier case left are made too old instead.
+static void fillWindow(void)
+{
+    HostSim_AdvanceClock((ML_RESTORE_MAX_GAP_STEPS + 1) * SCHED_ML_HISTORY_PERIOD_MS);
+    HostSim_SetResetReason(ESP_RST_POWERON);
+    moisturePercent = TEST_MOISTURE_START;
+    ML_Init();
+    for (uint8_t i = 0; i < HISTORY_SIZE; i++)
+    {
+        historyStep();
+    }
+}
+
+// Reset after the node was down downSteps history steps past the next one
+static void resetAfter(uint32_t downSteps)
+{
+    HostSim_AdvanceClock(downSteps * SCHED_ML_HISTORY_PERIOD_MS);
+    moisturePercent += downSteps * TEST_MOISTURE_STEP;
+    HostSim_SetResetReason(ESP_RST_TASK_WDT);
+    ML_Init();
+}
+
+static uint8_t decidedZones(void)
+{
+    Decision_t decisions[ZONE_COUNT];
+    bool decided[ZONE_COUNT];
+    return ML_DecideZones(decisions, decided);
+}
+
+// Back within a step: the window is taken over and decides at once
+static bool testRecent(void)
+{
+    fillWindow();
+    resetAfter(0);
+
+    CHECK(history[0].isReady());
+    CHECK(decidedZones() == ZONE_COUNT);
+    return true;
+}
+
+// Down for hours: both copies are discarded, no decision on the old trend
+static bool testStale(void)
+{
+    fillWindow();
+    resetAfter(ML_RESTORE_MAX_GAP_STEPS + 1);
+
+    CHECK(!history[0].isReady());
+    CHECK(decidedZones() == 0);
+    return true;
+}
+
+// No synced clock after the reset: the copy's age is unknown, so it is discarded
+static bool testUnknownAge(void)
+{
+    fillWindow();
+    HostSim_SetTime(0);
+    resetAfter(0);
+    HostSim_SetTime(TEST_UTC_S);
+
+    CHECK(!history[0].isReady());
+    return true;
+}
+
+// Down two steps: the first update fills them in, so the window holds the
+// moisture the probe went through and not two steps squeezed into one
+static bool testGapFilled(void)
+{
+    fillWindow();
+    resetAfter(2);
+    historyStep();
+
+    uint8_t newest = moisturePercent - TEST_MOISTURE_STEP;
+    for (uint16_t ago = 0; ago < HISTORY_SIZE; ago++)
+    {
+        float expected = scaled(newest - ago * TEST_MOISTURE_STEP);
+        CHECK(fabsf(history[0].getMoisture(ago) - expected) < 0.5f);
+    }
+    return true;
+}
+
+int main(void)
+{
+    std::filesystem::remove_all("host_fs_ml_restore_test");
+    HostSim_SetFsRoot("host_fs_ml_restore_test");
+    HostSim_SetSteppedClock();
+    HostSim_SetTime(TEST_UTC_S);
+    HostSim_SetAdcContinuous(false);
+    HostSim_SetSerialOutput(false);
+    HostSim_SetDht(24.0f, 55.0f);
+
+    SensorBus_Init();
+    SoilMoisture_Init();
+    DHT11_init();
+    ZoneManager_Init();
+
+    static const struct
+    {
+        const char* name;
+        bool (*run)(void);
+    } tests[] = {
+        {"recent", testRecent},
+        {"stale", testStale},
+        {"unknown_age", testUnknownAge},
+        {"gap_filled", testGapFilled},
+    };
+
+    int failed = 0;
+    for (const auto& test : tests)
+    {
+        bool ok = test.run();
+        printf("%-14s %s\n", test.name, ok ? "ok" : "FAILED");
+        failed += !ok;
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+#include <Arduino.h>
+#include <filesystem>
+#include "HostSim.h"
+#include "../src/APP_Cfg.h"
+#include "../src/App/OfflineLog/OfflineLog.h"
+#include "../src/App/MQTT_APP/mqtt_app.h"
+#include "../src/Hal/MQTT/mqtt_core.h"
+#include "../src/Hal/WIFI/wifi.h"
+
+// Offline log replay across resets. Records go out at QoS 1, and the replay
+// position is kept on flash once the broker has acknowledged them, so a
+// reset neither loses the backlog nor sends its head again. A reset is
+// OfflineLog_Init() again; the broker stays connected.
+//
+// Exits non-zero on the first failed check.
+
+#define TEST_UTC_S          1700000000UL
+#define TEST_RECORDS        12
+
+#define CHECK(cond)                                                             \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return false;                                                       \
+        }                                                                       \
+    } while (0)
+
+// Seen by the broker: replays of each record, and of them any not at QoS 1
+static uint8_t replayed[TEST_RECORDS];
+static uint32_t replayedBelowQos1 = 0;
+
+static void onPublish(const char* topic, const uint8_t* payload, size_t length, uint8_t qos, bool retain)
+{
+    (void)retain;
+    if (strcmp(topic, MQTT_TOPIC_TELEMETRY "/replay") != 0)
+    {
+        return;
+    }
+
+    std::string text((const char*)payload, length);
+    int index = -1;
+    if (sscanf(text.c_str(), "{\"i\":%d", &index) == 1 && index >= 0 && index < TEST_RECORDS)
+    {
+        replayed[index]++;
+    }
+    replayedBelowQos1 += qos < 1;
+}
+
+// Run the network lane until the outbox and the QoS 1 window are empty
+static void flush(void)
+{
+    for (int i = 0; i < 100 && MQTT_OutboxPending() > 0; i++)
+    {
+        mqtt_net_main();
+    }
+}
+
+static uint32_t countReplayed(uint32_t from, uint32_t to, uint8_t times)
+{
+    uint32_t count = 0;
+    for (uint32_t i = from; i < to; i++)
+    {
+        count += replayed[i] == times;
+    }
+    return count;
+}
+
+// Part of the backlog replayed and acknowledged: all of it at QoS 1
+static bool testQos1(void)
+{
+    CHECK(OfflineLog_Drain(5) == 5);
+    flush();
+
+    CHECK(countReplayed(0, 5, 1) == 5);
+    CHECK(countReplayed(5, TEST_RECORDS, 0) == TEST_RECORDS - 5);
+    CHECK(replayedBelowQos1 == 0);
+    return true;
+}
+
+// Reset after those were acknowledged: the replay resumes after them
+static bool testResume(void)
+{
+    OfflineLog_Sync();
+    OfflineLog_Init();
+
+    while (OfflineLog_Drain(OFFLINE_LOG_DRAIN_BATCH) > 0)
+    {
+        flush();
+    }
+    flush();
+
+    CHECK(countReplayed(0, TEST_RECORDS, 1) == TEST_RECORDS);
+    CHECK(replayedBelowQos1 == 0);
+    return true;
+}
+
+// Reset once everything was acknowledged: nothing is left to replay
+static bool testDrained(void)
+{
+    OfflineLog_Drain(OFFLINE_LOG_DRAIN_BATCH);
+    OfflineLog_Init();
+
+    CHECK(OfflineLog_PendingBytes() == 0);
+    CHECK(OfflineLog_Drain(OFFLINE_LOG_DRAIN_BATCH) == 0);
+    CHECK(countReplayed(0, TEST_RECORDS, 1) == TEST_RECORDS);
+    return true;
+}
+
+int main(void)
+{
+    std::filesystem::remove_all("host_fs_offline_log_test");
+    HostSim_SetFsRoot("host_fs_offline_log_test");
+    HostSim_SetSteppedClock();
+    HostSim_SetTime(TEST_UTC_S);
+    HostSim_SetSerialOutput(false);
+    HostSim_SetPublishHook(onPublish);
+
+    // A backlog stored while the link was down, then a session with the broker
+    OfflineLog_Init();
+    for (int i = 0; i < TEST_RECORDS; i++)
+    {
+        char payload[16];
+        int length = snprintf(payload, sizeof(payload), "{\"i\":%d}", i);
+        OfflineLog_Append(OFFLINE_LOG_TELEMETRY, (const uint8_t*)payload, (uint16_t)length, false, 0);
+    }
+    MQTT_APP_Setup();
+    for (int i = 0; i < 500 && !MQTT_IsConnected(); i++)
+    {
+        wifi_loop();
+        mqtt_net_main();
+        delay(SCHED_MQTT_NET_PERIOD_MS);
+    }
+    if (!MQTT_IsConnected())
+    {
+        fprintf(stderr, "offline_log_test: no MQTT session\n");
+        return 1;
+    }
+    flush();
+
+    static const struct
+    {
+        const char* name;
+        bool (*run)(void);
+    } tests[] = {
+        {"qos1", testQos1},
+        {"resume", testResume},
+        {"drained", testDrained},
+    };
+
+    int failed = 0;
+    for (const auto& test : tests)
+    {
+        bool ok = test.run();
+        printf("%-14s %s\n", test.name, ok ? "ok" : "FAILED");
+        failed += !ok;
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+#include <Arduino.h>
+#include <filesystem>
+#include "HostSim.h"
+#include "../src/APP_Cfg.h"
+#include "../src/App/SensorBus/SensorBus.h"
+#include "../src/App/SoilMoisture/SoilMoisture.h"
+#include "../src/App/DHT/DHT11.h"
+#include "../src/App/ZoneManager/ZoneManager.h"
+#include "../src/App/OfflineLog/OfflineLog.h"
+#include "../src/App/ML/ML.h"
+#include "../src/App/Power/Power.h"
+
+// Light-sleep duty cycle with a zone watering when the wake ends. Outputs
+// do not hold through sleep, so every output has to be off by then, and
+// the zone has to have watered up to ZONE_MAX_RUN_S or until its probe
+// read wet, whichever came first.
+//
+// Built against the firmware with POWER_MODE_LIGHT_SLEEP; exits non-zero
+// on the first failed check.
+
+#if POWER_MODE != POWER_MODE_LIGHT_SLEEP
+#error "power_test needs the firmware built with POWER_MODE_LIGHT_SLEEP"
+#endif
+
+#define TEST_DRY_PERCENT    20
+#define TEST_WET_PERCENT    90
+#define TEST_NEVER          UINT32_MAX
+
+#define CHECK(cond)                                                             \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return false;                                                       \
+        }                                                                       \
+    } while (0)
+
+static const uint8_t moisturePins[] = ZONE_MOISTURE_PINS;
+
+// Set by the scenario
+static uint32_t wetAtMs = TEST_NEVER;
+
+// Seen by the hooks
+static uint32_t wateredMs = 0;      // zone 0 on, summed over clock steps
+static uint32_t lastClockMs = 0;
+static uint32_t sleeps = 0;
+static uint32_t sleptAtMs = 0;
+static uint8_t zonesOnAtSleep = 0;
+
+static void setProbes(uint8_t percent)
+{
+    uint16_t raw = (uint16_t)(DRY_VALUE + (int32_t)percent * (WET_VALUE - DRY_VALUE) / 100);
+    for (uint8_t pin : moisturePins)
+    {
+        HostSim_SetAnalog(pin, raw);
+    }
+}
+
+static void onClock(uint32_t nowMs)
+{
+    if (ZoneManager_IsWatering(0))
+    {
+        wateredMs += nowMs - lastClockMs;
+    }
+    lastClockMs = nowMs;
+    if (nowMs >= wetAtMs)
+    {
+        setProbes(TEST_WET_PERCENT);
+    }
+}
+
+static void onSleep(uint64_t timerUs, bool deep)
+{
+    (void)timerUs;
+    (void)deep;
+    sleeps++;
+    sleptAtMs = millis();
+    zonesOnAtSleep = 0;
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        zonesOnAtSleep += ZoneManager_IsWatering(zone);
+    }
+}
+
+// One wake with zone 0 forced on; the probes start at startPercent and read
+// wet wetAfterS into the wake. Returns the awake time in ms.
+static uint32_t runCycle(uint8_t startPercent, uint32_t wetAfterS)
+{
+    setProbes(startPercent);
+    ZoneManager_SetOverride(0, ZONE_OVERRIDE_ON);
+
+    uint32_t startMs = millis();
+    lastClockMs = startMs;
+    wateredMs = 0;
+    sleeps = 0;
+    wetAtMs = wetAfterS == TEST_NEVER ? TEST_NEVER : startMs + wetAfterS * 1000;
+
+    Power_RunCycle();
+    wetAtMs = TEST_NEVER;
+    return sleptAtMs - startMs;
+}
+
+// Soil stays dry: the zone waters for ZONE_MAX_RUN_S and is off at sleep
+static bool testStaysDry(void)
+{
+    uint32_t awakeMs = runCycle(TEST_DRY_PERCENT, TEST_NEVER);
+
+    CHECK(sleeps == 1);
+    CHECK(zonesOnAtSleep == 0);
+    CHECK(wateredMs >= ZONE_MAX_RUN_S * 1000UL);
+    CHECK(awakeMs >= ZONE_MAX_RUN_S * 1000UL);
+    CHECK(!ZoneManager_AnyWatering());
+    return true;
+}
+
+// Probe reads wet two minutes into the wake: the zone, on since the
+// sampling rounds, stops then and not at ZONE_MAX_RUN_S
+static bool testStopsOnWet(void)
+{
+    uint32_t awakeMs = runCycle(TEST_DRY_PERCENT, 120);
+
+    CHECK(sleeps == 1);
+    CHECK(zonesOnAtSleep == 0);
+    CHECK(wateredMs >= 110000UL);
+    CHECK(wateredMs < 180000UL);
+    CHECK(awakeMs < ZONE_MAX_RUN_S * 1000UL);
+    return true;
+}
+
+// Wet from the start: the zone never turns on
+static bool testAlreadyWet(void)
+{
+    runCycle(TEST_WET_PERCENT, TEST_NEVER);
+
+    CHECK(sleeps == 1);
+    CHECK(zonesOnAtSleep == 0);
+    CHECK(wateredMs == 0);
+    return true;
+}
+
+int main(void)
+{
+    std::filesystem::remove_all("host_fs_power_test");
+    HostSim_SetFsRoot("host_fs_power_test");
+    HostSim_SetSteppedClock();
+    HostSim_SetAdcContinuous(false);
+    HostSim_SetSerialOutput(false);
+    HostSim_SetLink(false);
+    HostSim_SetDht(24.0f, 55.0f);
+    HostSim_SetClockHook(onClock);
+    HostSim_SetSleepHook(onSleep);
+
+    SensorBus_Init();
+    SoilMoisture_Init();
+    DHT11_init();
+    ZoneManager_Init();
+    if (!ML_Init())
+    {
+        fprintf(stderr, "power_test: ML_Init failed\n");
+        return 1;
+    }
+    OfflineLog_Init();
+    Power_Init();
+
+    static const struct
+    {
+        const char* name;
+        bool (*run)(void);
+    } tests[] = {
+        {"stays_dry", testStaysDry},
+        {"stops_on_wet", testStopsOnWet},
+        {"already_wet", testAlreadyWet},
+    };
+
+    int failed = 0;
+    for (const auto& test : tests)
+    {
+        bool ok = test.run();
+        printf("%-14s %s\n", test.name, ok ? "ok" : "FAILED");
+        failed += !ok;
+    }
+    return failed > 0 ? 1 : 0;
+}
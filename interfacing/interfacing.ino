@@ -1,176 +1,117 @@
-/*#include <Arduino.h>
+#include <Arduino.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include "src/Hal/WIFI/wifi.h"
 #include "src/App/MQTT_APP/mqtt_app.h"
+#include "src/App/SensorBus/SensorBus.h"
 #include "src/App/SoilMoisture/SoilMoisture.h"
 #include "src/App/DHT/DHT11.h"
 #include "src/App/ML/ML.h"
+#include "src/App/Scheduler/Scheduler.h"
+#include "src/App/Power/Power.h"
+#include "src/App/ZoneManager/ZoneManager.h"
+#include "src/App/OfflineLog/OfflineLog.h"
+#include "src/App/Bench/Bench.h"
+#include "src/App/Perf/Perf.h"
 
-// ============================================================================
-// APP TASK CONFIGURATION
-// ============================================================================
-
-// Uncomment the line below to enable MQTT testing
-
-=======
-#define APP_TASK_CORE 0
-#define APP_TASK_PRIORITY 3  // Higher than MQTT (2)
-#define APP_TASK_STACK_SIZE 3072
-
-// RTOS task handles
-static TaskHandle_t appTaskHandle = NULL;
-static TaskHandle_t mqttTaskHandle = NULL;
-static TaskHandle_t mlTaskHandle = NULL;
+// Job ids, kept for stats and period changes
+static int8_t wifiJobId = -1;
 
 // ============================================================================
-// APP TASK FUNCTION
+// JOBS
 // ============================================================================
-static void appTask100ms(void* parameter)
+static void wifiJob(void)
 {
-    Serial.println("appTask100ms started on core: " + String(xPortGetCoreID()));
-
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    const TickType_t xFrequency = pdMS_TO_TICKS(100); // 100ms cycle
-
-    for(;;)
-    {
-        // Call WiFi loop
-        wifi_loop();
-
-        // Debug: Print WiFi status every second
-        static TickType_t lastDebugTime = 0;
-        TickType_t currentTick = xTaskGetTickCount();
-        if ((currentTick - lastDebugTime) >= pdMS_TO_TICKS(1000)) {
-            Serial.println("appTask100ms: WiFi status check - Connected: " + String(WIFI_IsConnected() ? "YES" : "NO"));
-            lastDebugTime = currentTick;
-        }
-
-        // Delay for next iteration
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
-    }
+    wifi_loop();
+
+    // Poll fast only while the connection state machine is running
+    Sched_SetPeriod(wifiJobId, WIFI_IsConnected() ? SCHED_WIFI_IDLE_PERIOD_MS : SCHED_WIFI_PERIOD_MS);
 }
 
-// ============================================================================
-// MQTT TASK FUNCTION
-// ============================================================================
-static void apptask_400ms(void* parameter)
+static void sensorJob(void)
 {
-    Serial.println("apptask_400ms started on core: " + String(xPortGetCoreID()));
-
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    const TickType_t xFrequency = pdMS_TO_TICKS(400); // 400ms cycle
-
-    for(;;)
-    {
-        // Call sensor mains
-        SoilMoisture_main();
-        DHT11_main();
-
-        // Call MQTT main
-        mqtt_main();
-
-        // Delay for next iteration
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
-    }
+    SoilMoisture_main();
+    DHT11_main();
 }
 
-
 // ============================================================================
-// ML TASK FUNCTION (30-second interval)
+// JOB TABLE
 // ============================================================================
-static void mlTask30s(void* parameter)
-{
-    Serial.println("mlTask30s started on core: " + String(xPortGetCoreID()));
-
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    const TickType_t xFrequency = pdMS_TO_TICKS(30000); // 30 seconds
-
-    for(;;)
-    {
-        // Process ML inference and decision
-        ML_ProcessDecision();
-
-        // Delay for next iteration
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
-    }
-}
+//  lane, {name, run, periodMs, deadlineMs, events}
+static const struct {
+    Sched_Lane_t lane;
+    Sched_JobCfg_t cfg;
+} jobTable[] = {
+    {SCHED_LANE_NET, {"wifi",       wifiJob,            SCHED_WIFI_PERIOD_MS,       SCHED_WIFI_PERIOD_MS,   SCHED_EVT_NONE}},
+    {SCHED_LANE_NET, {"mqttNet",    mqtt_net_main,      SCHED_MQTT_NET_PERIOD_MS,   SCHED_MQTT_NET_PERIOD_MS, SCHED_EVT_OUTBOX | SCHED_EVT_LINK_UP | SCHED_EVT_LINK_DOWN}},
+    {SCHED_LANE_IO,  {"sensors",    sensorJob,          SCHED_SENSOR_PERIOD_MS,     SCHED_SENSOR_PERIOD_MS, SCHED_EVT_NONE}},
+    {SCHED_LANE_IO,  {"mqtt",       mqtt_main,          SCHED_MQTT_PERIOD_MS,       SCHED_MQTT_PERIOD_MS,   SCHED_EVT_LINK_UP}},
+    {SCHED_LANE_IO,  {"zones",      ZoneManager_main,   SCHED_ZONE_PERIOD_MS,       SCHED_ZONE_PERIOD_MS,   SCHED_EVT_ZONE_DEMAND}},
+    {SCHED_LANE_ML,  {"mlHistory",  ML_UpdateHistory,   SCHED_ML_HISTORY_PERIOD_MS, SCHED_ML_DEADLINE_MS,   SCHED_EVT_NONE}},
+    {SCHED_LANE_ML,  {"mlDecision", ML_RunDecision,     0,                          SCHED_ML_DEADLINE_MS,   SCHED_EVT_HISTORY_READY | SCHED_EVT_THRESHOLD}},
+#if PERF_ENABLED == STD_ON
+    {SCHED_LANE_IO,  {"perf",       Perf_main,          PERF_REPORT_STEP_MS,        0,                      SCHED_EVT_NONE}},
+#endif
+};
 
 // ============================================================================
 // SETUP
 // ============================================================================
 void setup() {
-<<<<<<< HEAD
-  
-=======
   Serial.begin(115200);
   delay(1000);
-  // TODO: Add your application initialization here
+
+#if BENCH_ENABLED == STD_ON
+  Bench_Run();
+#endif
+
+#if PERF_ENABLED == STD_ON
+  Perf_Init();
+#endif
 
   // Initialize sensors
+  SensorBus_Init();
   SoilMoisture_Init();
   DHT11_init();
 
+  // Every zone output starts off
+  ZoneManager_Init();
+
   // Initialize ML model
   if (!ML_Init()) {
     Serial.println("ERROR: Failed to initialize ML model!");
   }
 
-  // Initialize MQTT APP
-  MQTT_APP_Setup();
+  // Telemetry and decisions produced while the link is down wait here
+  OfflineLog_Init();
 
-  // Create appTask100ms on Core 0
-  Serial.println("Creating appTask100ms...");
-  BaseType_t taskCreated = xTaskCreatePinnedToCore(
-    appTask100ms,              // Task function
-    "appTask100ms",            // Task name
-    APP_TASK_STACK_SIZE,       // Stack size
-    NULL,                      // Parameters
-    APP_TASK_PRIORITY,         // Priority (higher than MQTT)
-    appTaskHandle,            // Task handle
-    APP_TASK_CORE              // Core 0
-  );
-
-  if (taskCreated != pdPASS) {
-    Serial.println("ERROR: Failed to create appTask100ms!");
-  } else {
-    Serial.println("appTask100ms created successfully on Core " + String(APP_TASK_CORE));
+#if POWER_MODE != POWER_MODE_ALWAYS_ON
+  // Battery node: sample, decide, transmit when needed and sleep; WiFi is only
+  // brought up inside the cycle
+  Power_Init();
+  for (;;) {
+    Power_RunCycle();
   }
+#endif
 
-  // Create apptask_400ms on Core 1
-  Serial.println("Creating apptask_400ms...");
-  taskCreated = xTaskCreatePinnedToCore(
-    apptask_400ms,             // Task function
-    "apptask_400ms",           // Task name
-    APP_TASK_STACK_SIZE,       // Stack size
-    NULL,                      // Parameters
-    2,                         // Priority (lower than WiFi)
-    mqttTaskHandle,           // Task handle
-    1                          // Core 1
-  );
-
-  if (taskCreated != pdPASS) {
-    Serial.println("ERROR: Failed to create apptask_400ms!");
-  } else {
-    Serial.println("apptask_400ms created successfully on Core 1");
+  // Initialize MQTT APP
+  MQTT_APP_Setup();
+
+  // Register jobs and start the scheduler lanes
+  Sched_Init();
+  for (uint8_t i = 0; i < sizeof(jobTable) / sizeof(jobTable[0]); i++) {
+    int8_t id = Sched_RegisterJob(jobTable[i].lane, &jobTable[i].cfg);
+    if (id < 0) {
+      Serial.println("ERROR: Failed to register job " + String(jobTable[i].cfg.name) + "!");
+    } else if (jobTable[i].cfg.run == wifiJob) {
+      wifiJobId = id;
+    }
   }
 
-  // Create mlTask30s on Core 1
-  Serial.println("Creating mlTask30s...");
-  taskCreated = xTaskCreatePinnedToCore(
-    mlTask30s,                 // Task function
-    "mlTask30s",               // Task name
-    APP_TASK_STACK_SIZE,       // Stack size
-    NULL,                      // Parameters
-    1,                         // Priority (lowest)
-    &mlTaskHandle,             // Task handle
-    1                          // Core 1
-  );
-
-  if (taskCreated != pdPASS) {
-    Serial.println("ERROR: Failed to create mlTask30s!");
+  if (!Sched_Start()) {
+    Serial.println("ERROR: Failed to start scheduler!");
   } else {
-    Serial.println("mlTask30s created successfully on Core 1");
+    Serial.println("Scheduler started");
   }
 }
 
@@ -178,54 +119,6 @@ void setup() {
 // MAIN LOOP
 // ============================================================================
 void loop() {
-  // TODO: Add your application main loop here
-  
-  // Uncomment to test MQTT (requires MQTTTest.h to be included above)
-
-  // MQTT RTOS Test runs automatically in background task
-  // No need to call MQTTTest_Loop() anymore
-
-  // Add a small delay to prevent busy waiting
-  delay(1000);
-
-  // Optional: Add periodic status output or other main loop tasks
-  static unsigned long lastStatusTime = 0;
-  if (millis() - lastStatusTime >= 10000) { // Every 10 seconds
-    Serial.println("Main loop: MQTT RTOS test running in background...");
-    lastStatusTime = millis();
-  }
-}
-
-// ============================================================================
-// CLEANUP (Optional - for testing)
-// ============================================================================
-// Uncomment the function below if you want to test deinitialization
-/*
-void cleanup() {
-  // Stop appTask100ms
-  if (appTaskHandle != NULL) {
-    Serial.println("Stopping appTask100ms...");
-    vTaskDelete(appTaskHandle);
-    appTaskHandle = NULL;
-    Serial.println("appTask100ms stopped");
-  }
-
-  // Stop apptask_400ms
-  if (mqttTaskHandle != NULL) {
-    Serial.println("Stopping apptask_400ms...");
-    vTaskDelete(mqttTaskHandle);
-    mqttTaskHandle = NULL;
-    Serial.println("apptask_400ms stopped");
-  }
-
-  // TODO: Add MQTT_APP_Deinit if needed
-}
-*/
-void setup()
-{
-
-}
-void loop()
-{
-
+  // All work runs in scheduler lanes; drop the Arduino loop task so it never wakes
+  vTaskDelete(NULL);
 }
@@ -9,6 +9,18 @@
 #define _4G    3
 #define Zero 0
 #define ADC_MAX 4095
+#define ADC_MODE_ONESHOT       0   // blocking analogRead() per call
+#define ADC_MODE_CONTINUOUS    1   // DMA scan of all channels, ADC_ReadValue() never blocks
+#define MQTT_PAYLOAD_JSON      0   // JSON text payloads
+#define MQTT_PAYLOAD_BINARY    1   // compact binary payloads on "<topic>/bin" (App/MQTT_APP/mqtt_codec.h)
+#define MQTT_BATCH_OFF         0   // one telemetry message per reading
+#define MQTT_BATCH_SAMPLES     1   // readings sent together on "<telemetry>/batch"
+#define MQTT_BATCH_SUMMARY     2   // min/max/mean per window on "<telemetry>/summary"
+#define MQTT_DROP_NEWEST       0   // full outbox queue refuses the new message
+#define MQTT_DROP_OLDEST       1   // full outbox queue evicts its oldest message
+#define POWER_MODE_ALWAYS_ON   0   // scheduler lanes run permanently
+#define POWER_MODE_LIGHT_SLEEP 1   // duty cycle, light sleep between wakes (RAM kept)
+#define POWER_MODE_DEEP_SLEEP  2   // duty cycle, deep sleep between wakes (RTC memory kept)
 
 
 //Module definitions
@@ -16,7 +28,7 @@
 #define COMMUNICATION_MODULE       WIFI_MODULE
 #define SENSORH_ENABLED            STD_OFF
 #define ADC_ENABLED                STD_ON
-#define POT_ENABLED                STD_ON
+#define POT_ENABLED                STD_OFF  // GPIO34 is zone 1's moisture probe
 #define SOILMOISTURE_ENABLED       STD_ON
 #define LM35_ENABLED               STD_OFF
 #define PWM_ENABLED                STD_OFF
@@ -31,6 +43,7 @@
 #define Phosphorus_ENABLED         STD_ON
 #define Potassium_ENABLED          STD_ON
 #define PH_ENABLED                 STD_ON
+#define OFFLINE_LOG_ENABLED        STD_ON
 //Debug Definitions
 #define GPIO_DEBUG                 STD_OFF
 #define SENSORH_DEBUG              STD_OFF
@@ -50,6 +63,12 @@
 #define Phosphorus_DEBUG           STD_ON
 #define Potassium_DEBUG            STD_ON
 #define PH_DEBUG                   STD_ON
+#define SENSORBUS_DEBUG            STD_OFF
+#define SCHED_DEBUG                STD_OFF
+#define POWER_DEBUG                STD_ON
+#define OFFLINE_LOG_DEBUG          STD_ON
+#define ZONE_DEBUG                 STD_ON
+#define PERF_DEBUG                 STD_OFF
 
 //Pin Configuration
 #define POT_PIN             34
@@ -78,6 +97,24 @@
 #define ADC_MAX_VALUE                    4095 // 12-bit ADC
 #define PUMP_PWM_FREQUENCY                20000 // 20 kHz PWM frequency for pump
 
+//ADC Configuration
+#define ADC_MODE                         ADC_MODE_CONTINUOUS
+#define ADC_MAX_CHANNELS                 8     // ADC1 pins 32-39
+#define ADC_CONT_RESOLUTION              12
+#define ADC_CONT_SAMPLE_FREQ_HZ          20000 // total conversions per second across all channels
+#define ADC_CONT_CONVERSIONS_PER_PIN     32    // averaged by the driver into one DMA frame
+#define ADC_CONT_DECIMATION              16    // DMA frames averaged per published value
+#define ADC_TASK_PRIORITY                2
+#define ADC_TASK_CORE                    1
+#define ADC_TASK_STACK_SIZE              2048
+
+//ADC Filter Configuration: {stages, emaShift, outlierThreshold} (see Hal/ADC/ADC_Filter.h)
+#define SOILMOISTURE_FILTER_CFG  {ADC_FILTER_OUTLIER | ADC_FILTER_MEDIAN | ADC_FILTER_EMA, 3, 400}
+#define Nitrogen_FILTER_CFG      {ADC_FILTER_MEDIAN | ADC_FILTER_AVERAGE, 0, 0}
+#define Phosphorus_FILTER_CFG    {ADC_FILTER_MEDIAN | ADC_FILTER_AVERAGE, 0, 0}
+#define Potassium_FILTER_CFG     {ADC_FILTER_MEDIAN | ADC_FILTER_AVERAGE, 0, 0}
+#define PH_FILTER_CFG            {ADC_FILTER_OUTLIER | ADC_FILTER_MEDIAN | ADC_FILTER_EMA, 4, 300}
+
 //UART1 Configuration
 #define UART1_BAUD_RATE 115200
 #define UART1_TX_PIN    17
@@ -89,46 +126,154 @@
 #define WIFI_PASSWORD              "@MES12345@"
 #define WIFI_RECONNECT_INTERVAL_MS 5000
 #define WIFI_CONNECT_TIMEOUT_MS    15000
+#define NTP_SERVER                 "pool.ntp.org"
 
 //MQTT Configuration
 #define MQTT_BROKER                "10.17.84.102"
 #define MQTT_PORT                   1883
 #define MQTT_USERNAME               ""  // Leave empty "" if no authentication needed
 #define MQTT_PASSWORD               ""  // Leave empty "" if no authentication needed
+#define MQTT_SITE_ID                "site1"
+#define MQTT_NODE_ID                "nodeA"
 #define MQTT_TOPIC_TELEMETRY        "farm/site1/nodeA/telemetry"
 #define MQTT_TOPIC_IRRIGATION_DECISION "farm/site1/nodeA/decision"
 #define MQTT_TOPIC_PUMP_CONTROL     "farm/site1/nodeB/status"
+#define MQTT_TOPIC_PERF             "farm/site1/nodeA/perf"
+#define MQTT_TELEMETRY_INTERVAL_MS  5000
+#define MQTT_TELEMETRY_BATCH        MQTT_BATCH_OFF  // JSON payloads only
+#define MQTT_TELEMETRY_BATCH_SIZE   6     // readings per batch/summary message
+#define MQTT_HEARTBEAT_INTERVAL_MS  5000  // also deferred by each batch; raise it with batching
+#define MQTT_TELEMETRY_DEADBAND     STD_OFF // send a field only when it moved, not with batching
+#define MQTT_DEADBAND_SOIL_MOISTURE         1.0f    // %
+#define MQTT_DEADBAND_TEMPERATURE           1.0f    // C (sent as whole degrees)
+#define MQTT_DEADBAND_HUMIDITY              2.0f    // %
+#define MQTT_MAX_SILENCE_SOIL_MOISTURE_MS   600000  // forced refresh of an unchanged field
+#define MQTT_MAX_SILENCE_TEMPERATURE_MS     600000
+#define MQTT_MAX_SILENCE_HUMIDITY_MS        600000
+#define MQTT_BACKOFF_MIN_MS         1000  // first reconnect wait, doubled per failure
+#define MQTT_BACKOFF_MAX_MS         60000
+#define MQTT_CONNECT_TIMEOUT_MS     500   // TCP connect bound per MQTT_Loop() step
+#define MQTT_SOCKET_TIMEOUT_S       1     // CONNACK / read bound (PubSubClient, whole seconds)
+#define MQTT_KEEPALIVE_S            15
+#define MQTT_OUTBOX_HIGH_DEPTH      4     // decisions, commands, status; power of two
+#define MQTT_OUTBOX_LOW_DEPTH       8     // telemetry, replay; power of two
+#define MQTT_OUTBOX_HIGH_POLICY     MQTT_DROP_OLDEST  // newest decision matters most
+#define MQTT_OUTBOX_LOW_POLICY      MQTT_DROP_NEWEST  // refused telemetry goes to the offline log
+#define MQTT_OUTBOX_TOPIC_MAX       64
+#define MQTT_OUTBOX_PAYLOAD_MAX     512   // offline replay needs OFFLINE_LOG_MAX_PAYLOAD + 20, batches more
+#define MQTT_OUTBOX_BURST           8     // messages sent per MQTT_Loop() step
+#define MQTT_MAX_HANDLERS           16    // registered topics and topic filters
+#define MQTT_HANDLER_TOPIC_MAX      64    // longest handler topic/filter, and incoming topic
+#define MQTT_MAX_PAYLOAD_SIZE       256   // incoming messages above this are dropped
+#define MQTT_QOS_COMMAND            1     // pump commands and decisions
+#define MQTT_QOS1_WINDOW            4     // QoS 1 messages awaiting PUBACK at once
+#define MQTT_QOS1_RETRY_MS          5000  // resend with DUP when no PUBACK by then
+#define MQTT_QOS1_MAX_RETRIES       5
+#define MQTT_CLEAN_SESSION          STD_OFF // broker keeps the session (client id is the MAC) across reconnects
+#define MQTT_PAYLOAD_FORMAT         MQTT_PAYLOAD_JSON   // telemetry, decision and heartbeat
+#define MQTT_BINARY_TOPIC_SUFFIX    "/bin"
+
+
+// Sensor Bus Configuration
+#define SENSORBUS_DEPTH                     16  // readings kept per channel, power of two
+#define SENSORBUS_STALE_MS                  5000  // latest value older than this is reported STALE
+
+// Scheduler Configuration
+#define SCHED_MAX_JOBS                      12
+#define SCHED_NET_CORE                      0
+#define SCHED_NET_PRIORITY                  3     // Higher than IO (2)
+#define SCHED_NET_STACK_SIZE                3072
+#define SCHED_IO_CORE                       1
+#define SCHED_IO_PRIORITY                   2
+#define SCHED_IO_STACK_SIZE                 3072
+#define SCHED_ML_CORE                       1
+#define SCHED_ML_PRIORITY                   1     // Lowest
+#define SCHED_ML_STACK_SIZE                 3072
+#define SCHED_WIFI_PERIOD_MS                100   // while connecting
+#define SCHED_WIFI_IDLE_PERIOD_MS           1000  // link check once connected
+#define SCHED_SENSOR_PERIOD_MS              400
+#define SCHED_MQTT_PERIOD_MS                400
+#define SCHED_MQTT_NET_PERIOD_MS            100   // MQTT_Loop() on the NET lane, also woken by the outbox
+#define SCHED_ZONE_PERIOD_MS                1000  // zone scheduler, also woken by new demand
+#define SCHED_ML_HISTORY_PERIOD_MS          30000 // history step the model was trained on
+#define SCHED_ML_DEADLINE_MS                2000
+
+// Power Configuration
+#ifndef POWER_MODE                          // the host tests build the duty cycle too
+#define POWER_MODE                          POWER_MODE_ALWAYS_ON
+#endif
+#define POWER_WAKE_MIN_S                    60    // fastest wake interval (soil changing fast or dry)
+#define POWER_WAKE_MAX_S                    1800  // slowest wake interval (soil stable)
+#define POWER_WAKE_DEFAULT_S                300
+#define POWER_RATE_FAST                     1.0f  // %/min moisture change that halves the interval
+#define POWER_RATE_SLOW                     0.1f  // %/min moisture change that doubles the interval
+#define POWER_SAMPLE_ROUNDS                 8     // sensor rounds per wake, lets filters and DHT settle
+#define POWER_SAMPLE_SPACING_MS             250
+#define POWER_TELEMETRY_BATCH               6     // records kept before a wake must transmit
+#define POWER_PENDING_MAX                   24    // records kept in RTC memory, oldest dropped
+#define POWER_LINK_TIMEOUT_MS               20000 // WiFi + broker connect budget per transmit
+#define POWER_REPLAY_MAX                    30    // offline log records replayed per transmit
+#define POWER_FLUSH_TIMEOUT_MS              2000  // outbox send budget before the radio goes off
+
+// Offline Log Configuration (LittleFS, see App/OfflineLog)
+#define OFFLINE_LOG_SEGMENT_SIZE            4096  // bytes per segment file
+#define OFFLINE_LOG_SEGMENT_COUNT           32    // segments kept before the oldest is dropped
+#define OFFLINE_LOG_MAX_PAYLOAD             192   // largest stored payload
+#define OFFLINE_LOG_DRAIN_BATCH             5     // records replayed per drain tick
+#define OFFLINE_LOG_DRAIN_INTERVAL_MS       1000  // drain tick while connected
 
+// ML Persistence Configuration
+#define ML_PERSIST_RTC                      STD_ON  // history copy in RTC slow memory
+#define ML_PERSIST_NVS                      STD_ON  // history copy in flash (Preferences)
+#define ML_NVS_SAVE_EVERY                   10      // history steps between flash writes
+#define ML_RESTORE_MAX_GAP_STEPS            64      // history steps a persisted copy may be behind and still be caught up; covers POWER_WAKE_MAX_S
+#define ML_HISTORY_PREFILL                  STD_OFF // copy the first reading over an empty window: flat, zero trend and spread
+#define ML_BATCH_MAX                        ZONE_COUNT  // rows per Invoke of the batched interpreter; every row is computed
+
+// Benchmark Configuration
+#define BENCH_ENABLED                       STD_OFF // run App/Bench from setup()
+#define BENCH_ITERATIONS                    1000
+
+// Profiling Configuration (App/Perf); off compiles every hook out
+#define PERF_ENABLED                        STD_OFF // job and PERF_SCOPE() timers, stack marks
+#define PERF_MAX_SECTIONS                   24      // scheduler jobs plus PERF_SCOPE() sites
+#define PERF_MAX_TASKS                      6       // tasks whose stack high-water mark is reported
+#define PERF_REPORT_STEP_MS                 5000    // one MQTT_TOPIC_PERF message per step, round robin
+
+// Soil moisture threshold event (percent), raises SCHED_EVT_THRESHOLD on crossing
+#define SOILMOISTURE_DRY_THRESHOLD          30
+#define SOILMOISTURE_THRESHOLD_HYST         3
+
+// Zone Configuration: zone i has moisture pin i and valve/pump output i
+#define ZONE_COUNT                          2
+#define ZONE_MOISTURE_PINS                  {SOILMOISTURE_PIN, 34}  // ADC1 pins no other ADC user may take; zone 0 is the main soil sensor
+#define ZONE_OUTPUT_PINS                    {PUMP_PIN, 27}
+#define ZONE_CURRENT_MA                     {900, 600}     // draw of each zone's output while on
+#define ZONE_FLOW_LPM                       {4.0f, 2.5f}   // water each zone takes while on
+#define ZONE_CURRENT_LIMIT_MA               1200  // supply budget for all zones on at once
+#define ZONE_FLOW_LIMIT_LPM                 5.0f  // source budget for all zones on at once
+#define ZONE_MAX_RUN_S                      900   // a zone that ran this long yields to a waiting one
+#define ZONE_STOP_MOISTURE                  80    // percent; stops a zone whatever the model says
 
-// QUEUE Configuration
-#define Moisture_QUEUE_SIZE                 10
 // DHT 11 Configuration
 #define DHT11_1_PIN   5
 #define DHT22_1_PIN   5
 #define MAX_SENSORS_DHT 1  
-#define Temperature_QUEUE_SIZE              10
-#define Humidity_QUEUE_SIZE                 10
 
 
 // Nitrogen Sensor Configuration
 
-#define Nitrogen_QUEUE_SIZE                10
-
 #define NITROGEN_MAX  200
 
 // phosphorus Sensor Configuration
 
-#define Phosphorus_QUEUE_SIZE                10
-
 #define PHOSPHORUS_MAX  200
 
 // Potassium Sensor Configuration
 
-#define Potassium_QUEUE_SIZE                10
 #define POTASSIUM_MAX  200
 
 // PH Sensor Configuration
 
-#define PH_QUEUE_SIZE                10
 #define PH_MAX  14
 #endif
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include <Arduino.h>
+#include "Bench.h"
+
+#if BENCH_ENABLED == STD_ON
+#include <esp_heap_caps.h>
+#include "../MQTT_APP/mqtt_payload.h"
+#include "../ML/ML.h"
+
+// Allocations per message. With CONFIG_HEAP_USE_HOOKS (ESP-IDF core builds)
+// ESP-IDF's heap hook counts every successful malloc/calloc/realloc. The
+// stock Arduino core has no hooks: then each message samples
+// heap_caps_get_info() while it still holds its payload, which gives the
+// blocks and bytes the payload keeps, not the reallocs on the way there.
+// Counting only runs between benchCountStart() and benchCountStop();
+// Bench_Run() runs before the scheduler, so nothing else allocates meanwhile.
+typedef struct
+{
+    uint32_t allocations;
+    uint32_t bytes;
+} BenchAllocs_t;
+
+static volatile bool benchCounting = false;
+static BenchAllocs_t benchAllocs = {0, 0};
+
+#ifdef CONFIG_HEAP_USE_HOOKS
+#define BENCH_HEAP_METHOD "heap hook, every malloc/calloc/realloc"
+
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps)
+{
+    (void)ptr;
+    (void)caps;
+    if (benchCounting)
+    {
+        benchAllocs.allocations++;
+        benchAllocs.bytes += size;
+    }
+}
+
+static void benchCountStart(void)
+{
+    benchAllocs.allocations = 0;
+    benchAllocs.bytes = 0;
+    benchCounting = true;
+}
+
+static inline void benchCountSample(void)
+{
+}
+#else
+#define BENCH_HEAP_METHOD "heap_caps_get_info() per message, blocks held by the payload"
+
+static multi_heap_info_t benchHeapBase;
+
+static void benchCountStart(void)
+{
+    benchAllocs.allocations = 0;
+    benchAllocs.bytes = 0;
+    heap_caps_get_info(&benchHeapBase, MALLOC_CAP_8BIT);
+    benchCounting = true;
+}
+
+// Called by a case while it holds the message
+static void benchCountSample(void)
+{
+    if (!benchCounting)
+    {
+        return;
+    }
+    multi_heap_info_t now;
+    heap_caps_get_info(&now, MALLOC_CAP_8BIT);
+    benchAllocs.allocations += now.allocated_blocks - benchHeapBase.allocated_blocks;
+    benchAllocs.bytes += now.total_allocated_bytes - benchHeapBase.total_allocated_bytes;
+}
+#endif
+
+static BenchAllocs_t benchCountStop(void)
+{
+    benchCounting = false;
+    return benchAllocs;
+}
+
+// One message per call for iteration i; returns its length
+typedef size_t (*BenchCase_t)(uint32_t i);
+
+// A timed pass, then a counted one, so sampling the heap stays out of the timing
+static void benchRun(const char* name, BenchCase_t build)
+{
+    size_t largestBefore = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    size_t length = 0;
+
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        length = build(i);
+    }
+    uint32_t totalUs = micros() - start;
+
+    benchCountStart();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        build(i);
+    }
+    BenchAllocs_t allocs = benchCountStop();
+
+    Serial.printf("[BENCH] %-22s %7.2f us/msg  %5.2f allocs/msg  %6.1f B/msg  len %3u  largest free %u -> %u\n",
+                  name, (float)totalUs / BENCH_ITERATIONS, (float)allocs.allocations / BENCH_ITERATIONS,
+                  (float)allocs.bytes / BENCH_ITERATIONS, (unsigned)length, (unsigned)largestBefore,
+                  (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+}
+
+// The String-concatenation builders the payloads used before the JSON writer
+static String legacyTelemetry(float soilMoisture, float temperature, float humidity)
+{
+    String telemetryPayload = "{";
+    telemetryPayload += "\"site\":\"site1\",";
+    telemetryPayload += "\"node\":\"nodeA\",";
+    telemetryPayload += "\"soil_moisture\":" + String(soilMoisture, 1) + ",";
+    telemetryPayload += "\"temperature\":" + String((int)temperature) + ",";
+    telemetryPayload += "\"humidity\":" + String(humidity);
+    telemetryPayload += "}";
+    return telemetryPayload;
+}
+
+static String legacyDecision(Decision_t decision)
+{
+    String decisionPayload = "{";
+    decisionPayload += "\"timestamp\":" + String(millis()) + ",";
+    decisionPayload += "\"decision\":";
+    decisionPayload += decision == DECISION_IRRIGATE ? "\"IRRIGATE\"" : "\"NO_IRRIGATION\"";
+    decisionPayload += "}";
+    return decisionPayload;
+}
+
+static size_t benchLegacyTelemetry(uint32_t i)
+{
+    String payload = legacyTelemetry(40.0f + (i & 31), 23.0f, 55.5f);
+    benchCountSample();
+    return payload.length();
+}
+
+static size_t benchWriterTelemetry(uint32_t i)
+{
+    static JsonBuffer<MQTT_TELEMETRY_JSON_SIZE> json;
+    MQTT_Payload_Telemetry(&json, 40.0f + (i & 31), 23.0f, 55.5f, 0);
+    benchCountSample();
+    return json.length();
+}
+
+static size_t benchLegacyDecision(uint32_t i)
+{
+    String payload = legacyDecision((i & 1) ? DECISION_IRRIGATE : DECISION_NO_IRRIGATION);
+    benchCountSample();
+    return payload.length();
+}
+
+static size_t benchWriterDecision(uint32_t i)
+{
+    static JsonBuffer<MQTT_DECISION_JSON_SIZE> json;
+    MQTT_Payload_Decision(&json, (i & 1) ? DECISION_IRRIGATE : DECISION_NO_IRRIGATION, millis());
+    benchCountSample();
+    return json.length();
+}
+
+// Per-row latency of one Invoke of 1..BENCH_ML_ROWS rows, each on an
+// interpreter planned for exactly that batch, against one Invoke per row
+#define BENCH_ML_ROWS 16
+
+static void benchInference(void)
+{
+    if (!ML_Init())
+    {
+        return;
+    }
+
+    alignas(16) static uint8_t modelCopy[sizeof(irrigation_model)];
+    alignas(16) static uint8_t arena[kTensorArenaSize];
+    static float features[BENCH_ML_ROWS][NUM_FEATURES];
+    static float probabilities[BENCH_ML_ROWS];
+    for (uint8_t r = 0; r < BENCH_ML_ROWS; r++)
+    {
+        for (uint8_t i = 0; i < NUM_FEATURES; i++)
+        {
+            features[r][i] = featureMeans[i] + featureStds[i] * (float)(r - BENCH_ML_ROWS / 2) / BENCH_ML_ROWS;
+        }
+    }
+
+    const uint32_t iterations = BENCH_ITERATIONS / 10;
+    for (uint8_t rows = 1; rows <= BENCH_ML_ROWS; rows++)
+    {
+        if (!ML_BenchPlan(rows, modelCopy, arena, sizeof(arena)))
+        {
+            return;
+        }
+
+        uint32_t start = micros();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            ML_BenchInvoke(features, rows, probabilities);
+        }
+        uint32_t batchUs = micros() - start;
+
+        start = micros();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            for (uint8_t r = 0; r < rows; r++)
+            {
+                ML_RunInferenceBatch(&features[r], 1, &probabilities[r]);
+            }
+        }
+        uint32_t singleUs = micros() - start;
+
+        Serial.printf("[BENCH] inference batch %2u     %7.2f us/row  (one Invoke per row %7.2f us/row)\n",
+                      rows, (float)batchUs / (iterations * rows), (float)singleUs / (iterations * rows));
+    }
+}
+#endif
+
+void Bench_Run(void)
+{
+#if BENCH_ENABLED == STD_ON
+    Serial.printf("[BENCH] %d iterations per case, free heap %u\n",
+                  BENCH_ITERATIONS, (unsigned)heap_caps_get_free_size(MALLOC_CAP_8BIT));
+
+    // allocs/msg and B/msg per BENCH_HEAP_METHOD; the String builders realloc
+    // on most +=, the writer cases should show none either way
+    Serial.printf("[BENCH] heap counted by %s\n", BENCH_HEAP_METHOD);
+    benchRun("telemetry String", benchLegacyTelemetry);
+    benchRun("telemetry JsonWriter", benchWriterTelemetry);
+    benchRun("decision String", benchLegacyDecision);
+    benchRun("decision JsonWriter", benchWriterDecision);
+
+    // Batch sizes past ML_BATCH_MAX show what a larger batch would buy
+    benchInference();
+#endif
+}
@@ -0,0 +1,14 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "../../APP_Cfg.h"
+
+// On-device micro-benchmarks, compiled in with BENCH_ENABLED.
+// Results are printed on Serial; run from setup() before the scheduler starts
+// so nothing else touches the heap while measuring. Allocations are counted
+// through ESP-IDF's heap hooks when the core has CONFIG_HEAP_USE_HOOKS, and
+// sampled from the heap per message otherwise.
+
+void Bench_Run(void);
+
+#endif // BENCH_H
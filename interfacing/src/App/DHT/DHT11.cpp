@@ -1,97 +1,13 @@
 #include "DHT11.h"
 #include "../../APP_Cfg.h"
-#include "../SoilMoisture/SoilMoisture.h"
-static float Temperature[Temperature_QUEUE_SIZE];
-static uint8_t inT;
-static uint8_t outT;
-static uint8_t countT;
-static float Humidity[Humidity_QUEUE_SIZE];
-static uint8_t inH;
-static uint8_t outH;
-static uint8_t countH;
+#include "../SensorBus/SensorBus.h"
+#include "../Perf/Perf.h"
+
 #if DHT11_DEBUG == STD_ON
 #define DEBUG_PRINTLN(var) Serial.println(var)
 #else
 #define DEBUG_PRINTLN(var)
 #endif
-static void inqT(float data)
-{
-        if (inT == Temperature_QUEUE_SIZE)
-        {
-            inT = 0;
-        }
-        else
-        {
-            ;
-        }
-        Temperature[inT++] = data;
-        countT++;
-}
-
-static queue_t deqT(float *data)
-{
-    queue_t status = queue_ok;
-    if (outT == Temperature_QUEUE_SIZE)
-    {
-        outT = 0;
-    }
-    else
-    {
-        ;
-    }
-    if ((inT == outT) && (countT == 0))
-    {
-        status = queue_empty;
-    }
-    else
-    {
-        *(data) = Temperature[outT++];
-        status = queue_ok;
-        countT--;
-    }
-    return status;
-}
-
-static void inqH(float data)
-{
-    if (countH < Humidity_QUEUE_SIZE)
-    {
-        if (inH == Humidity_QUEUE_SIZE)
-        {
-            inH = 0;
-        }
-        else
-        {
-            ;
-        }
-        Humidity[inH++] = data;
-        countH++;
-    }
-}
-
-static queue_t deqH(float *data)
-{
-    queue_t status = queue_ok;
-    if (outH == Humidity_QUEUE_SIZE)
-    {
-        outH = 0;
-    }
-    else
-    {
-        ;
-    }
-    if ((inH == outH) && (countH == 0))
-    {
-        status = queue_empty;
-    }
-    else
-    {
-        *(data) = Humidity[outH++];
-        status = queue_ok;
-        countH--;
-    }
-    return status;
-}
 
 static DHT11Cfg_t DHT11_Sensors[MAX_SENSORS_DHT] = {
     {DHT11_1_PIN}};
@@ -113,9 +29,11 @@ void DHT11_init(void)
 void DHT11_main(void)
 {
 #if DHT11_ENABLED == STD_ON
+    PERF_SCOPE("DHT11_main");
 
-    uint8_t temperature = dht11_sensor.readTemperature();
-    uint8_t humidity = dht11_sensor.readHumidity();
+    // Keep the float result: a failed read is NaN, which is lost in an integer
+    float temperature = dht11_sensor.readTemperature();
+    float humidity = dht11_sensor.readHumidity();
 
     /* Debug output */
     DEBUG_PRINTLN("[DHT11] Temp = ");
@@ -127,12 +45,14 @@ void DHT11_main(void)
     if (isnan(temperature) || isnan(humidity))
     {
         DEBUG_PRINTLN("[DHT11] Sensor read FAILED!");
+        SensorBus_ReportFault(SENSOR_CH_TEMPERATURE);
+        SensorBus_ReportFault(SENSOR_CH_HUMIDITY);
         return;
     }
     else
     {
-        inqT(temperature);
-        inqH(humidity);
+        SensorBus_Publish(SENSOR_CH_TEMPERATURE, temperature);
+        SensorBus_Publish(SENSOR_CH_HUMIDITY, humidity);
         DEBUG_PRINTLN("[DHT11] Sensor read SUCCESSFUL!");
     }
 
@@ -142,18 +62,28 @@ void DHT11_main(void)
 void DHT11_GetTemperature(float *temperature)
 {
 #if DHT11_ENABLED == STD_ON
-    if (deqT(temperature) == queue_empty)
+    SensorSample_t sample;
+    if (SensorBus_GetLatest(SENSOR_CH_TEMPERATURE, &sample) != SENSOR_QUALITY_NONE)
+    {
+        *temperature = sample.value;
+    }
+    else
     {
-        *temperature = 0.0f; // Indicate that the queue is empty
+        *temperature = 0.0f; // No reading published yet
     }
 #endif
 }
 void DHT11_GetHumidity(float *humidity)
 {
     #if DHT11_ENABLED == STD_ON
-    if (deqH(humidity) == queue_empty)
+    SensorSample_t sample;
+    if (SensorBus_GetLatest(SENSOR_CH_HUMIDITY, &sample) != SENSOR_QUALITY_NONE)
+    {
+        *humidity = sample.value;
+    }
+    else
     {
-        *humidity = 0.0f; // Indicate that the queue is empty
+        *humidity = 0.0f; // No reading published yet
     }
 #endif
 }
@@ -1,77 +1,440 @@
 #include "ML.h"
-#include "../SoilMoisture/SoilMoisture.h"
-#include "../DHT/DHT11.h"
+#include "../SensorBus/SensorBus.h"
+#include "../Scheduler/Scheduler.h"
+#include "../ZoneManager/ZoneManager.h"
+#include "../Perf/Perf.h"
+#include "../OfflineLog/OfflineLog.h"
+#include "../Power/Power.h"
+#include "../../Utils/Crc32/Crc32.h"
+#include <stddef.h>
+#include <new>
+#include <esp_system.h>
+#include <Preferences.h>
 
 // TensorFlow Lite includes (assuming ArduTFLite library)
 #include <ArduTFLite.h>
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
 
 // TensorFlow Lite globals
-uint8_t tensorArena[kTensorArenaSize];
+alignas(16) uint8_t tensorArena[kTensorArenaSize];
 bool modelReady = false;
 
-// Sensor history
-SensorHistory history;
+// The model is converted with a dynamic batch dimension (shape_signature
+// [-1, n]) but stored with batch 1, and TFLM plans every tensor once at load.
+// Single rows run on the model in flash as stored. With ML_BATCH_MAX > 1 a RAM
+// copy has the batch dimension set to ML_BATCH_MAX (one row per zone), so the
+// decision pass is one Invoke; each interpreter plans into half the arena.
+static tflite::MicroInterpreter *interpreter = NULL;
+#if ML_BATCH_MAX > 1
+#define ML_ARENA_SPLIT (kTensorArenaSize / 2)
+alignas(16) static uint8_t batchModel[sizeof(irrigation_model)];
+static tflite::MicroInterpreter *batchInterpreter = NULL;
+#else
+#define ML_ARENA_SPLIT kTensorArenaSize
+#endif
+
+// Standardization and input quantization folded into one affine per feature:
+// q = round(x * inputGain + inputOffset), clamped to int8
+static float inputGain[NUM_FEATURES];
+static float inputOffset[NUM_FEATURES];
+
+// Sensor history, one window per irrigation zone
+SensorHistory history[ZONE_COUNT];
+
+// Persisted model state. The stamp ties a copy to this build's layout and to
+// the model it was collected for; the CRC rejects torn or random memory. It
+// also carries the time of the newest step, so a copy is only taken over when
+// its age is known and the steps since can be caught up.
+#define ML_STATE_MAGIC 0x4D4C4833UL   // "MLH3"
+#define ML_HISTORY_STEP_S (SCHED_ML_HISTORY_PERIOD_MS / 1000)
+
+// A step's time on the clocks that survive a reset: UTC once SNTP has synced
+// (the RTC keeps system time across soft resets and deep sleep), and the
+// duty cycle's Power clock. 0 where a clock is not running.
+typedef struct {
+    uint32_t utcS;
+    uint32_t clockId;
+    uint32_t clockS;
+} ML_StepTime_t;
+
+// Readings only, oldest first; the window statistics are rebuilt on restore
+typedef struct {
+    float temperature[HISTORY_SIZE];
+    float soilmoisture[HISTORY_SIZE];
+    uint32_t count;
+} ML_PersistedHistory_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t layoutSize;
+    uint32_t modelCrc;
+    ML_StepTime_t newestStep;
+    ML_PersistedHistory_t history[ZONE_COUNT];
+    uint32_t crc;                   // over every byte before it
+} ML_PersistedState_t;
+
+#if ML_PERSIST_RTC == STD_ON
+RTC_DATA_ATTR static ML_PersistedState_t rtcState;
+#endif
+static uint32_t modelCrc = 0;
+static uint8_t stepsSinceNvsSave = 0;
+
+// Newest step of a restored copy until the first update has caught up from it
+static ML_StepTime_t restoredStep;
+static bool restoredPending = false;
+
+static void mlStepTimeNow(ML_StepTime_t *time) {
+    time->utcS = OfflineLog_Now();
+    time->clockS = Power_GetClockS(&time->clockId);
+}
+
+// Whole history steps since `then`, rounded; false when no clock relates it to now
+static bool mlStepsSince(const ML_StepTime_t *then, uint32_t *steps) {
+    ML_StepTime_t now;
+    mlStepTimeNow(&now);
+
+    uint32_t ageS;
+    if (then->utcS != 0 && now.utcS >= then->utcS) {
+        ageS = now.utcS - then->utcS;
+    } else if (then->clockId != 0 && now.clockId == then->clockId && now.clockS >= then->clockS) {
+        ageS = now.clockS - then->clockS;
+    } else {
+        return false;
+    }
+    *steps = (ageS + ML_HISTORY_STEP_S / 2) / ML_HISTORY_STEP_S;
+    return true;
+}
+
+static void mlStamp(ML_PersistedState_t *state) {
+    memset(state, 0, sizeof(*state));   // deterministic padding for the CRC
+    state->magic = ML_STATE_MAGIC;
+    state->layoutSize = sizeof(ML_PersistedState_t);
+    state->modelCrc = modelCrc;
+    mlStepTimeNow(&state->newestStep);
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++) {
+        history[zone].temperature.snapshot(state->history[zone].temperature);
+        state->history[zone].count = history[zone].soilmoisture.snapshot(state->history[zone].soilmoisture);
+    }
+    state->crc = Crc32_Update(0, state, offsetof(ML_PersistedState_t, crc));
+}
+
+static bool mlStampValid(const ML_PersistedState_t *state) {
+    if (state->magic != ML_STATE_MAGIC ||
+        state->layoutSize != sizeof(ML_PersistedState_t) ||
+        state->modelCrc != modelCrc ||
+        state->crc != Crc32_Update(0, state, offsetof(ML_PersistedState_t, crc))) {
+        return false;
+    }
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++) {
+        if (state->history[zone].count > HISTORY_SIZE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// RTC copy on every step (cheap, survives deep sleep and soft resets); NVS copy
+// every ML_NVS_SAVE_EVERY steps to bound flash wear
+static void mlSaveState() {
+#if ML_PERSIST_RTC == STD_ON
+    mlStamp(&rtcState);
+#endif
+#if ML_PERSIST_NVS == STD_ON
+    if (++stepsSinceNvsSave >= ML_NVS_SAVE_EVERY) {
+        ML_PersistedState_t state;
+        mlStamp(&state);
+        Preferences prefs;
+        if (prefs.begin("ml", false)) {
+            prefs.putBytes("state", &state, sizeof(state));
+            prefs.end();
+        }
+        stepsSinceNvsSave = 0;
+    }
+#endif
+}
+
+static void mlLoadHistory(const ML_PersistedState_t *state) {
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++) {
+        const ML_PersistedHistory_t *saved = &state->history[zone];
+        history[zone].init();
+        for (uint32_t i = 0; i < saved->count; i++) {
+            history[zone].addReading(saved->temperature[i], saved->soilmoisture[i]);
+        }
+    }
+}
+
+// Valid, and recent enough for the next update to interpolate the steps missed
+static bool mlStateUsable(const ML_PersistedState_t *state, const char *source) {
+    if (!mlStampValid(state)) {
+        return false;
+    }
+    uint32_t steps;
+    if (!mlStepsSince(&state->newestStep, &steps)) {
+        Serial.printf("[ML] %s history has no known age, discarded\n", source);
+        return false;
+    }
+    if (steps > ML_RESTORE_MAX_GAP_STEPS) {
+        Serial.printf("[ML] %s history is %u steps old, discarded\n", source, (unsigned)steps);
+        return false;
+    }
+    return true;
+}
+
+static void mlTakeOver(const ML_PersistedState_t *state, const char *source) {
+    mlLoadHistory(state);
+    restoredStep = state->newestStep;
+    restoredPending = true;
+    Serial.printf("[ML] History restored from %s (%u entries)\n", source, (unsigned)state->history[0].count);
+}
+
+static bool mlRestoreState() {
+    restoredPending = false;
+#if ML_PERSIST_RTC == STD_ON
+    if (mlStateUsable(&rtcState, "RTC memory")) {
+        mlTakeOver(&rtcState, "RTC memory");
+        return true;
+    }
+#endif
+#if ML_PERSIST_NVS == STD_ON
+    // After a power-on the flash copy can be hours old and its trend would be wrong
+    if (esp_reset_reason() != ESP_RST_POWERON) {
+        ML_PersistedState_t state;
+        Preferences prefs;
+        if (prefs.begin("ml", true)) {
+            size_t length = prefs.getBytes("state", &state, sizeof(state));
+            prefs.end();
+            if (length == sizeof(state) && mlStateUsable(&state, "NVS")) {
+                mlTakeOver(&state, "NVS");
+                return true;
+            }
+        }
+    }
+#endif
+    return false;
+}
+
+// Batch every tensor the model declares with a dynamic leading dimension
+static bool mlPatchBatch(const tflite::Model *model, int32_t rows) {
+    if (model->subgraphs() == NULL || model->subgraphs()->size() != 1) {
+        return false;
+    }
+    const auto *tensors = model->subgraphs()->Get(0)->tensors();
+    for (uint32_t i = 0; i < tensors->size(); i++) {
+        const tflite::Tensor *tensor = tensors->Get(i);
+        const auto *signature = tensor->shape_signature();
+        if (signature != NULL && signature->size() > 0 && signature->Get(0) == -1 &&
+            tensor->shape() != NULL && tensor->shape()->size() == signature->size()) {
+            const_cast<flatbuffers::Vector<int32_t> *>(tensor->shape())->Mutate(0, rows);
+        }
+    }
+    return true;
+}
+
+// Plan the tensors, then check the input took the batch, one int8 row of
+// features each
+static bool mlAllocate(tflite::MicroInterpreter *interp, int rows) {
+    if (interp->AllocateTensors() != kTfLiteOk) {
+        Serial.printf("[ML ERROR] Tensor arena too small for batch %d\n", rows);
+        return false;
+    }
+    TfLiteTensor *input = interp->input(0);
+    TfLiteTensor *output = interp->output(0);
+    if (input->type != kTfLiteInt8 || output->type != kTfLiteInt8 || input->dims->size != 2 ||
+        input->dims->data[0] != rows || input->dims->data[1] != NUM_FEATURES) {
+        Serial.println("[ML ERROR] Model input is not int8 [batch, 8]");
+        return false;
+    }
+    Serial.printf("[ML] Arena use %u bytes for batch %d\n", (unsigned)interp->arena_used_bytes(), rows);
+    return true;
+}
+
+static tflite::MicroMutableOpResolver<2> opResolver;
+
+static bool mlLoadModel() {
+    const tflite::Model *model = tflite::GetModel(irrigation_model);
+    if (model->version() != TFLITE_SCHEMA_VERSION) {
+        Serial.println("[ML ERROR] Unsupported model format");
+        return false;
+    }
+
+    opResolver.AddFullyConnected();
+    opResolver.AddLogistic();
+
+    static tflite::MicroInterpreter staticInterpreter(model, opResolver, tensorArena, ML_ARENA_SPLIT);
+    if (!mlAllocate(&staticInterpreter, 1)) {
+        return false;
+    }
+
+#if ML_BATCH_MAX > 1
+    memcpy(batchModel, irrigation_model, sizeof(batchModel));
+    const tflite::Model *batched = tflite::GetModel(batchModel);
+    if (!mlPatchBatch(batched, ML_BATCH_MAX)) {
+        Serial.println("[ML ERROR] Unsupported model format");
+        return false;
+    }
+    static tflite::MicroInterpreter staticBatchInterpreter(batched, opResolver, tensorArena + ML_ARENA_SPLIT,
+                                                           kTensorArenaSize - ML_ARENA_SPLIT);
+    if (!mlAllocate(&staticBatchInterpreter, ML_BATCH_MAX)) {
+        return false;
+    }
+    batchInterpreter = &staticBatchInterpreter;
+#endif
+
+    TfLiteTensor *input = staticInterpreter.input(0);
+
+    // ((x - mean) / std) / scale + zeroPoint == x * gain + offset
+    for (int i = 0; i < NUM_FEATURES; i++) {
+        inputGain[i] = 1.0f / (featureStds[i] * input->params.scale);
+        inputOffset[i] = input->params.zero_point - featureMeans[i] * inputGain[i];
+    }
+
+    interpreter = &staticInterpreter;
+    return true;
+}
 
 // ML inference implementation
 bool ML_Init() {
     Serial.println("[ML] Initializing TensorFlow Lite model...");
 
-    // Initialize model
-    modelReady = modelInit(irrigation_model, tensorArena, kTensorArenaSize);
+    // Initialize model (once; Bench may have loaded it already)
+    if (!modelReady) {
+        modelReady = mlLoadModel();
+    }
 
     if (!modelReady) {
         Serial.println("[ML ERROR] Model failed to load!");
         return false;
     }
 
-    // Initialize history
-    history.init();
+    // Initialize history, then take over a persisted one if it is still valid
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++) {
+        history[zone].init();
+    }
+    modelCrc = Crc32_Update(0, irrigation_model, irrigation_model_len);
+    mlRestoreState();
 
     Serial.printf("[ML] Model loaded successfully (%d bytes)\n", irrigation_model_len);
     return true;
 }
 
-float ML_RunInference() {
+// Model input for one zone, before standardization
+static void mlFeatures(SensorHistory *h, float *features) {
+    features[0] = h->getTemp(0);                // temperature
+    features[1] = h->getMoisture(0);            // soilmoisture
+    features[2] = h->tempMean();                // temperature_mean
+    features[3] = h->moistureMean();            // soilmoisture_mean
+    features[4] = h->tempTrend();               // temperature_trend
+    features[5] = h->moistureTrend();           // soilmoisture_trend
+    features[6] = h->getMoisture(1);            // soilmoisture_lag_1
+    features[7] = h->getMoisture(2);            // soilmoisture_lag_2
+}
+
+// Quantize one chunk straight into the input tensor, one Invoke
+static bool mlInvokeChunk(tflite::MicroInterpreter *interp, const float (*features)[NUM_FEATURES], uint16_t rows,
+                          float *probabilities) {
+    int8_t *input = interp->input(0)->data.int8;
+    for (uint16_t r = 0; r < rows; r++) {
+        for (int i = 0; i < NUM_FEATURES; i++) {
+            long q = lrintf(features[r][i] * inputGain[i] + inputOffset[i]);
+            *input++ = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+        }
+    }
+    // Rows past the chunk still hold an earlier batch; they are computed and ignored
+
+    if (interp->Invoke() != kTfLiteOk) {
+        return false;
+    }
+
+    const TfLiteTensor *output = interp->output(0);
+    for (uint16_t r = 0; r < rows; r++) {
+        probabilities[r] = (output->data.int8[r] - output->params.zero_point) * output->params.scale;
+    }
+    return true;
+}
+
+bool ML_RunInferenceBatch(const float (*features)[NUM_FEATURES], uint16_t rows, float *probabilities) {
+    PERF_SCOPE("ML_RunInferenceBatch");
     if (!modelReady) {
         Serial.println("[ML ERROR] Model not ready!");
-        return -1.0f;
+        return false;
     }
 
-    if (!history.isReady()) {
-        Serial.println("[ML] Not enough history data for inference");
-        return -1.0f;
+    for (uint16_t done = 0; done < rows; done += ML_BATCH_MAX) {
+        uint8_t chunk = (rows - done < ML_BATCH_MAX) ? (uint8_t)(rows - done) : ML_BATCH_MAX;
+        tflite::MicroInterpreter *interp = interpreter;
+#if ML_BATCH_MAX > 1
+        if (chunk > 1) {
+            interp = batchInterpreter;
+        }
+#endif
+        if (!mlInvokeChunk(interp, features + done, chunk, probabilities + done)) {
+            Serial.println("[ML ERROR] Inference failed!");
+            return false;
+        }
     }
+    return true;
+}
 
-    // Prepare 8 features
-    float features[NUM_FEATURES];
-    features[0] = history.getTemp(0);           // temperature
-    features[1] = history.getMoisture(0);       // soilmoisture
-    features[2] = history.tempMean();           // temperature_mean
-    features[3] = history.moistureMean();       // soilmoisture_mean
-    features[4] = history.tempTrend();          // temperature_trend
-    features[5] = history.moistureTrend();      // soilmoisture_trend
-    features[6] = history.getMoisture(1);       // soilmoisture_lag_1
-    features[7] = history.getMoisture(2);       // soilmoisture_lag_2
+// Benchmarks: one interpreter at a time, replanned for each batch size
+alignas(tflite::MicroInterpreter) static uint8_t benchInterpreterStorage[sizeof(tflite::MicroInterpreter)];
+static tflite::MicroInterpreter *benchInterpreter = NULL;
+static uint16_t benchRows = 0;
 
-    // Standardize using scaler params
-    float scaled[NUM_FEATURES];
-    for (int i = 0; i < NUM_FEATURES; i++) {
-        scaled[i] = (features[i] - featureMeans[i]) / featureStds[i];
+bool ML_BenchPlan(uint16_t rows, uint8_t *modelCopy, uint8_t *arena, size_t arenaSize) {
+    if (!modelReady || rows == 0) {
+        return false;
+    }
+    if (benchInterpreter != NULL) {
+        benchInterpreter->~MicroInterpreter();
+        benchInterpreter = NULL;
     }
 
-    // Set inputs and run
-    for (int i = 0; i < NUM_FEATURES; i++) {
-        modelSetInput(scaled[i], i);
+    memcpy(modelCopy, irrigation_model, irrigation_model_len);
+    const tflite::Model *batched = tflite::GetModel(modelCopy);
+    if (!mlPatchBatch(batched, rows)) {
+        Serial.println("[ML ERROR] Unsupported model format");
+        return false;
+    }
+    tflite::MicroInterpreter *interp =
+        new (benchInterpreterStorage) tflite::MicroInterpreter(batched, opResolver, arena, arenaSize);
+    if (!mlAllocate(interp, rows)) {
+        interp->~MicroInterpreter();
+        return false;
+    }
+    benchInterpreter = interp;
+    benchRows = rows;
+    return true;
+}
+
+bool ML_BenchInvoke(const float (*features)[NUM_FEATURES], uint16_t rows, float *probabilities) {
+    if (benchInterpreter == NULL || rows > benchRows) {
+        return false;
     }
+    return mlInvokeChunk(benchInterpreter, features, rows, probabilities);
+}
 
-    if (!modelRunInference()) {
-        Serial.println("[ML ERROR] Inference failed!");
+float ML_RunInference(uint8_t zone) {
+    if (!modelReady) {
+        Serial.println("[ML ERROR] Model not ready!");
         return -1.0f;
     }
 
-    float probability = modelGetOutput(0);
+    if (zone >= ZONE_COUNT || !history[zone].isReady()) {
+        Serial.println("[ML] Not enough history data for inference");
+        return -1.0f;
+    }
+
+    float features[1][NUM_FEATURES];
+    float probability;
+    mlFeatures(&history[zone], features[0]);
 
-    Serial.printf("[ML] Inference result: %.4f\n", probability);
+    if (!ML_RunInferenceBatch(features, 1, &probability)) {
+        return -1.0f;
+    }
+
+    Serial.printf("[ML] Zone %u inference result: %.4f\n", zone, probability);
     return probability;
 }
 
@@ -87,104 +450,183 @@ Decision_t ML_GetDecision(float probability) {
     }
 }
 
-bool ML_GetSensorData(float *temperature, float *humidity, uint8_t *soilMoisture) {
-    // Get data from queues
-    SoilMoisture_getMoisture(soilMoisture);
-    DHT11_GetTemperature(temperature);
-    DHT11_GetHumidity(humidity);
-
-    // Check if data is valid (not default 0)
-    if (*temperature == 0.0f && *humidity == 0.0f && *soilMoisture == 0) {
-        return false;  // Queues empty
+bool ML_GetSensorData(uint8_t zone, float *temperature, float *humidity, uint8_t *soilMoisture) {
+    SensorChannel_t channel = SensorBus_ZoneMoistureChannel(zone);
+    SensorSample_t latest;
+    SensorReading_t moisture;
+    SensorSample_t temp;
+    SensorSample_t hum;
+
+    // Only feed the model current, good readings; a stale or faulted channel
+    // would put a wrong trend into the history
+    if (SensorBus_GetLatest(channel, &latest) != SENSOR_QUALITY_GOOD ||
+        SensorBus_GetLatest(SENSOR_CH_TEMPERATURE, &temp) != SENSOR_QUALITY_GOOD) {
+        return false;
+    }
+    // ML keeps its own cursor on the zone's probe, so a history step is only
+    // taken on a reading it has not used before
+    if (SensorBus_ReadLatest(SENSORBUS_CONSUMER_ML, channel, &moisture) != queue_ok) {
+        return false;
     }
+    SensorBus_GetLatest(SENSOR_CH_HUMIDITY, &hum);
 
+    *soilMoisture = (uint8_t)moisture.value;
+    *temperature = temp.value;
+    *humidity = hum.value;
     return true;
 }
 
-void ML_UpdateHistory() {
+// Add the current readings as the last of `steps` history steps since the
+// previous entry; the steps in between are interpolated from that entry
+static void mlUpdateHistory(uint32_t steps) {
     float temperature, humidity;
     uint8_t soilMoisture;
+    bool updated = false;
+    bool ready = false;
+
+    // The first update after a restore also covers the steps the node was down
+    uint32_t sinceRestore;
+    if (restoredPending && mlStepsSince(&restoredStep, &sinceRestore) && sinceRestore > steps) {
+        steps = sinceRestore;
+    }
+
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++) {
+        SensorHistory *h = &history[zone];
+        if (!ML_GetSensorData(zone, &temperature, &humidity, &soilMoisture)) {
+            Serial.printf("[ML] No new sensor data for zone %u history update\n", zone);
+            continue;
+        }
 
-    if (ML_GetSensorData(&temperature, &humidity, &soilMoisture)) {
         // Scale soil moisture to training range
-        const float MOISTURE_MIN = 50.0f;
-        const float MOISTURE_MAX = 450.0f;
-        float scaledMoisture = MOISTURE_MIN + (float)soilMoisture * (MOISTURE_MAX - MOISTURE_MIN) / 100.0f;
+        float scaledMoisture = ML_MOISTURE_MIN + (float)soilMoisture * (ML_MOISTURE_MAX - ML_MOISTURE_MIN) / 100.0f;
+
+        if (ML_HISTORY_PREFILL == STD_ON && h->temperature.size() == 0) {
+            // Nothing restored: start from a flat window so inference is ready now
+            for (uint8_t i = 0; i < HISTORY_SIZE - 1; i++) {
+                h->addReading(temperature, scaledMoisture);
+            }
+        }
+        // Only the newest HISTORY_SIZE steps can still be in the window
+        if (h->temperature.size() > 0 && steps > 1) {
+            float lastTemp = h->getTemp(0);
+            float lastMoisture = h->getMoisture(0);
+            uint32_t first = steps > HISTORY_SIZE ? steps - HISTORY_SIZE + 1 : 1;
+            for (uint32_t k = first; k < steps; k++) {
+                float f = (float)k / steps;
+                h->addReading(lastTemp + (temperature - lastTemp) * f,
+                              lastMoisture + (scaledMoisture - lastMoisture) * f);
+            }
+        }
+        h->addReading(temperature, scaledMoisture);
+        updated = true;
+        ready = ready || h->isReady();
+
+        Serial.printf("[ML] Zone %u history updated - Temp: %.1f, Moisture: %u (scaled: %.1f)\n",
+                     zone, temperature, soilMoisture, scaledMoisture);
+    }
 
-        history.addReading(temperature, scaledMoisture);
+    if (updated) {
+        restoredPending = false;
+        mlSaveState();
+    }
 
-        Serial.printf("[ML] History updated - Temp: %.1f, Moisture: %.0f (scaled: %.1f)\n",
-                     temperature, soilMoisture, scaledMoisture);
-    } else {
-        Serial.println("[ML] No sensor data available for history update");
+    // Every new entry on a full window is enough for a fresh decision
+    if (ready) {
+        Sched_Signal(SCHED_EVT_HISTORY_READY);
     }
 }
 
-void ML_ProcessDecision() {
-    // Update history with latest sensor data
-    ML_UpdateHistory();
+void ML_UpdateHistory() {
+    mlUpdateHistory(1);
+}
 
-    // Run inference
-    float probability = ML_RunInference();
+void ML_CatchUpHistory(uint32_t steps) {
+    mlUpdateHistory(steps > 0 ? steps : 1);
+}
 
-    // Get decision
-    Decision_t decision = ML_GetDecision(probability);
+uint8_t ML_DecideZones(Decision_t *decisions, bool *decided) {
+    float features[ZONE_COUNT][NUM_FEATURES];
+    float probabilities[ZONE_COUNT];
+    uint8_t zones[ZONE_COUNT];
+    uint8_t rows = 0;
+
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++) {
+        // A threshold event can arrive before the window is full
+        decided[zone] = false;
+        if (history[zone].isReady()) {
+            mlFeatures(&history[zone], features[rows]);
+            zones[rows++] = zone;
+        }
+    }
+    if (rows == 0) {
+        return 0;
+    }
 
-    // Publish decision
-    MQTT_APP_PublishDecision(decision);
+    bool ok = ML_RunInferenceBatch(features, rows, probabilities);
 
-    Serial.printf("[ML] Decision published: %d\n", (int)decision);
+    for (uint8_t r = 0; r < rows; r++) {
+        uint8_t zone = zones[r];
+        decisions[zone] = ML_GetDecision(ok ? probabilities[r] : -1.0f);
+        decided[zone] = true;
+
+        Serial.printf("[ML] Zone %u probability %.4f, decision: %d\n",
+                      zone, ok ? probabilities[r] : -1.0f, (int)decisions[zone]);
+    }
+    return rows;
+}
+
+// One pass over every zone, then per zone hand the decision to the zone
+// manager and publish it
+void ML_RunDecision() {
+    Decision_t decisions[ZONE_COUNT];
+    bool decided[ZONE_COUNT];
+
+    if (ML_DecideZones(decisions, decided) == 0) {
+        return;
+    }
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++) {
+        if (decided[zone]) {
+            ZoneManager_SetDecision(zone, decisions[zone]);
+            MQTT_APP_PublishDecision(decisions[zone], zone);
+        }
+    }
 }
 
 // SensorHistory method implementations
 void SensorHistory::init() {
-    index = 0;
-    count = 0;
-    for (int i = 0; i < HISTORY_SIZE; i++) {
-        temperature[i] = 0;
-        soilmoisture[i] = 0;
-    }
+    temperature.clear();
+    soilmoisture.clear();
 }
 
 void SensorHistory::addReading(float temp, float moisture) {
-    temperature[index] = temp;
-    soilmoisture[index] = moisture;
-    index = (index + 1) % HISTORY_SIZE;
-    if (count < HISTORY_SIZE) count++;
+    temperature.push(temp);
+    soilmoisture.push(moisture);
 }
 
-float SensorHistory::getTemp(uint8_t stepsAgo) {
-    int idx = (index - 1 - stepsAgo + HISTORY_SIZE) % HISTORY_SIZE;
-    return temperature[idx];
+float SensorHistory::getTemp(uint16_t stepsAgo) {
+    return temperature.at(stepsAgo);
 }
 
-float SensorHistory::getMoisture(uint8_t stepsAgo) {
-    int idx = (index - 1 - stepsAgo + HISTORY_SIZE) % HISTORY_SIZE;
-    return soilmoisture[idx];
+float SensorHistory::getMoisture(uint16_t stepsAgo) {
+    return soilmoisture.at(stepsAgo);
 }
 
 float SensorHistory::tempMean() {
-    float sum = 0;
-    for (int i = 0; i < count; i++) sum += temperature[i];
-    return count > 0 ? sum / count : 0;
+    return temperature.mean();
 }
 
 float SensorHistory::moistureMean() {
-    float sum = 0;
-    for (int i = 0; i < count; i++) sum += soilmoisture[i];
-    return count > 0 ? sum / count : 0;
+    return soilmoisture.mean();
 }
 
 float SensorHistory::tempTrend() {
-    if (count < 2) return 0;
-    return getTemp(0) - getTemp(count - 1);
+    return temperature.trend();
 }
 
 float SensorHistory::moistureTrend() {
-    if (count < 2) return 0;
-    return getMoisture(0) - getMoisture(count - 1);
+    return soilmoisture.trend();
 }
 
 bool SensorHistory::isReady() {
-    return count >= HISTORY_SIZE;
+    return temperature.full();
 }
@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include "../../APP_Cfg.h"
 #include "../MQTT_APP/mqtt_app.h"
+#include "../../Utils/RollingWindow/RollingWindow.h"
 
 // ML Model includes
 #include "irrigation_model.h"
@@ -13,21 +14,24 @@
 #define NUM_FEATURES 8
 #define IRRIGATION_THRESHOLD 0.5f
 
+// Soil moisture percent is scaled to the probe units of the training data
+#define ML_MOISTURE_MIN 50.0f
+#define ML_MOISTURE_MAX 450.0f
+
 // TensorFlow Lite configuration
 #define kTensorArenaSize 8 * 1024
 extern uint8_t tensorArena[kTensorArenaSize];
 
-// Sensor history buffer
+// Sensor history buffer. Each window keeps its mean, variance, min and max
+// current as readings come in, so a feature costs O(1) whatever HISTORY_SIZE.
 struct SensorHistory {
-    float temperature[HISTORY_SIZE];
-    float soilmoisture[HISTORY_SIZE];
-    uint8_t index;
-    uint8_t count;
+    RollingWindow<HISTORY_SIZE> temperature;
+    RollingWindow<HISTORY_SIZE> soilmoisture;
 
     void init();
     void addReading(float temp, float moisture);
-    float getTemp(uint8_t stepsAgo);
-    float getMoisture(uint8_t stepsAgo);
+    float getTemp(uint16_t stepsAgo);
+    float getMoisture(uint16_t stepsAgo);
     float tempMean();
     float moistureMean();
     float tempTrend();
@@ -37,11 +41,31 @@ struct SensorHistory {
 
 // ML inference functions
 bool ML_Init();
-float ML_RunInference();
+float ML_RunInference(uint8_t zone = 0);
+// Rows of raw features in model order, probabilities[i] for features[i].
+// Up to ML_BATCH_MAX rows share one Invoke; more are run in chunks. A single
+// row runs on its own batch-1 interpreter.
+bool ML_RunInferenceBatch(const float (*features)[NUM_FEATURES], uint16_t rows, float *probabilities);
+// Benchmarks: plan an interpreter for exactly `rows` rows per Invoke over
+// modelCopy (irrigation_model_len bytes, batch patched in place) in the
+// caller's arena, replacing the previous one. ML_BenchInvoke then runs up to
+// that many rows as a single Invoke, whatever ML_BATCH_MAX is.
+bool ML_BenchPlan(uint16_t rows, uint8_t *modelCopy, uint8_t *arena, size_t arenaSize);
+bool ML_BenchInvoke(const float (*features)[NUM_FEATURES], uint16_t rows, float *probabilities);
 Decision_t ML_GetDecision(float probability);
-void ML_ProcessDecision();
+// One batched inference over every zone whose history window is full.
+// decided[zone] tells which of decisions[ZONE_COUNT] were set; returns how many.
+uint8_t ML_DecideZones(Decision_t *decisions, bool *decided);
+// Scheduler jobs: history is sampled on its fixed step, the decision runs on
+// SCHED_EVT_HISTORY_READY / SCHED_EVT_THRESHOLD. Both cover every zone.
+void ML_UpdateHistory();
+// Duty cycle: the current readings arrive `steps` history steps after the
+// previous entry. The steps in between get values interpolated linearly from
+// that entry, so the window keeps the step the model was trained on.
+void ML_CatchUpHistory(uint32_t steps);
+void ML_RunDecision();
 
 // Sensor data getters
-bool ML_GetSensorData(float *temperature, float *humidity, uint8_t *soilMoisture);
+bool ML_GetSensorData(uint8_t zone, float *temperature, float *humidity, uint8_t *soilMoisture);
 
 #endif // ML_H
@@ -1,7 +1,14 @@
-/*#include "mqtt_app.h"
+#include <math.h>
+#include <atomic>
+#include "mqtt_app.h"
+#include "mqtt_payload.h"
+#include "mqtt_codec.h"
 #include <Arduino.h>
 #include "../../Hal/MQTT/mqtt_core.h"
-#include "../SoilMoisture/SoilMoisture.h"
+#include "../SensorBus/SensorBus.h"
+#include "../Scheduler/Scheduler.h"
+#include "../OfflineLog/OfflineLog.h"
+#include "../ZoneManager/ZoneManager.h"
 #include "../../Hal/Pump/Pump.h"
 #include "../../Hal/WIFI/wifi.h"
 #include "../../APP_Cfg.h"
@@ -16,23 +23,75 @@
 #define MQTT_TOPIC_TELEMETRY        "farm/site1/nodeA/telemetry"
 #define MQTT_TOPIC_STATUS           "farm/site1/nodeA/status"
 #define MQTT_TOPIC_COMMAND          "farm/site1/nodeA/cmd"
+#define MQTT_TOPIC_ZONE_PREFIX      "farm/site1/nodeA/zone/"
+#define MQTT_TOPIC_ZONE_COMMAND     MQTT_TOPIC_ZONE_PREFIX "+/cmd"  // + = zone index
+
+#if MQTT_PAYLOAD_FORMAT == MQTT_PAYLOAD_BINARY && MQTT_TELEMETRY_BATCH != MQTT_BATCH_OFF
+#error "Telemetry batching is only implemented for JSON payloads"
+#endif
+
+#if MQTT_TELEMETRY_DEADBAND == STD_ON && MQTT_TELEMETRY_BATCH != MQTT_BATCH_OFF
+#error "Choose either deadband telemetry or batching"
+#endif
+
+// MQTT_APP_PublishTelemetry() reads both sensors off the bus
+#define MQTT_APP_TELEMETRY (MQTT_ENABLED == STD_ON && SOILMOISTURE_ENABLED == STD_ON && DHT11_ENABLED == STD_ON)
 
 // Static variables for application state
-static unsigned long lastTelemetryTime = 0;
 static uint32_t messageCount = 0;
 
+// Set by the WiFi callbacks (NET lane), read by mqtt_main (IO lane)
+static std::atomic<bool> mqttInitialized(false);
+
 // Static variables for MQTT main timing
-static bool mqttInitialized = false;
 static TickType_t lastPublishTime = 0;
-static TickType_t lastDecisionTime = 0;
-static int dummyMessageCount = 0;
-static int decisionCount = 0;
+static TickType_t lastTelemetryTick = 0;
+static TickType_t lastReplayTick = 0;
+
+#if MQTT_APP_TELEMETRY && MQTT_TELEMETRY_BATCH != MQTT_BATCH_OFF
+static_assert(MQTT_BATCH_JSON_SIZE <= MQTT_OUTBOX_PAYLOAD_MAX + 1 &&
+              MQTT_SUMMARY_JSON_SIZE <= MQTT_OUTBOX_PAYLOAD_MAX + 1,
+              "MQTT_TELEMETRY_BATCH_SIZE too large for MQTT_OUTBOX_PAYLOAD_MAX");
+
+// Readings waiting for the next batch (IO lane only)
+static MQTT_TelemetrySample_t batchSamples[MQTT_TELEMETRY_BATCH_SIZE];
+static uint8_t batchCount = 0;
+#endif
+
+#if MQTT_APP_TELEMETRY && MQTT_TELEMETRY_DEADBAND == STD_ON
+// Report by exception: a field is sent when it has moved by its deadband since
+// it was last sent, or when it has been silent for its max-silence interval
+typedef struct
+{
+    float deadband;
+    uint32_t maxSilenceMs;
+    float lastSent;
+    TickType_t lastSentTick;
+    bool sent;                  // lastSent is valid
+} ReportField_t;
+
+enum { REPORT_SOIL_MOISTURE, REPORT_TEMPERATURE, REPORT_HUMIDITY, REPORT_FIELD_COUNT };
+
+// IO lane only
+static ReportField_t reportFields[REPORT_FIELD_COUNT] = {
+    {MQTT_DEADBAND_SOIL_MOISTURE, MQTT_MAX_SILENCE_SOIL_MOISTURE_MS, 0.0f, 0, false},
+    {MQTT_DEADBAND_TEMPERATURE, MQTT_MAX_SILENCE_TEMPERATURE_MS, 0.0f, 0, false},
+    {MQTT_DEADBAND_HUMIDITY, MQTT_MAX_SILENCE_HUMIDITY_MS, 0.0f, 0, false},
+};
+#endif
 
 // Forward declarations
-static void publishSoilMoistureTelemetry(void);
+static bool payloadEquals(const uint8_t* payload, uint16_t length, const char* text);
+static bool parseZoneOverride(const uint8_t* payload, uint16_t length, ZoneOverride_t* override);
+static bool storeOffline(OfflineLog_Topic_t topic, const void* payload, size_t length, bool binary, uint32_t ageS);
+#if MQTT_APP_TELEMETRY && MQTT_TELEMETRY_BATCH != MQTT_BATCH_OFF
+static void batchAdd(float soilMoisture, float temperature, float humidity);
+static void batchFlush(void);
+#endif
+#if MQTT_APP_TELEMETRY && MQTT_TELEMETRY_DEADBAND == STD_ON
+static void publishOnChange(float soilMoisture, float temperature, float humidity);
+#endif
 static void publishHeartbeat(void);
-static void publishDummyData(void);
-static void publishDummyDecision(void);
 
 // Initialize MQTT Application Module
 void MQTT_APP_Init(void)
@@ -42,6 +101,7 @@ void MQTT_APP_Init(void)
 
     // Register message handlers for subscribed topics
     MQTT_RegisterHandler(MQTT_TOPIC_PUMP_CONTROL, MQTT_APP_OnPumpCommand);
+    MQTT_RegisterHandler(MQTT_TOPIC_ZONE_COMMAND, MQTT_APP_OnZoneCommand);
 
     DEBUG_PRINTLN("MQTT Application initialized successfully");
 #endif
@@ -52,6 +112,7 @@ void MQTT_APP_SubscribeTopics(void)
 {
 #if MQTT_ENABLED == STD_ON
     MQTT_Subscribe(MQTT_TOPIC_PUMP_CONTROL, 0);
+    MQTT_Subscribe(MQTT_TOPIC_ZONE_COMMAND, 1);
 
     DEBUG_PRINTLN("MQTT Application topics subscribed");
 #endif
@@ -60,99 +121,127 @@ void MQTT_APP_SubscribeTopics(void)
 // Publish telemetry data
 void MQTT_APP_PublishTelemetry(void)
 {
-#if MQTT_ENABLED == STD_ON && SOILMOISTURE_ENABLED == STD_ON && DHT11_ENABLED == STD_ON
-    if (!MQTT_IsConnected())
+#if MQTT_APP_TELEMETRY
+    // Telemetry keeps its own cursor on soil moisture and sends each reading
+    // at most once; a DHT field is left out unless its current value is good
+    SensorSample_t latest;
+    SensorReading_t soilMoisture;
+
+    if (SensorBus_GetLatest(SENSOR_CH_SOIL_MOISTURE, &latest) != SENSOR_QUALITY_GOOD)
     {
-        DEBUG_PRINTLN("MQTT not connected, skipping telemetry publish");
+        DEBUG_PRINTLN("No current soil moisture reading, skipping telemetry publish");
         return;
     }
+    if (SensorBus_ReadLatest(SENSORBUS_CONSUMER_TELEMETRY, SENSOR_CH_SOIL_MOISTURE, &soilMoisture) != queue_ok)
+    {
+        DEBUG_PRINTLN("No new soil moisture reading, skipping telemetry publish");
+        return;
+    }
+    float temperature = SensorBus_GetGoodValue(SENSOR_CH_TEMPERATURE);
+    float humidity = SensorBus_GetGoodValue(SENSOR_CH_HUMIDITY);
+
+#if MQTT_TELEMETRY_BATCH != MQTT_BATCH_OFF
+    batchAdd(soilMoisture.value, temperature, humidity);
+#elif MQTT_TELEMETRY_DEADBAND == STD_ON
+    publishOnChange(soilMoisture.value, temperature, humidity);
+#else
+    MQTT_APP_PublishTelemetrySample(soilMoisture.value, temperature, humidity, 0);
+#endif
+#endif
+}
 
+// Publish one telemetry record; ageS > 0 marks a record sampled that many seconds ago
+// and a NaN value leaves that field out.
+// Without a connection the record goes to the offline log; true once it is sent or stored.
+bool MQTT_APP_PublishTelemetrySample(float soilMoisture, float temperature, float humidity, uint32_t ageS)
+{
+#if MQTT_ENABLED == STD_ON
     messageCount++;
 
-    // Get sensor readings from queues
-    uint8_t soilMoistureRaw = 0;
-    SoilMoisture_getMoisture(&soilMoistureRaw);
-    float soilMoisture = (float)soilMoistureRaw;
-
-    float temperature = 0.0f;
-    DHT11_GetTemperature(&temperature);
-
-    float humidity = 0.0f;
-    DHT11_GetHumidity(&humidity);
-
-    // Create telemetry payload
-    String telemetryPayload = "{";
-    telemetryPayload += "\"site\":\"site1\",";
-    telemetryPayload += "\"node\":\"nodeA\",";
-    telemetryPayload += "\"soil_moisture\":" + String(soilMoisture, 1) + ",";
-    telemetryPayload += "\"temperature\":" + String((int)temperature) + ",";
-    telemetryPayload += "\"humidity\":" + String(humidity);
-    // Unimplemented sensors
-    // telemetryPayload += ",\"ph\":0.0,";
-    // telemetryPayload += "\"n\":0.0,";
-    // telemetryPayload += "\"p\":0.0,";
-    // telemetryPayload += "\"k\":0.0";
-    telemetryPayload += "}";
+#if MQTT_PAYLOAD_FORMAT == MQTT_PAYLOAD_BINARY
+    MQTT_CodecTelemetry_t record;
+    MQTT_Codec_InitTelemetry(&record);
+    record.soilMoisture = soilMoisture;
+    record.temperature = temperature;
+    record.humidity = humidity;
+    record.ageS = ageS;
+
+    uint8_t payload[MQTT_CODEC_MAX_SIZE];
+    size_t length = MQTT_Codec_EncodeTelemetry(payload, sizeof(payload), &record);
+    if (length == 0)
+    {
+        return false;
+    }
 
     // Publish telemetry
-    MQTT_Publish(MQTT_TOPIC_TELEMETRY, telemetryPayload.c_str(), 0, false);
+    if (MQTT_IsConnected() && MQTT_PublishRaw(MQTT_TOPIC_TELEMETRY MQTT_BINARY_TOPIC_SUFFIX, payload, length, 0, false))
+    {
+        return true;
+    }
+    return storeOffline(OFFLINE_LOG_TELEMETRY, payload, length, true, ageS);
+#else
+    JsonBuffer<MQTT_TELEMETRY_JSON_SIZE> json;
+    const char* payload = MQTT_Payload_Telemetry(&json, soilMoisture, temperature, humidity, ageS);
+    if (payload == NULL)
+    {
+        return false;
+    }
 
-    DEBUG_PRINTLN("Telemetry published: " + telemetryPayload);
+    // Publish telemetry
+    if (MQTT_IsConnected() && MQTT_Publish(MQTT_TOPIC_TELEMETRY, payload, 0, false))
+    {
+        DEBUG_PRINTLN("Telemetry published:");
+        DEBUG_PRINTLN(payload);
+        return true;
+    }
+    return storeOffline(OFFLINE_LOG_TELEMETRY, payload, json.length(), false, ageS);
+#endif
+#else
+    return false;
 #endif
 }
 
-// Publish irrigation decision
-void MQTT_APP_PublishDecision(Decision_t decision)
+// Publish irrigation decision for one zone
+void MQTT_APP_PublishDecision(Decision_t decision, uint8_t zone)
 {
 #if MQTT_ENABLED == STD_ON
-    if (!MQTT_IsConnected())
+    // Publish command based on decision; a stale actuator command is never replayed
+    JsonBuffer<MQTT_COMMAND_JSON_SIZE> command;
+    const char* commandPayload = MQTT_Payload_Command(&command, decision, zone);
+    if (commandPayload != NULL && MQTT_IsConnected())
     {
-        DEBUG_PRINTLN("MQTT not connected, skipping decision publish");
-        return;
+        MQTT_Publish(MQTT_TOPIC_COMMAND, commandPayload, MQTT_QOS_COMMAND, false, MQTT_PRIO_HIGH);
+        DEBUG_PRINTLN("Command published:");
+        DEBUG_PRINTLN(commandPayload);
     }
 
-    // Publish command based on decision
-    String commandPayload = "{";
-    if (decision == DECISION_IRRIGATE)
+    // Create decision payload (legacy, can be removed later)
+#if MQTT_PAYLOAD_FORMAT == MQTT_PAYLOAD_BINARY
+    uint8_t record[MQTT_CODEC_MAX_SIZE];
+    size_t length = MQTT_Codec_EncodeDecision(record, sizeof(record), decision, millis(), zone);
+    if (length != 0 &&
+        !(MQTT_IsConnected() && MQTT_PublishRaw(MQTT_TOPIC_IRRIGATION_DECISION MQTT_BINARY_TOPIC_SUFFIX, record, length,
+                                                  MQTT_QOS_COMMAND, false, MQTT_PRIO_HIGH)))
     {
-        commandPayload += "\"cmd\":\"ON\"";
+        storeOffline(OFFLINE_LOG_DECISION, record, length, true, 0);
     }
-    else
+#else
+    JsonBuffer<MQTT_DECISION_JSON_SIZE> record;
+    const char* decisionPayload = MQTT_Payload_Decision(&record, decision, millis(), zone);
+    if (decisionPayload != NULL)
     {
-        commandPayload += "\"cmd\":\"OFF\"";
+        // Publish decision
+        if (MQTT_IsConnected() && MQTT_Publish(MQTT_TOPIC_IRRIGATION_DECISION, decisionPayload, MQTT_QOS_COMMAND, false, MQTT_PRIO_HIGH))
+        {
+            DEBUG_PRINTLN("Decision published:");
+            DEBUG_PRINTLN(decisionPayload);
+        }
+        else
+        {
+            storeOffline(OFFLINE_LOG_DECISION, decisionPayload, record.length(), false, 0);
+        }
     }
-    commandPayload += "}";
-
-    MQTT_Publish(MQTT_TOPIC_COMMAND, commandPayload.c_str(), 0, false);
-    DEBUG_PRINTLN("Command published: " + commandPayload);
-
-    // Create decision payload (legacy, can be removed later)
-    String decisionPayload = "{";
-    decisionPayload += "\"timestamp\":" + String(millis()) + ",";
-    decisionPayload += "\"decision\":";
-
-    switch (decision)
-    {
-        case DECISION_IRRIGATE:
-            decisionPayload += "\"IRRIGATE\"";
-            break;
-        case DECISION_NO_IRRIGATION:
-            decisionPayload += "\"NO_IRRIGATION\"";
-            break;
-        case DECISION_CHECK_SYSTEM:
-            decisionPayload += "\"CHECK_SYSTEM\"";
-            break;
-        default:
-            decisionPayload += "\"UNKNOWN\"";
-            break;
-    }
-
-    decisionPayload += "}";
-
-    // Publish decision
-    MQTT_Publish(MQTT_TOPIC_IRRIGATION_DECISION, decisionPayload.c_str(), 0, false);
-
-    DEBUG_PRINTLN("Decision published: " + decisionPayload);
+#endif
 #endif
 }
 
@@ -181,26 +270,31 @@ void MQTT_APP_Setup(void) {
 void mqtt_main(void) {
     TickType_t currentTick = xTaskGetTickCount();
 
-    if (WIFI_IsConnected() && mqttInitialized) {
-        MQTT_Loop();
+    // Telemetry keeps its cadence through outages; it goes to the offline log meanwhile
+    if (currentTick - lastTelemetryTick >= pdMS_TO_TICKS(MQTT_TELEMETRY_INTERVAL_MS)) {
+        MQTT_APP_PublishTelemetry();
+        lastTelemetryTick = currentTick;
+    }
 
-        if (currentTick - lastPublishTime >= pdMS_TO_TICKS(5000)) {
+    if (WIFI_IsConnected() && mqttInitialized.load(std::memory_order_acquire)) {
+        if (currentTick - lastPublishTime >= pdMS_TO_TICKS(MQTT_HEARTBEAT_INTERVAL_MS)) {
             publishHeartbeat();
             lastPublishTime = currentTick;
         }
 
-        // Decision publishing commented out since ML task not implemented
-        // if (currentTick - lastDecisionTime >= pdMS_TO_TICKS(15000)) {
-        //     publishDummyDecision();
-        //     lastDecisionTime = currentTick;
-        // }
+        // Replay the backlog a few records at a time so live traffic keeps flowing
+        if (MQTT_IsConnected() &&
+            currentTick - lastReplayTick >= pdMS_TO_TICKS(OFFLINE_LOG_DRAIN_INTERVAL_MS)) {
+            OfflineLog_Drain(OFFLINE_LOG_DRAIN_BATCH);
+            lastReplayTick = currentTick;
+        }
     } else {
         // Print status periodically when not connected
         static TickType_t lastStatusPrint = 0;
         if (currentTick - lastStatusPrint >= pdMS_TO_TICKS(2000)) {
             if (!WIFI_IsConnected()) {
                 Serial.println("mqtt_main: Waiting for WiFi connection...");
-            } else if (!mqttInitialized) {
+            } else if (!mqttInitialized.load(std::memory_order_acquire)) {
                 Serial.println("mqtt_main: Waiting for MQTT initialization...");
             }
             lastStatusPrint = currentTick;
@@ -208,17 +302,35 @@ void mqtt_main(void) {
     }
 }
 
+// Network side: the only caller of MQTT_Loop(), so the only task that touches the client.
+// Released by SCHED_EVT_LINK_DOWN too: with WiFi gone the loop drops the session
+// and stops reconnecting at once, so publishers go to the offline log right away.
+void mqtt_net_main(void) {
+    if (mqttInitialized.load(std::memory_order_acquire) || !WIFI_IsConnected()) {
+        MQTT_Loop();
+    }
+}
+
+// Outbox has work: wake the network lane instead of waiting for its period
+static void onMqttTxPending(void) {
+    Sched_Signal(SCHED_EVT_OUTBOX);
+}
+
 // WiFi connection callback
 void onWifiConnected(void) {
     Serial.println("WiFi Connected! Initializing MQTT modules...");
 
+    // UTC for offline log timestamps
+    configTime(0, 0, NTP_SERVER);
+
 #if MQTT_ENABLED == STD_ON
-    if (!mqttInitialized) {
+    if (!mqttInitialized.load(std::memory_order_acquire)) {
         MQTT_Config_t mqttConfig = {
             .broker = MQTT_BROKER,
             .port = MQTT_PORT,
             .username = (strlen(MQTT_USERNAME) > 0) ? MQTT_USERNAME : NULL,
-            .password = (strlen(MQTT_PASSWORD) > 0) ? MQTT_PASSWORD : NULL
+            .password = (strlen(MQTT_PASSWORD) > 0) ? MQTT_PASSWORD : NULL,
+            .on_tx_pending = onMqttTxPending
         };
 
         MQTT_Init(&mqttConfig);
@@ -227,163 +339,246 @@ void onWifiConnected(void) {
 
         MQTT_APP_SubscribeTopics();
 
-        mqttInitialized = true;
+        // Publish only once the client and its handlers are set up
+        mqttInitialized.store(true, std::memory_order_release);
         Serial.println("MQTT modules initialized successfully");
     }
 #endif
+
+    Sched_Signal(SCHED_EVT_LINK_UP);
 }
 
 // WiFi disconnection callback
 void onWifiDisconnected(void) {
     Serial.println("WiFi Disconnected!");
-    mqttInitialized = false;
+    mqttInitialized.store(false, std::memory_order_release);
+
+    Sched_Signal(SCHED_EVT_LINK_DOWN);
 }
 
-// Publish dummy telemetry data
-static void publishDummyData(void) {
-#if MQTT_ENABLED == STD_ON
+#if MQTT_APP_TELEMETRY && MQTT_TELEMETRY_BATCH != MQTT_BATCH_OFF
+// Buffer one reading; a full buffer goes out as one batch or summary message
+static void batchAdd(float soilMoisture, float temperature, float humidity)
+{
+    uint32_t uptimeS = millis() / 1000;
+
+    // No link: readings go to the offline log one by one, as without batching
     if (!MQTT_IsConnected()) {
-        Serial.println("MQTT not connected, skipping telemetry publish");
+        batchFlush();
+        MQTT_APP_PublishTelemetrySample(soilMoisture, temperature, humidity, 0);
         return;
     }
 
-    dummyMessageCount++;
+    MQTT_TelemetrySample_t* sample = &batchSamples[batchCount++];
+    sample->uptimeS = uptimeS;
+    sample->soilMoisture = soilMoisture;
+    sample->temperature = temperature;
+    sample->humidity = humidity;
 
-    MQTT_APP_PublishTelemetry();
+    if (batchCount == MQTT_TELEMETRY_BATCH_SIZE) {
+        batchFlush();
+    }
+}
+
+// Publish the buffered readings. Whatever cannot go out as one message (no
+// link, outbox full, or no UTC yet for per-sample times) falls back to the
+// single-reading path with its age, which also covers the offline log.
+static void batchFlush(void)
+{
+    if (batchCount == 0) {
+        return;
+    }
 
-    Serial.println("Dummy telemetry published #" + String(dummyMessageCount) +
-                   " | RSSI: " + String(WIFI_GetRSSI()) + " dBm");
+    uint32_t uptimeS = millis() / 1000;
+    bool published = false;
+
+    if (MQTT_IsConnected()) {
+        // Only this job formats batches; keep the buffer off the lane stack
+#if MQTT_TELEMETRY_BATCH == MQTT_BATCH_SAMPLES
+        static JsonBuffer<MQTT_BATCH_JSON_SIZE> json;
+        uint32_t nowUtc = OfflineLog_Now();
+        const char* payload = (nowUtc != 0)
+            ? MQTT_Payload_TelemetryBatch(&json, batchSamples, batchCount, nowUtc, uptimeS)
+            : NULL;
+        published = payload != NULL && MQTT_Publish(MQTT_TOPIC_TELEMETRY "/batch", payload, 0, false);
+#else
+        static JsonBuffer<MQTT_SUMMARY_JSON_SIZE> json;
+        const char* payload = MQTT_Payload_TelemetrySummary(&json, batchSamples, batchCount);
+        published = payload != NULL && MQTT_Publish(MQTT_TOPIC_TELEMETRY "/summary", payload, 0, false);
 #endif
+    }
+
+    if (published) {
+        DEBUG_PRINTLN("Telemetry batch published: " + String(batchCount) + " readings");
+        // The batch shows the node is alive; the heartbeat can wait
+        lastPublishTime = xTaskGetTickCount();
+    } else {
+        for (uint8_t i = 0; i < batchCount; i++) {
+            const MQTT_TelemetrySample_t* sample = &batchSamples[i];
+            MQTT_APP_PublishTelemetrySample(sample->soilMoisture, sample->temperature,
+                                            sample->humidity, uptimeS - sample->uptimeS);
+        }
+    }
+    batchCount = 0;
 }
+#endif
 
-// Publish heartbeat/status
-static void publishHeartbeat(void) {
-#if MQTT_ENABLED == STD_ON
-    if (!MQTT_IsConnected()) {
-        Serial.println("MQTT not connected, skipping heartbeat publish");
+#if MQTT_APP_TELEMETRY && MQTT_TELEMETRY_DEADBAND == STD_ON
+// Send only the fields that are due; nothing at all when none is
+static void publishOnChange(float soilMoisture, float temperature, float humidity)
+{
+    float values[REPORT_FIELD_COUNT] = {soilMoisture, temperature, humidity};
+    TickType_t now = xTaskGetTickCount();
+    bool due = false;
+
+    for (uint8_t i = 0; i < REPORT_FIELD_COUNT; i++) {
+        const ReportField_t* field = &reportFields[i];
+        if (!isnan(values[i]) &&
+            (!field->sent ||
+             fabsf(values[i] - field->lastSent) >= field->deadband ||
+             now - field->lastSentTick >= pdMS_TO_TICKS(field->maxSilenceMs))) {
+            due = true;
+        } else {
+            values[i] = NAN;
+        }
+    }
+
+    if (!due) {
         return;
     }
 
-    String heartbeatPayload = "{";
-    heartbeatPayload += "\"site\":\"site1\",";
-    heartbeatPayload += "\"node\":\"nodeA\",";
-    heartbeatPayload += "\"online\":true";
-    heartbeatPayload += "}";
+    // Sent or stored offline counts as reported; otherwise the next reading retries
+    if (MQTT_APP_PublishTelemetrySample(values[REPORT_SOIL_MOISTURE], values[REPORT_TEMPERATURE],
+                                        values[REPORT_HUMIDITY], 0)) {
+        for (uint8_t i = 0; i < REPORT_FIELD_COUNT; i++) {
+            if (!isnan(values[i])) {
+                reportFields[i].lastSent = values[i];
+                reportFields[i].lastSentTick = now;
+                reportFields[i].sent = true;
+            }
+        }
+    }
+}
+#endif
+
+// Compare a received payload (not NUL terminated) with a command word
+static bool payloadEquals(const uint8_t* payload, uint16_t length, const char* text)
+{
+    size_t textLength = strlen(text);
+    return length == textLength && memcmp(payload, text, textLength) == 0;
+}
 
-    MQTT_Publish(MQTT_TOPIC_STATUS, heartbeatPayload.c_str(), 0, false);
+// ON / OFF / AUTO, either case
+static bool parseZoneOverride(const uint8_t* payload, uint16_t length, ZoneOverride_t* override)
+{
+    if (payloadEquals(payload, length, "ON") || payloadEquals(payload, length, "on"))
+    {
+        *override = ZONE_OVERRIDE_ON;
+    }
+    else if (payloadEquals(payload, length, "OFF") || payloadEquals(payload, length, "off"))
+    {
+        *override = ZONE_OVERRIDE_OFF;
+    }
+    else if (payloadEquals(payload, length, "AUTO") || payloadEquals(payload, length, "auto"))
+    {
+        *override = ZONE_OVERRIDE_AUTO;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
 
-    DEBUG_PRINTLN("Heartbeat published: " + heartbeatPayload);
+// Keep a payload that could not be published for replay after reconnect
+static bool storeOffline(OfflineLog_Topic_t topic, const void* payload, size_t length, bool binary, uint32_t ageS)
+{
+#if OFFLINE_LOG_ENABLED == STD_ON
+    DEBUG_PRINTLN("MQTT not connected, storing message in the offline log");
+    return OfflineLog_Append(topic, (const uint8_t*)payload, (uint16_t)length, binary, ageS);
+#else
+    DEBUG_PRINTLN("MQTT not connected, message dropped");
+    return false;
 #endif
 }
 
-// Publish dummy irrigation decision
-static void publishDummyDecision(void) {
+// Publish heartbeat/status
+static void publishHeartbeat(void) {
 #if MQTT_ENABLED == STD_ON
     if (!MQTT_IsConnected()) {
-        Serial.println("MQTT not connected, skipping decision publish");
+        Serial.println("MQTT not connected, skipping heartbeat publish");
         return;
     }
 
-    decisionCount++;
-
-    Decision_t decision;
-    switch (decisionCount % 3) {
-        case 0:
-            decision = DECISION_IRRIGATE;
-            break;
-        case 1:
-            decision = DECISION_NO_IRRIGATION;
-            break;
-        case 2:
-            decision = DECISION_CHECK_SYSTEM;
-            break;
-        default:
-            decision = DECISION_IRRIGATE;
-            break;
+#if MQTT_PAYLOAD_FORMAT == MQTT_PAYLOAD_BINARY
+    uint8_t heartbeatPayload[MQTT_CODEC_MAX_SIZE];
+    size_t length = MQTT_Codec_EncodeHeartbeat(heartbeatPayload, sizeof(heartbeatPayload), true);
+    if (length != 0)
+    {
+        MQTT_PublishRaw(MQTT_TOPIC_STATUS MQTT_BINARY_TOPIC_SUFFIX, heartbeatPayload, length, 0, false, MQTT_PRIO_HIGH);
+    }
+#else
+    JsonBuffer<MQTT_HEARTBEAT_JSON_SIZE> json;
+    const char* heartbeatPayload = MQTT_Payload_Heartbeat(&json);
+    if (heartbeatPayload == NULL)
+    {
+        return;
     }
 
-    MQTT_APP_PublishDecision(decision);
+    MQTT_Publish(MQTT_TOPIC_STATUS, heartbeatPayload, 0, false, MQTT_PRIO_HIGH);
 
-    Serial.println("Dummy decision published #" + String(decisionCount));
+    DEBUG_PRINTLN("Heartbeat published:");
+    DEBUG_PRINTLN(heartbeatPayload);
+#endif
 #endif
 }
 
-//// Handler for general commands (removed since we publish commands instead of subscribing)
-// void MQTT_APP_OnCommand(const char* payload)
-// {
-// #if MQTT_ENABLED == STD_ON
-//     DEBUG_PRINTLN("Command received: " + String(payload));
-
-//     // Parse command payload and execute business logic
-//     String payloadStr = String(payload);
-
-//     if (payloadStr.indexOf("\"cmd\":\"ON\"") != -1)
-//     {
-//         // Turn irrigation on
-//         Pump_Start();
-//         DEBUG_PRINTLN("Irrigation turned ON");
-//     }
-//     else if (payloadStr.indexOf("\"cmd\":\"OFF\"") != -1)
-//     {
-//         // Turn irrigation off
-//         Pump_Stop();
-//         DEBUG_PRINTLN("Irrigation turned OFF");
-//     }
-//     else if (strcmp(payload, "ping") == 0)
-//     {
-//         // Respond to ping
-//         MQTT_Publish("farm/site1/nodeA/response", "pong", 0, false);
-//     }
-//     else if (strcmp(payload, "status") == 0)
-//     {
-//         // Publish current status
-//         MQTT_APP_PublishTelemetry();
-//     }
-//     else if (strcmp(payload, "irrigate_now") == 0)
-//     {
-//         // Force irrigation decision
-//         MQTT_APP_PublishDecision(DECISION_IRRIGATE);
-//     }
-//     else
-//     {
-//         DEBUG_PRINTLN("Unknown command: " + String(payload));
-//     }
-// #endif
-// }
-
-// Handler for pump control commands
-void MQTT_APP_OnPumpCommand(const char* payload)
+// Handler for pump control commands; the node's pump is zone 0's output
+void MQTT_APP_OnPumpCommand(const char* topic, const uint8_t* payload, uint16_t length)
 {
 #if MQTT_ENABLED == STD_ON && PUMP_ENABLED == STD_ON
-    DEBUG_PRINTLN("Pump command received: " + String(payload));
+    DEBUG_PRINTLN("Pump command received on " + String(topic));
 
-    // Parse pump control commands and execute hardware control
-    if (strcmp(payload, "ON") == 0 || strcmp(payload, "on") == 0)
+    ZoneOverride_t override;
+    if (parseZoneOverride(payload, length, &override))
     {
-        // Turn pump on
-        Pump_Start();
-        DEBUG_PRINTLN("Pump turned ON");
+        // The zone manager owns the output and keeps it within the supply limits
+        ZoneManager_SetOverride(0, override);
+        DEBUG_PRINTLN("Pump override set to " + String((int)override));
     }
-    else if (strcmp(payload, "OFF") == 0 || strcmp(payload, "off") == 0)
-    {
-        // Turn pump off
-        Pump_Stop();
-        DEBUG_PRINTLN("Pump turned OFF");
-    }
-    else if (strcmp(payload, "STATUS") == 0 || strcmp(payload, "status") == 0)
+    else if (payloadEquals(payload, length, "STATUS") || payloadEquals(payload, length, "status"))
     {
         // Report pump status
-        String statusPayload = "{\"pumpStatus\":\"";
-        // TODO: Get actual pump status
-        statusPayload += "unknown";
-        statusPayload += "\"}";
-
-        MQTT_Publish("farm/site1/nodeA/pump_response", statusPayload.c_str(), 0, false);
+        JsonBuffer<MQTT_PUMPSTATUS_JSON_SIZE> json;
+        const char* statusPayload = MQTT_Payload_PumpStatus(&json, ZoneManager_IsWatering(0) ? "on" : "off");
+        if (statusPayload != NULL)
+        {
+            MQTT_Publish("farm/site1/nodeA/pump_response", statusPayload, 0, false, MQTT_PRIO_HIGH);
+        }
     }
     else
     {
-        DEBUG_PRINTLN("Unknown pump command: " + String(payload));
+        DEBUG_PRINTLN("Unknown pump command, " + String(length) + " bytes");
+    }
+#endif
+}
+
+// Handler for farm/site1/nodeA/zone/<zone>/cmd: ON, OFF, or AUTO to hand the zone back to the model
+void MQTT_APP_OnZoneCommand(const char* topic, const uint8_t* payload, uint16_t length)
+{
+#if MQTT_ENABLED == STD_ON && PUMP_ENABLED == STD_ON
+    // The filter guarantees the prefix; the level after it is the zone index
+    const char* level = topic + sizeof(MQTT_TOPIC_ZONE_PREFIX) - 1;
+    char* end;
+    unsigned long zone = strtoul(level, &end, 10);
+    ZoneOverride_t override;
+
+    if (end == level || *end != '/' || !parseZoneOverride(payload, length, &override) ||
+        !ZoneManager_SetOverride((uint8_t)(zone < 0xFF ? zone : 0xFF), override))
+    {
+        DEBUG_PRINTLN("Bad zone command on " + String(topic));
+        return;
     }
+    DEBUG_PRINTLN("Zone " + String(zone) + " override set to " + String((int)override));
 #endif
 }
-*/
\ No newline at end of file
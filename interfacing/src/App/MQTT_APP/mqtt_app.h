@@ -1,6 +1,8 @@
 #ifndef MQTT_APP_H
 #define MQTT_APP_H
 
+#include <stdint.h>
+
 // Decision types for irrigation system
 typedef enum {
     DECISION_IRRIGATE = 0,
@@ -15,13 +17,15 @@ typedef enum {
 void MQTT_APP_Init(void);
 void MQTT_APP_Setup(void);
 void mqtt_main(void);
+void mqtt_net_main(void);
 
 void MQTT_APP_SubscribeTopics(void);
 void MQTT_APP_PublishTelemetry(void);
-void MQTT_APP_PublishDecision(Decision_t decision);
+bool MQTT_APP_PublishTelemetrySample(float soilMoisture, float temperature, float humidity, uint32_t ageS);
+void MQTT_APP_PublishDecision(Decision_t decision, uint8_t zone = 0);
 
 // Message handlers for incoming commands
-void MQTT_APP_OnCommand(const char* payload);
-void MQTT_APP_OnPumpCommand(const char* payload);
+void MQTT_APP_OnPumpCommand(const char* topic, const uint8_t* payload, uint16_t length);
+void MQTT_APP_OnZoneCommand(const char* topic, const uint8_t* payload, uint16_t length);
 
 #endif // MQTT_APP_H
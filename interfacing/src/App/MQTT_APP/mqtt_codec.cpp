@@ -0,0 +1,144 @@
+#include <math.h>
+#include "mqtt_codec.h"
+
+typedef struct
+{
+    uint8_t* buffer;
+    size_t size;
+    size_t length;
+    uint16_t mask;
+    bool overflow;
+} CodecWriter_t;
+
+static void codecBegin(CodecWriter_t* w, uint8_t* buffer, size_t size, MQTT_CodecType_t type)
+{
+    w->buffer = buffer;
+    w->size = size;
+    w->length = MQTT_CODEC_HEADER_SIZE;
+    w->mask = 0;
+    w->overflow = size < MQTT_CODEC_HEADER_SIZE;
+    if (!w->overflow)
+    {
+        buffer[0] = (uint8_t)((MQTT_CODEC_VERSION << 4) | (uint8_t)type);
+    }
+}
+
+static void codecPut(CodecWriter_t* w, uint16_t bit, uint32_t value, uint8_t width)
+{
+    if (w->overflow || w->length + width > w->size)
+    {
+        w->overflow = true;
+        return;
+    }
+    for (uint8_t i = 0; i < width; i++)
+    {
+        w->buffer[w->length++] = (uint8_t)(value >> (8 * i));
+    }
+    w->mask |= bit;
+}
+
+// Scaled fixed-point field; NaN or out of range leaves the field out
+static void codecPutScaled(CodecWriter_t* w, uint16_t bit, float value, float scale, bool isSigned)
+{
+    if (isnan(value))
+    {
+        return;
+    }
+    float scaled = roundf(value * scale);
+    if (isSigned ? (scaled < -32768.0f || scaled > 32767.0f) : (scaled < 0.0f || scaled > 65535.0f))
+    {
+        return;
+    }
+    codecPut(w, bit, isSigned ? (uint32_t)(uint16_t)(int16_t)scaled : (uint32_t)scaled, 2);
+}
+
+static size_t codecEnd(CodecWriter_t* w)
+{
+    if (w->overflow)
+    {
+        return 0;
+    }
+    w->buffer[1] = (uint8_t)w->mask;
+    w->buffer[2] = (uint8_t)(w->mask >> 8);
+    return w->length;
+}
+
+void MQTT_Codec_InitTelemetry(MQTT_CodecTelemetry_t* record)
+{
+    record->soilMoisture = NAN;
+    record->temperature = NAN;
+    record->humidity = NAN;
+    record->ph = NAN;
+    record->n = NAN;
+    record->p = NAN;
+    record->k = NAN;
+    record->ageS = 0;
+}
+
+size_t MQTT_Codec_EncodeTelemetry(uint8_t* buffer, size_t size, const MQTT_CodecTelemetry_t* record)
+{
+    CodecWriter_t w;
+    codecBegin(&w, buffer, size, MQTT_CODEC_TELEMETRY);
+    codecPutScaled(&w, MQTT_CODEC_TEL_SOIL_MOISTURE, record->soilMoisture, 10.0f, false);
+    codecPutScaled(&w, MQTT_CODEC_TEL_TEMPERATURE, record->temperature, 10.0f, true);
+    codecPutScaled(&w, MQTT_CODEC_TEL_HUMIDITY, record->humidity, 10.0f, false);
+    if (record->ageS > 0)
+    {
+        codecPut(&w, MQTT_CODEC_TEL_AGE_S, record->ageS, 4);
+    }
+    codecPutScaled(&w, MQTT_CODEC_TEL_PH, record->ph, 100.0f, false);
+    codecPutScaled(&w, MQTT_CODEC_TEL_N, record->n, 10.0f, false);
+    codecPutScaled(&w, MQTT_CODEC_TEL_P, record->p, 10.0f, false);
+    codecPutScaled(&w, MQTT_CODEC_TEL_K, record->k, 10.0f, false);
+    return codecEnd(&w);
+}
+
+size_t MQTT_Codec_EncodeDecision(uint8_t* buffer, size_t size, Decision_t decision, uint32_t timestamp,
+                                 uint8_t zone)
+{
+    CodecWriter_t w;
+    codecBegin(&w, buffer, size, MQTT_CODEC_DECISION);
+    codecPut(&w, MQTT_CODEC_DEC_DECISION, (uint32_t)decision, 1);
+    codecPut(&w, MQTT_CODEC_DEC_TIMESTAMP, timestamp, 4);
+    codecPut(&w, MQTT_CODEC_DEC_ZONE, zone, 1);
+    return codecEnd(&w);
+}
+
+size_t MQTT_Codec_EncodeHeartbeat(uint8_t* buffer, size_t size, bool online)
+{
+    CodecWriter_t w;
+    codecBegin(&w, buffer, size, MQTT_CODEC_HEARTBEAT);
+    codecPut(&w, MQTT_CODEC_HB_ONLINE, online ? 1 : 0, 1);
+    return codecEnd(&w);
+}
+
+size_t MQTT_Codec_AppendTimestamp(uint8_t* buffer, size_t length, size_t size, uint32_t ts)
+{
+    if (length < MQTT_CODEC_HEADER_SIZE || length + 4 > size || (buffer[0] >> 4) != MQTT_CODEC_VERSION)
+    {
+        return 0;
+    }
+
+    uint16_t bit;
+    switch ((MQTT_CodecType_t)(buffer[0] & 0x0F))
+    {
+        case MQTT_CODEC_TELEMETRY:
+            bit = MQTT_CODEC_TEL_TS;
+            break;
+        case MQTT_CODEC_DECISION:
+            bit = MQTT_CODEC_DEC_TS;
+            break;
+        default:
+            return 0;
+    }
+
+    uint16_t mask = (uint16_t)(buffer[1] | (buffer[2] << 8));
+    if (mask >= bit)
+    {
+        return 0;   // already stamped, or carries fields after it
+    }
+
+    CodecWriter_t w = {buffer, size, length, mask, false};
+    codecPut(&w, bit, ts, 4);
+    return codecEnd(&w);
+}
@@ -0,0 +1,83 @@
+#ifndef MQTT_CODEC_H
+#define MQTT_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mqtt_app.h"
+
+// Compact binary payloads (MQTT_PAYLOAD_FORMAT == MQTT_PAYLOAD_BINARY)
+//
+// Published on "<json topic>/bin"; cloud/bridge/binary_bridge.py turns them
+// back into the JSON the rest of the stack expects. Site and node are not
+// sent: they are already in the topic.
+//
+//   byte 0      version << 4 | message type
+//   byte 1..2   field mask, little endian, bit n = field n present
+//   ...         present fields in bit order, little endian, fixed width
+//
+// A decoder stops at the first mask bit it does not know. Fields are written in
+// bit order, so a new field takes the next free bit and older decoders still
+// read everything before it. Changing an existing encoding needs a new version.
+// The UTC timestamp is always the last bit of its message type.
+//
+// Version 2: decisions carry their zone, ahead of the timestamp.
+
+#define MQTT_CODEC_VERSION          2
+
+typedef enum
+{
+    MQTT_CODEC_TELEMETRY = 1,
+    MQTT_CODEC_DECISION  = 2,
+    MQTT_CODEC_HEARTBEAT = 3
+} MQTT_CodecType_t;
+
+// Telemetry fields
+#define MQTT_CODEC_TEL_SOIL_MOISTURE  (1u << 0)   // uint16, 0.1 %
+#define MQTT_CODEC_TEL_TEMPERATURE    (1u << 1)   // int16,  0.1 C
+#define MQTT_CODEC_TEL_HUMIDITY       (1u << 2)   // uint16, 0.1 %
+#define MQTT_CODEC_TEL_AGE_S          (1u << 3)   // uint32, s
+#define MQTT_CODEC_TEL_PH             (1u << 4)   // uint16, 0.01
+#define MQTT_CODEC_TEL_N              (1u << 5)   // uint16, 0.1
+#define MQTT_CODEC_TEL_P              (1u << 6)   // uint16, 0.1
+#define MQTT_CODEC_TEL_K              (1u << 7)   // uint16, 0.1
+#define MQTT_CODEC_TEL_TS             (1u << 8)   // uint32, UTC s, replayed records only
+
+// Decision fields
+#define MQTT_CODEC_DEC_DECISION       (1u << 0)   // uint8, Decision_t
+#define MQTT_CODEC_DEC_TIMESTAMP      (1u << 1)   // uint32, ms since boot
+#define MQTT_CODEC_DEC_ZONE           (1u << 2)   // uint8, zone index
+#define MQTT_CODEC_DEC_TS             (1u << 3)   // uint32, UTC s, replayed records only
+
+// Heartbeat fields
+#define MQTT_CODEC_HB_ONLINE          (1u << 0)   // uint8
+
+#define MQTT_CODEC_HEADER_SIZE        3
+#define MQTT_CODEC_MAX_SIZE           (MQTT_CODEC_HEADER_SIZE + 7 * 2 + 4 + 4)
+
+// Telemetry record; NaN marks a field that is not sent
+typedef struct
+{
+    float soilMoisture;
+    float temperature;
+    float humidity;
+    float ph;
+    float n;
+    float p;
+    float k;
+    uint32_t ageS;          // 0 = current reading, not sent
+} MQTT_CodecTelemetry_t;
+
+void MQTT_Codec_InitTelemetry(MQTT_CodecTelemetry_t* record);
+
+// Encoders return the payload length, 0 if it does not fit
+size_t MQTT_Codec_EncodeTelemetry(uint8_t* buffer, size_t size, const MQTT_CodecTelemetry_t* record);
+size_t MQTT_Codec_EncodeDecision(uint8_t* buffer, size_t size, Decision_t decision, uint32_t timestamp,
+                                 uint8_t zone);
+size_t MQTT_Codec_EncodeHeartbeat(uint8_t* buffer, size_t size, bool online);
+
+// Add the UTC timestamp field to an encoded telemetry or decision payload in
+// place. It is the highest bit, so it always goes last. Returns the new
+// length, 0 if the payload cannot take it.
+size_t MQTT_Codec_AppendTimestamp(uint8_t* buffer, size_t length, size_t size, uint32_t ts);
+
+#endif // MQTT_CODEC_H
@@ -0,0 +1,187 @@
+#include <math.h>
+#include "mqtt_payload.h"
+
+const char* MQTT_Payload_Telemetry(JsonWriter* json, float soilMoisture, float temperature,
+                                   float humidity, uint32_t ageS)
+{
+    json->beginObject();
+    json->add(telemetrySchema[TELEMETRY_SITE], MQTT_SITE_ID);
+    json->add(telemetrySchema[TELEMETRY_NODE], MQTT_NODE_ID);
+    // NaN leaves a field out, as in the binary codec
+    if (!isnan(soilMoisture))
+    {
+        json->add(telemetrySchema[TELEMETRY_SOIL_MOISTURE], soilMoisture);
+    }
+    if (!isnan(temperature))
+    {
+        json->add(telemetrySchema[TELEMETRY_TEMPERATURE], (int32_t)temperature);
+    }
+    if (!isnan(humidity))
+    {
+        json->add(telemetrySchema[TELEMETRY_HUMIDITY], humidity);
+    }
+    if (ageS > 0)
+    {
+        json->add(telemetrySchema[TELEMETRY_AGE_S], ageS);
+    }
+    return json->endObject();
+}
+
+const char* MQTT_Payload_Heartbeat(JsonWriter* json)
+{
+    json->beginObject();
+    json->add(heartbeatSchema[HEARTBEAT_SITE], MQTT_SITE_ID);
+    json->add(heartbeatSchema[HEARTBEAT_NODE], MQTT_NODE_ID);
+    json->add(heartbeatSchema[HEARTBEAT_ONLINE], true);
+    return json->endObject();
+}
+
+const char* MQTT_Payload_Command(JsonWriter* json, Decision_t decision, uint8_t zone)
+{
+    json->beginObject();
+    json->add(commandSchema[COMMAND_CMD], decision == DECISION_IRRIGATE ? "ON" : "OFF");
+#if ZONE_COUNT > 1
+    json->add(commandSchema[COMMAND_ZONE], (uint32_t)zone);
+#else
+    (void)zone;
+#endif
+    return json->endObject();
+}
+
+const char* MQTT_Payload_Decision(JsonWriter* json, Decision_t decision, uint32_t timestamp, uint8_t zone)
+{
+    const char* name;
+    switch (decision)
+    {
+        case DECISION_IRRIGATE:
+            name = "IRRIGATE";
+            break;
+        case DECISION_NO_IRRIGATION:
+            name = "NO_IRRIGATION";
+            break;
+        case DECISION_CHECK_SYSTEM:
+            name = "CHECK_SYSTEM";
+            break;
+        default:
+            name = "UNKNOWN";
+            break;
+    }
+
+    json->beginObject();
+    json->add(decisionSchema[DECISION_TIMESTAMP], timestamp);
+    json->add(decisionSchema[DECISION_DECISION], name);
+#if ZONE_COUNT > 1
+    json->add(decisionSchema[DECISION_ZONE], (uint32_t)zone);
+#else
+    (void)zone;
+#endif
+    return json->endObject();
+}
+
+const char* MQTT_Payload_PumpStatus(JsonWriter* json, const char* status)
+{
+    json->beginObject();
+    json->add(pumpStatusSchema[PUMP_STATUS], status);
+    return json->endObject();
+}
+
+const char* MQTT_Payload_TelemetryBatch(JsonWriter* json, const MQTT_TelemetrySample_t* samples,
+                                        uint8_t count, uint32_t nowUtc, uint32_t nowUptimeS)
+{
+    json->beginObject();
+    json->beginArray(batchSchema[BATCH_SAMPLES]);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        json->beginElement();
+        json->add(batchSampleSchema[SAMPLE_TIME], nowUtc - (nowUptimeS - samples[i].uptimeS));
+        json->add(batchSampleSchema[SAMPLE_SOIL_MOISTURE], samples[i].soilMoisture);
+        // NaN leaves a field out, as in a single reading
+        if (!isnan(samples[i].temperature))
+        {
+            json->add(batchSampleSchema[SAMPLE_TEMPERATURE], samples[i].temperature);
+        }
+        if (!isnan(samples[i].humidity))
+        {
+            json->add(batchSampleSchema[SAMPLE_HUMIDITY], samples[i].humidity);
+        }
+        json->endElement();
+    }
+    json->endArray();
+    return json->endObject();
+}
+
+const char* MQTT_Payload_TelemetrySummary(JsonWriter* json, const MQTT_TelemetrySample_t* samples,
+                                          uint8_t count)
+{
+    if (count == 0)
+    {
+        return NULL;
+    }
+
+    // A NaN sample (no good reading) is left out of its channel, and a
+    // channel with no sample left is left out of the summary
+    float minimum[3] = {0.0f, 0.0f, 0.0f};
+    float maximum[3] = {0.0f, 0.0f, 0.0f};
+    float sum[3] = {0.0f, 0.0f, 0.0f};
+    uint8_t used[3] = {0, 0, 0};
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const float values[3] = {samples[i].soilMoisture, samples[i].temperature, samples[i].humidity};
+        for (uint8_t k = 0; k < 3; k++)
+        {
+            if (isnan(values[k]))
+            {
+                continue;
+            }
+            minimum[k] = used[k] == 0 || values[k] < minimum[k] ? values[k] : minimum[k];
+            maximum[k] = used[k] == 0 || values[k] > maximum[k] ? values[k] : maximum[k];
+            sum[k] += values[k];
+            used[k]++;
+        }
+    }
+
+    json->beginObject();
+    json->add(summarySchema[SUMMARY_COUNT], (uint32_t)count);
+    json->add(summarySchema[SUMMARY_WINDOW_S], samples[count - 1].uptimeS - samples[0].uptimeS);
+    for (uint8_t k = 0; k < 3; k++)
+    {
+        if (used[k] == 0)
+        {
+            continue;
+        }
+        // min, max, mean per channel, in schema order
+        json->add(summarySchema[SUMMARY_SOIL_MIN + 3 * k], minimum[k]);
+        json->add(summarySchema[SUMMARY_SOIL_MAX + 3 * k], maximum[k]);
+        json->add(summarySchema[SUMMARY_SOIL_MEAN + 3 * k], sum[k] / used[k]);
+    }
+    return json->endObject();
+}
+
+#if PERF_ENABLED == STD_ON
+const char* MQTT_Payload_PerfTask(JsonWriter* json, const char* name, uint32_t stackSize, uint32_t stackFree)
+{
+    json->beginObject();
+    json->add(perfTaskSchema[PERF_TASK_TASK], name);
+    json->add(perfTaskSchema[PERF_TASK_STACK], stackSize);
+    json->add(perfTaskSchema[PERF_TASK_STACK_FREE], stackFree);
+    return json->endObject();
+}
+
+const char* MQTT_Payload_PerfSection(JsonWriter* json, const Perf_SectionReport_t* report)
+{
+    json->beginObject();
+    json->add(perfSectionSchema[PERF_SECTION_SECTION], report->name);
+    json->add(perfSectionSchema[PERF_SECTION_N], report->count);
+    json->add(perfSectionSchema[PERF_SECTION_MIN_US], report->minUs);
+    json->add(perfSectionSchema[PERF_SECTION_AVG_US], report->avgUs);
+    json->add(perfSectionSchema[PERF_SECTION_MAX_US], report->maxUs);
+    json->add(perfSectionSchema[PERF_SECTION_LOAD_PCT], report->loadPct);
+    json->add(perfSectionSchema[PERF_SECTION_WINDOW_S], report->windowS);
+    for (uint8_t i = 0; i < PERF_HIST_BUCKETS; i++)
+    {
+        json->add(perfSectionSchema[PERF_SECTION_HIST + i], report->histogram[i]);
+    }
+    return json->endObject();
+}
+#endif
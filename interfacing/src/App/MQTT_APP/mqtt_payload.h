@@ -0,0 +1,157 @@
+#ifndef MQTT_PAYLOAD_H
+#define MQTT_PAYLOAD_H
+
+#include <stdint.h>
+#include "mqtt_app.h"
+#include "../../APP_Cfg.h"
+#include "../../Utils/JsonWriter/JsonWriter.h"
+#include "../Perf/Perf.h"
+
+// Outgoing JSON payload schemas and formatters
+// Every payload is written into a fixed buffer sized for its schema's worst
+// case at compile time: no String, no heap.
+
+enum { TELEMETRY_SITE, TELEMETRY_NODE, TELEMETRY_SOIL_MOISTURE, TELEMETRY_TEMPERATURE,
+       TELEMETRY_HUMIDITY, TELEMETRY_AGE_S };
+static constexpr JsonField_t telemetrySchema[] = {
+    JSON_FIELD_STRING("site", sizeof(MQTT_SITE_ID) - 1),
+    JSON_FIELD_STRING("node", sizeof(MQTT_NODE_ID) - 1),
+    JSON_FIELD_FLOAT("soil_moisture", 1),
+    JSON_FIELD_INT("temperature"),
+    JSON_FIELD_FLOAT("humidity", 2),
+    JSON_FIELD_INT("age_s"),                // optional: replayed records only
+};
+
+enum { HEARTBEAT_SITE, HEARTBEAT_NODE, HEARTBEAT_ONLINE };
+static constexpr JsonField_t heartbeatSchema[] = {
+    JSON_FIELD_STRING("site", sizeof(MQTT_SITE_ID) - 1),
+    JSON_FIELD_STRING("node", sizeof(MQTT_NODE_ID) - 1),
+    JSON_FIELD_BOOL("online"),
+};
+
+// "zone" only on nodes with ZONE_COUNT > 1
+enum { COMMAND_CMD, COMMAND_ZONE };
+static constexpr JsonField_t commandSchema[] = {
+    JSON_FIELD_STRING("cmd", 3),
+    JSON_FIELD_INT("zone"),
+};
+
+enum { DECISION_TIMESTAMP, DECISION_DECISION, DECISION_ZONE };
+static constexpr JsonField_t decisionSchema[] = {
+    JSON_FIELD_INT("timestamp"),
+    JSON_FIELD_STRING("decision", 13),      // NO_IRRIGATION
+    JSON_FIELD_INT("zone"),
+};
+
+// Telemetry batch (MQTT_TELEMETRY_BATCH == MQTT_BATCH_SAMPLES). Site and node
+// come from the topic; short keys keep a batch inside one outbox slot.
+enum { BATCH_SAMPLES };
+static constexpr JsonField_t batchSchema[] = {
+    JSON_FIELD_ARRAY("samples"),
+};
+
+enum { SAMPLE_TIME, SAMPLE_SOIL_MOISTURE, SAMPLE_TEMPERATURE, SAMPLE_HUMIDITY };
+static constexpr JsonField_t batchSampleSchema[] = {
+    JSON_FIELD_INT("t"),                    // UTC seconds
+    JSON_FIELD_FLOAT("sm", 1),              // soil_moisture
+    JSON_FIELD_FLOAT("tc", 1),              // temperature
+    JSON_FIELD_FLOAT("rh", 1),              // humidity
+};
+
+// Telemetry summary (MQTT_TELEMETRY_BATCH == MQTT_BATCH_SUMMARY)
+enum { SUMMARY_COUNT, SUMMARY_WINDOW_S,
+       SUMMARY_SOIL_MIN, SUMMARY_SOIL_MAX, SUMMARY_SOIL_MEAN,
+       SUMMARY_TEMP_MIN, SUMMARY_TEMP_MAX, SUMMARY_TEMP_MEAN,
+       SUMMARY_HUM_MIN, SUMMARY_HUM_MAX, SUMMARY_HUM_MEAN };
+static constexpr JsonField_t summarySchema[] = {
+    JSON_FIELD_INT("count"),
+    JSON_FIELD_INT("window_s"),
+    JSON_FIELD_FLOAT("soil_moisture_min", 1),
+    JSON_FIELD_FLOAT("soil_moisture_max", 1),
+    JSON_FIELD_FLOAT("soil_moisture_mean", 1),
+    JSON_FIELD_FLOAT("temperature_min", 1),
+    JSON_FIELD_FLOAT("temperature_max", 1),
+    JSON_FIELD_FLOAT("temperature_mean", 1),
+    JSON_FIELD_FLOAT("humidity_min", 1),
+    JSON_FIELD_FLOAT("humidity_max", 1),
+    JSON_FIELD_FLOAT("humidity_mean", 1),
+};
+
+enum { PUMP_STATUS };
+static constexpr JsonField_t pumpStatusSchema[] = {
+    JSON_FIELD_STRING("pumpStatus", 7),
+};
+
+// Profiling reports on MQTT_TOPIC_PERF (PERF_ENABLED), one task or one section
+// per message. Stack values are bytes; hist buckets hold run counts.
+enum { PERF_TASK_TASK, PERF_TASK_STACK, PERF_TASK_STACK_FREE };
+static constexpr JsonField_t perfTaskSchema[] = {
+    JSON_FIELD_STRING("task", PERF_NAME_MAX),
+    JSON_FIELD_INT("stack"),
+    JSON_FIELD_INT("stack_free"),           // high-water mark: least ever free
+};
+
+enum { PERF_SECTION_SECTION, PERF_SECTION_N, PERF_SECTION_MIN_US, PERF_SECTION_AVG_US,
+       PERF_SECTION_MAX_US, PERF_SECTION_LOAD_PCT, PERF_SECTION_WINDOW_S, PERF_SECTION_HIST };
+static constexpr JsonField_t perfSectionSchema[] = {
+    JSON_FIELD_STRING("section", PERF_NAME_MAX),
+    JSON_FIELD_INT("n"),
+    JSON_FIELD_INT("min_us"),
+    JSON_FIELD_INT("avg_us"),
+    JSON_FIELD_INT("max_us"),
+    JSON_FIELD_FLOAT("load_pct", 2),
+    JSON_FIELD_INT("window_s"),
+    // PERF_HIST_BUCKETS buckets, PERF_HIST_FIRST_US apart by 4x
+    JSON_FIELD_INT("lt64us"),
+    JSON_FIELD_INT("lt256us"),
+    JSON_FIELD_INT("lt1ms"),
+    JSON_FIELD_INT("lt4ms"),
+    JSON_FIELD_INT("lt16ms"),
+    JSON_FIELD_INT("lt64ms"),
+    JSON_FIELD_INT("lt256ms"),
+    JSON_FIELD_INT("ge256ms"),
+};
+static_assert(sizeof(perfSectionSchema) / sizeof(perfSectionSchema[0]) == PERF_SECTION_HIST + PERF_HIST_BUCKETS,
+              "one perf histogram field per bucket");
+
+#define MQTT_TELEMETRY_JSON_SIZE   (JsonWriter_MaxLength(telemetrySchema) + 1)
+#define MQTT_HEARTBEAT_JSON_SIZE   (JsonWriter_MaxLength(heartbeatSchema) + 1)
+#define MQTT_COMMAND_JSON_SIZE     (JsonWriter_MaxLength(commandSchema) + 1)
+#define MQTT_DECISION_JSON_SIZE    (JsonWriter_MaxLength(decisionSchema) + 1)
+#define MQTT_PUMPSTATUS_JSON_SIZE  (JsonWriter_MaxLength(pumpStatusSchema) + 1)
+#define MQTT_BATCH_JSON_SIZE       (JsonWriter_MaxLength(batchSchema) + \
+                                    MQTT_TELEMETRY_BATCH_SIZE * (JsonWriter_MaxLength(batchSampleSchema) + 1) + 1)
+#define MQTT_SUMMARY_JSON_SIZE     (JsonWriter_MaxLength(summarySchema) + 1)
+#define MQTT_PERF_TASK_JSON_SIZE   (JsonWriter_MaxLength(perfTaskSchema) + 1)
+#define MQTT_PERF_SECTION_JSON_SIZE (JsonWriter_MaxLength(perfSectionSchema) + 1)
+
+// One buffered telemetry reading
+typedef struct
+{
+    uint32_t uptimeS;           // when it was sampled
+    float soilMoisture;
+    float temperature;
+    float humidity;
+} MQTT_TelemetrySample_t;
+
+// Formatters return the payload, or NULL if it did not fit the writer's buffer.
+// A NaN telemetry value is left out of the payload.
+const char* MQTT_Payload_Telemetry(JsonWriter* json, float soilMoisture, float temperature,
+                                   float humidity, uint32_t ageS);
+const char* MQTT_Payload_Heartbeat(JsonWriter* json);
+const char* MQTT_Payload_Command(JsonWriter* json, Decision_t decision, uint8_t zone = 0);
+const char* MQTT_Payload_Decision(JsonWriter* json, Decision_t decision, uint32_t timestamp, uint8_t zone = 0);
+const char* MQTT_Payload_PumpStatus(JsonWriter* json, const char* status);
+
+// nowUtc/nowUptimeS map each sample's uptime to UTC
+const char* MQTT_Payload_TelemetryBatch(JsonWriter* json, const MQTT_TelemetrySample_t* samples,
+                                        uint8_t count, uint32_t nowUtc, uint32_t nowUptimeS);
+const char* MQTT_Payload_TelemetrySummary(JsonWriter* json, const MQTT_TelemetrySample_t* samples,
+                                          uint8_t count);
+
+#if PERF_ENABLED == STD_ON
+const char* MQTT_Payload_PerfTask(JsonWriter* json, const char* name, uint32_t stackSize, uint32_t stackFree);
+const char* MQTT_Payload_PerfSection(JsonWriter* json, const Perf_SectionReport_t* report);
+#endif
+
+#endif // MQTT_PAYLOAD_H
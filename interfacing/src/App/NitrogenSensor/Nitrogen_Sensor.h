@@ -13,12 +13,6 @@ typedef struct{
     ADC_t adcConfig;
 }Nitrogen_t;
 
-typedef enum
-{
-    queue_ok,
-    queue_empty,
-}queue_t;
-
 void NitrogenSensor_init(void);
 
 void NitrogenSensor_main(void);
@@ -0,0 +1,505 @@
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "OfflineLog.h"
+#include "../MQTT_APP/mqtt_codec.h"
+#include "../Power/Power.h"
+#include "../../Hal/MQTT/mqtt_core.h"
+#include "../../Utils/Crc32/Crc32.h"
+
+#if OFFLINE_LOG_DEBUG == STD_ON
+#define DEBUG_PRINTLN(var) Serial.println(var)
+#else
+#define DEBUG_PRINTLN(var)
+#endif
+
+#define OLOG_DIR              "/olog"
+#define OLOG_CURSOR_PATH      "/olog.pos"   // replay position, outside OLOG_DIR
+#define OLOG_RECORD_MAGIC     0xA5
+#define OLOG_FLAG_BINARY      0x01
+#define OLOG_FLAG_RELATIVE    0x02          // time is seconds on the node clock clockId
+#define OLOG_TIME_VALID       1600000000UL  // anything earlier: SNTP has not synced
+#define OLOG_TS_JSON_SIZE     20            // ,"ts":4294967295}
+
+typedef struct __attribute__((packed))
+{
+    uint8_t magic;
+    uint8_t topic;              // OfflineLog_Topic_t
+    uint8_t flags;
+    uint8_t reserved;
+    uint16_t length;            // payload bytes following the header
+    uint32_t time;
+    uint32_t clockId;           // relative records: the clock time counts on
+    uint32_t crc;               // header with crc = 0, then payload
+} OfflineLog_Header_t;
+
+typedef struct
+{
+    uint32_t seq;               // segment the offset is in
+    uint32_t offset;            // bytes of it the broker has acknowledged
+    uint32_t crc;               // seq and offset
+} OfflineLog_Cursor_t;
+
+#if OFFLINE_LOG_ENABLED == STD_ON
+// Replay topics, JSON and binary
+static const char* const replayTopics[OFFLINE_LOG_TOPIC_COUNT][2] = {
+    {MQTT_TOPIC_TELEMETRY "/replay", MQTT_TOPIC_TELEMETRY "/replay" MQTT_BINARY_TOPIC_SUFFIX},
+    {MQTT_TOPIC_IRRIGATION_DECISION "/replay", MQTT_TOPIC_IRRIGATION_DECISION "/replay" MQTT_BINARY_TOPIC_SUFFIX}
+};
+
+static SemaphoreHandle_t logMutex = NULL;
+static bool logReady = false;
+static uint32_t bootId = 0;
+static uint32_t oldestSeq = 0;          // segment being replayed
+static uint32_t newestSeq = 0;          // segment being appended to
+static uint32_t newestSize = 0;
+static uint32_t readOffset = 0;         // replay position in the oldest segment, queued so far
+static uint32_t syncedOffset = 0;       // the part of it acknowledged and kept in OLOG_CURSOR_PATH
+static uint32_t pendingBytes = 0;
+
+// Only touched with logMutex held
+static uint8_t recordBuffer[OFFLINE_LOG_MAX_PAYLOAD];
+static char replayBuffer[OFFLINE_LOG_MAX_PAYLOAD + OLOG_TS_JSON_SIZE];
+
+// Clock for records made before SNTP has synced. With a duty cycle it is the
+// Power clock, which keeps counting across deep sleep; otherwise this boot's
+// uptime.
+static uint32_t olClockS(uint32_t* clockId)
+{
+#if POWER_MODE != POWER_MODE_ALWAYS_ON
+    return Power_GetClockS(clockId);
+#else
+    *clockId = bootId;
+    return millis() / 1000;
+#endif
+}
+
+static void olSegmentPath(char* path, size_t size, uint32_t seq)
+{
+    snprintf(path, size, OLOG_DIR "/%08lx.seg", (unsigned long)seq);
+}
+
+static uint32_t olRecordCrc(const OfflineLog_Header_t* header, const uint8_t* payload)
+{
+    OfflineLog_Header_t copy = *header;
+    copy.crc = 0;
+    uint32_t crc = Crc32_Update(0, &copy, sizeof(copy));
+    return Crc32_Update(crc, payload, header->length);
+}
+
+// Remove the oldest segment and account for whatever was not replayed from it
+static void olDropOldest(void)
+{
+    char path[24];
+    olSegmentPath(path, sizeof(path), oldestSeq);
+
+    uint32_t size = 0;
+    File file = LittleFS.open(path, FILE_READ);
+    if (file)
+    {
+        size = file.size();
+        file.close();
+    }
+    LittleFS.remove(path);
+
+    uint32_t unread = size > readOffset ? size - readOffset : 0;
+    pendingBytes -= unread < pendingBytes ? unread : pendingBytes;
+    readOffset = 0;
+
+    // The cursor points into the removed segment
+    if (syncedOffset > 0)
+    {
+        LittleFS.remove(OLOG_CURSOR_PATH);
+        syncedOffset = 0;
+    }
+
+    if (oldestSeq == newestSeq)
+    {
+        // That was the whole log; the next append recreates the segment
+        newestSize = 0;
+        pendingBytes = 0;
+    }
+    else
+    {
+        oldestSeq++;
+    }
+}
+
+// Publish one stored record on its replay topic at QoS 1, so the outbox resends
+// it until the broker has it; true when it is done with (queued, or dropped
+// because it can no longer be sent meaningfully)
+// Make the replay position the restart point once the broker has acknowledged
+// everything queued so far: nothing left in the outbox or the QoS 1 window.
+// False while some of it may still be lost.
+static bool olSync(void)
+{
+    if (readOffset == syncedOffset)
+    {
+        return true;
+    }
+    if (MQTT_OutboxPending() > 0)
+    {
+        return false;
+    }
+
+    OfflineLog_Cursor_t cursor;
+    cursor.seq = oldestSeq;
+    cursor.offset = readOffset;
+    cursor.crc = Crc32_Update(0, &cursor, offsetof(OfflineLog_Cursor_t, crc));
+
+    bool written = false;
+    File file = LittleFS.open(OLOG_CURSOR_PATH, FILE_WRITE);
+    if (file)
+    {
+        written = file.write((const uint8_t*)&cursor, sizeof(cursor)) == sizeof(cursor);
+        file.close();
+    }
+    if (!written)
+    {
+        // Delivered all the same; a reboot replays these records again
+        Serial.println("[OLOG] Cursor write failed");
+    }
+    syncedOffset = readOffset;
+    return true;
+}
+
+// Replay position kept by an earlier boot, if it is still in the oldest segment
+static uint32_t olLoadCursor(uint32_t oldestSize)
+{
+    OfflineLog_Cursor_t cursor;
+    bool valid = false;
+    File file = LittleFS.open(OLOG_CURSOR_PATH, FILE_READ);
+    if (file)
+    {
+        valid = file.read((uint8_t*)&cursor, sizeof(cursor)) == sizeof(cursor) &&
+                cursor.crc == Crc32_Update(0, &cursor, offsetof(OfflineLog_Cursor_t, crc)) &&
+                cursor.seq == oldestSeq && cursor.offset <= oldestSize;
+        file.close();
+        if (!valid)
+        {
+            LittleFS.remove(OLOG_CURSOR_PATH);
+        }
+    }
+    return valid ? cursor.offset : 0;
+}
+
+static bool olReplay(const OfflineLog_Header_t* header, const uint8_t* payload, uint32_t now)
+{
+    uint32_t ts = header->time;
+    bool timeKnown = true;
+    if (header->flags & OLOG_FLAG_RELATIVE)
+    {
+        // The clock it was stamped on is gone after a reset or power loss:
+        // replay it without "ts" rather than lose the reading
+        uint32_t clockId;
+        uint32_t clockS = olClockS(&clockId);
+        timeKnown = header->clockId == clockId && header->time <= clockS;
+        ts = now - (clockS - header->time);
+    }
+
+    const bool binary = (header->flags & OLOG_FLAG_BINARY) != 0;
+    const char* topic = replayTopics[header->topic][binary ? 1 : 0];
+
+    if (!timeKnown)
+    {
+        DEBUG_PRINTLN("[OLOG] Record from an unsynced earlier clock, replayed without time");
+        if (binary)
+        {
+            return MQTT_PublishRaw(topic, payload, header->length, MQTT_QOS_COMMAND, false);
+        }
+        snprintf(replayBuffer, sizeof(replayBuffer), "%.*s", (int)header->length, (const char*)payload);
+        return MQTT_Publish(topic, replayBuffer, MQTT_QOS_COMMAND, false);
+    }
+
+    if (binary)
+    {
+        memcpy(replayBuffer, payload, header->length);
+        size_t length = MQTT_Codec_AppendTimestamp((uint8_t*)replayBuffer, header->length,
+                                                   sizeof(replayBuffer), ts);
+        if (length == 0)
+        {
+            DEBUG_PRINTLN("[OLOG] Binary record cannot take a timestamp, dropped");
+            return true;
+        }
+        return MQTT_PublishRaw(topic, (const uint8_t*)replayBuffer, (uint16_t)length, MQTT_QOS_COMMAND, false);
+    }
+
+    // JSON object: splice the timestamp in before the closing brace
+    if (header->length < 2 || payload[header->length - 1] != '}')
+    {
+        DEBUG_PRINTLN("[OLOG] Malformed JSON record, dropped");
+        return true;
+    }
+    snprintf(replayBuffer, sizeof(replayBuffer), "%.*s,\"ts\":%lu}",
+             (int)(header->length - 1), (const char*)payload, (unsigned long)ts);
+    return MQTT_Publish(topic, replayBuffer, MQTT_QOS_COMMAND, false);
+}
+#endif
+
+uint32_t OfflineLog_Now(void)
+{
+    time_t now = time(NULL);
+    return (now >= (time_t)OLOG_TIME_VALID) ? (uint32_t)now : 0;
+}
+
+bool OfflineLog_Init(void)
+{
+#if OFFLINE_LOG_ENABLED == STD_ON
+    if (logMutex == NULL)
+    {
+        logMutex = xSemaphoreCreateMutex();
+    }
+
+    // Formats the partition on first use
+    if (!LittleFS.begin(true))
+    {
+        Serial.println("[OLOG] LittleFS mount failed, offline log disabled");
+        return false;
+    }
+    if (!LittleFS.exists(OLOG_DIR))
+    {
+        LittleFS.mkdir(OLOG_DIR);
+    }
+
+    bootId = esp_random() | 1;     // never 0, the id of no clock
+    pendingBytes = 0;
+    readOffset = 0;
+    syncedOffset = 0;
+
+    // Segment names are their sequence numbers; oldest and newest bound the log
+    bool found = false;
+    uint32_t oldestSize = 0;
+    File dir = LittleFS.open(OLOG_DIR);
+    for (File file = dir.openNextFile(); file; file = dir.openNextFile())
+    {
+        const char* name = strrchr(file.name(), '/');
+        uint32_t seq = strtoul(name != NULL ? name + 1 : file.name(), NULL, 16);
+        uint32_t size = file.size();
+
+        pendingBytes += size;
+        if (!found || seq < oldestSeq)
+        {
+            oldestSeq = seq;
+            oldestSize = size;
+        }
+        if (!found || seq >= newestSeq)
+        {
+            newestSeq = seq;
+            newestSize = size;
+        }
+        found = true;
+    }
+    if (!found)
+    {
+        oldestSeq = 0;
+        newestSeq = 0;
+        newestSize = 0;
+    }
+
+    // Resume after what the broker acknowledged before the reset
+    readOffset = olLoadCursor(oldestSize);
+    syncedOffset = readOffset;
+    pendingBytes -= readOffset;
+
+    logReady = true;
+    Serial.println("[OLOG] Ready, " + String(pendingBytes) + " bytes to replay in " +
+                   String(found ? newestSeq - oldestSeq + 1 : 0) + " segments");
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool OfflineLog_Append(OfflineLog_Topic_t topic, const uint8_t* payload, uint16_t length,
+                       bool binary, uint32_t ageS)
+{
+#if OFFLINE_LOG_ENABLED == STD_ON
+    if (!logReady || topic >= OFFLINE_LOG_TOPIC_COUNT || length == 0 || length > OFFLINE_LOG_MAX_PAYLOAD)
+    {
+        return false;
+    }
+
+    OfflineLog_Header_t header;
+    header.magic = OLOG_RECORD_MAGIC;
+    header.topic = (uint8_t)topic;
+    header.flags = binary ? OLOG_FLAG_BINARY : 0;
+    header.reserved = 0;
+    header.length = length;
+    header.clockId = 0;
+
+    uint32_t now = OfflineLog_Now();
+    if (now != 0)
+    {
+        header.time = now - ageS;
+    }
+    else
+    {
+        uint32_t clockId;
+        uint32_t clockS = olClockS(&clockId);
+        header.clockId = clockId;
+        header.flags |= OLOG_FLAG_RELATIVE;
+        header.time = clockS > ageS ? clockS - ageS : 0;
+    }
+    header.crc = olRecordCrc(&header, payload);
+
+    const uint32_t recordSize = sizeof(header) + length;
+    bool stored = false;
+
+    xSemaphoreTake(logMutex, portMAX_DELAY);
+
+    // Roll to a fresh segment; past the budget the oldest data goes first
+    if (newestSize > 0 && newestSize + recordSize > OFFLINE_LOG_SEGMENT_SIZE)
+    {
+        newestSeq++;
+        newestSize = 0;
+        if (newestSeq - oldestSeq >= OFFLINE_LOG_SEGMENT_COUNT)
+        {
+            DEBUG_PRINTLN("[OLOG] Log full, dropping oldest segment");
+            olDropOldest();
+        }
+    }
+
+    char path[24];
+    olSegmentPath(path, sizeof(path), newestSeq);
+    File file = LittleFS.open(path, FILE_APPEND);
+    if (file)
+    {
+        stored = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 file.write(payload, length) == length;
+        file.close();
+    }
+
+    if (stored)
+    {
+        newestSize += recordSize;
+        pendingBytes += recordSize;
+    }
+    else
+    {
+        // A torn record fails its CRC at replay; never append behind it
+        newestSize = OFFLINE_LOG_SEGMENT_SIZE;
+        Serial.println("[OLOG] Write failed");
+    }
+
+    xSemaphoreGive(logMutex);
+    return stored;
+#else
+    return false;
+#endif
+}
+
+uint16_t OfflineLog_Drain(uint16_t maxRecords)
+{
+#if OFFLINE_LOG_ENABLED == STD_ON
+    if (!logReady)
+    {
+        return 0;
+    }
+
+    uint16_t sent = 0;
+    bool linkFailed = false;
+    bool waitAck = false;
+
+    xSemaphoreTake(logMutex, portMAX_DELAY);
+
+    // Records queued by earlier calls that have been acknowledged since
+    olSync();
+
+    // Wait for SNTP so every replayed record can be given its original time
+    uint32_t now = OfflineLog_Now();
+    if (pendingBytes == 0 || now == 0)
+    {
+        xSemaphoreGive(logMutex);
+        return 0;
+    }
+
+    while (sent < maxRecords && pendingBytes > 0 && !linkFailed && !waitAck)
+    {
+        char path[24];
+        olSegmentPath(path, sizeof(path), oldestSeq);
+
+        bool segmentDone = true;
+        File file = LittleFS.open(path, FILE_READ);
+        if (file)
+        {
+            segmentDone = false;
+            file.seek(readOffset);
+
+            while (sent < maxRecords)
+            {
+                OfflineLog_Header_t header;
+                if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+                    header.magic != OLOG_RECORD_MAGIC || header.topic >= OFFLINE_LOG_TOPIC_COUNT ||
+                    header.length == 0 || header.length > OFFLINE_LOG_MAX_PAYLOAD ||
+                    file.read(recordBuffer, header.length) != header.length ||
+                    olRecordCrc(&header, recordBuffer) != header.crc)
+                {
+                    // End of segment, or a record torn by a reset: nothing after it is trusted
+                    segmentDone = true;
+                    break;
+                }
+
+                if (!olReplay(&header, recordBuffer, now))
+                {
+                    linkFailed = true;
+                    break;
+                }
+
+                uint32_t recordSize = sizeof(header) + header.length;
+                readOffset += recordSize;
+                pendingBytes -= recordSize < pendingBytes ? recordSize : pendingBytes;
+                sent++;
+            }
+            file.close();
+        }
+
+        // Keep the segment until the broker has acknowledged its last records
+        if (segmentDone)
+        {
+            if (olSync())
+            {
+                olDropOldest();
+            }
+            else
+            {
+                waitAck = true;
+            }
+        }
+    }
+
+    xSemaphoreGive(logMutex);
+
+    if (sent > 0)
+    {
+        DEBUG_PRINTLN("[OLOG] Replayed " + String(sent) + ", " + String(pendingBytes) + " bytes left");
+    }
+    return sent;
+#else
+    return 0;
+#endif
+}
+
+void OfflineLog_Sync(void)
+{
+#if OFFLINE_LOG_ENABLED == STD_ON
+    if (!logReady)
+    {
+        return;
+    }
+    xSemaphoreTake(logMutex, portMAX_DELAY);
+    olSync();
+    xSemaphoreGive(logMutex);
+#endif
+}
+
+uint32_t OfflineLog_PendingBytes(void)
+{
+#if OFFLINE_LOG_ENABLED == STD_ON
+    return pendingBytes;
+#else
+    return 0;
+#endif
+}
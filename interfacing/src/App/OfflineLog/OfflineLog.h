@@ -0,0 +1,56 @@
+#ifndef OFFLINELOG_H
+#define OFFLINELOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../APP_Cfg.h"
+
+// Store-and-forward log for telemetry and decisions published while the link is down
+//
+// Records are appended to numbered segment files on LittleFS ("/olog/<seq>.seg").
+// A segment is written once front to back and deleted as a whole after it has
+// been replayed, so flash is never rewritten in place and consecutive segments
+// land on different blocks. When OFFLINE_LOG_SEGMENT_COUNT segments are full
+// the oldest one is dropped.
+//
+// Each record carries the time it was produced: UTC once SNTP has synced,
+// otherwise seconds on the node clock (Power's across deep sleep, uptime when
+// always on), resolved against the synced clock at replay. A record whose
+// clock did not survive a reset is replayed without a time.
+// Replay goes to "<topic>/replay" (JSON with a "ts" field) or
+// "<topic>/replay/bin" (binary with the timestamp field), so the backlog is
+// stored at its original time and never mixes with live traffic.
+// Replay is at QoS 1. The replay position is kept on flash ("/olog.pos") once
+// the broker has acknowledged what was queued, so a reset resends at most the
+// records that were still in flight and never the whole backlog.
+
+typedef enum
+{
+    OFFLINE_LOG_TELEMETRY = 0,
+    OFFLINE_LOG_DECISION,
+    OFFLINE_LOG_TOPIC_COUNT
+} OfflineLog_Topic_t;
+
+// Mount the filesystem and pick up segments left by a previous boot
+bool OfflineLog_Init(void);
+
+// Store one outgoing payload; ageS > 0 marks a record produced that many seconds ago
+bool OfflineLog_Append(OfflineLog_Topic_t topic, const uint8_t* payload, uint16_t length,
+                       bool binary, uint32_t ageS);
+
+// Republish up to maxRecords stored records, oldest first. Call only while
+// connected; stops at the first publish that fails. Returns records queued.
+uint16_t OfflineLog_Drain(uint16_t maxRecords);
+
+// Keep the replay position on flash if the broker has acknowledged everything
+// queued. Drain does this itself; call it after the outbox has been flushed,
+// before the node powers down.
+void OfflineLog_Sync(void);
+
+// Bytes still waiting to be replayed
+uint32_t OfflineLog_PendingBytes(void);
+
+// UTC seconds, 0 while the clock has not been synced
+uint32_t OfflineLog_Now(void);
+
+#endif // OFFLINELOG_H
@@ -1,11 +1,7 @@
 #include "PH_Sensor.h"
 #include "../../APP_Cfg.h"
 #include "../../Hal/ADC/ADC.h"
-
-static uint8_t PHValue[PH_QUEUE_SIZE];
-static uint8_t inPH;
-static uint8_t outPH;
-static uint8_t countPH;
+#include "../SensorBus/SensorBus.h"
 
 #if PH_DEBUG == STD_ON
 #define DEBUG_PRINTLN(var) Serial.println(var)
@@ -13,41 +9,9 @@ static uint8_t countPH;
 #define DEBUG_PRINTLN(var)
 #endif
 
-static void inqPH(int data)
-{
-    if (inPH == PH_QUEUE_SIZE)
-    {
-        inPH = 0;
-    }
-    PHValue[inPH++] = data;
-    countPH++;
-}
-
-static queue_t deqPH(int *data)
-{
-    queue_t status = queue_ok;
-
-    if (outPH == PH_QUEUE_SIZE)
-    {
-        outPH = 0;
-    }
-
-    if ((inPH == outPH) && (countPH == 0))
-    {
-        status = queue_empty;
-    }
-    else
-    {
-        *data = PHValue[outPH++];
-        countPH--;
-        status = queue_ok;
-    }
-    return status;
-}
-
 static PH_t defaultPHConfig =
 {
-    {PH_SENSOR_PIN, PH_RESOLUTION}
+    {PH_SENSOR_PIN, PH_RESOLUTION, PH_FILTER_CFG}
 };
 
 void PHSensor_init(void)
@@ -67,14 +31,19 @@ void PHSensor_main(void)
     int phValue = map(adcValue, Zero, ADC_MAX, Zero, PH_MAX);
 
     DEBUG_PRINTLN("PH Value: " + String(phValue));
-    inqPH(phValue);
+    SensorBus_Publish(SENSOR_CH_PH, (float)phValue);
 #endif
 }
 
 void PHSensor_getvalue(int *value)
 {
 #if PH_ENABLED == STD_ON
-    if (deqPH(value) == queue_empty)
+    SensorSample_t sample;
+    if (SensorBus_GetLatest(SENSOR_CH_PH, &sample) != SENSOR_QUALITY_NONE)
+    {
+        *value = (int)sample.value;
+    }
+    else
     {
         *value = 7;   /* neutral default */
     }
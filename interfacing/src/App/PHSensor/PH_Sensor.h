@@ -9,12 +9,6 @@ typedef struct{
     ADC_t adcConfig;
 }PH_t;
 
-typedef enum
-{
-    queue_ok,
-    queue_empty,
-}queue_t;
-
 void PHSensor_init(void);
 
 void PHSensor_main(void);
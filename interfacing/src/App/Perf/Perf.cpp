@@ -0,0 +1,232 @@
+#include "Perf.h"
+
+#if PERF_ENABLED == STD_ON
+#include <atomic>
+#include "../MQTT_APP/mqtt_payload.h"
+#include "../../Hal/MQTT/mqtt_core.h"
+
+#if PERF_DEBUG == STD_ON
+#define DEBUG_PRINTLN(var) Serial.println(var)
+#else
+#define DEBUG_PRINTLN(var)
+#endif
+
+static_assert(MQTT_PERF_SECTION_JSON_SIZE <= MQTT_OUTBOX_PAYLOAD_MAX + 1 &&
+              MQTT_PERF_TASK_JSON_SIZE <= MQTT_OUTBOX_PAYLOAD_MAX + 1,
+              "perf report larger than MQTT_OUTBOX_PAYLOAD_MAX");
+
+// Attempts at a consistent copy before a section is left for the next step.
+// The reader must not spin: the writer may be a lower priority task on the
+// same core, preempted halfway through an update.
+#define PERF_SNAPSHOT_TRIES 3
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+    uint32_t windowStartMs;
+    uint32_t histogram[PERF_HIST_BUCKETS];
+} PerfStats_t;
+
+typedef struct
+{
+    const char* name;
+    std::atomic<bool> registered;
+    std::atomic<bool> resetPending;     // set by the reader, honoured by the writer
+    std::atomic<uint32_t> seq;          // odd while the writer is updating stats
+    PerfStats_t stats;
+} PerfSection_t;
+
+typedef struct
+{
+    TaskHandle_t handle;
+    const char* name;
+    uint32_t stackSize;
+} PerfTask_t;
+
+static PerfSection_t sections[PERF_MAX_SECTIONS];
+static std::atomic<uint8_t> sectionCount(0);
+static PerfTask_t tasks[PERF_MAX_TASKS];
+static uint8_t taskCount = 0;
+static uint32_t cpuMHz = 240;
+static uint8_t reportCursor = 0;        // next task, then section, to publish
+
+static void perfClear(PerfStats_t* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->minCycles = UINT32_MAX;
+    stats->windowStartMs = millis();
+}
+
+// Bucket i holds runs shorter than PERF_HIST_FIRST_US * 4^i, the last one the rest
+static uint8_t perfBucket(uint32_t us)
+{
+    uint8_t bucket = 0;
+    for (uint32_t edge = PERF_HIST_FIRST_US; bucket < PERF_HIST_BUCKETS - 1 && us >= edge; edge <<= 2)
+    {
+        bucket++;
+    }
+    return bucket;
+}
+
+void Perf_Init(void)
+{
+    cpuMHz = ESP.getCpuFreqMHz();
+    DEBUG_PRINTLN("[PERF] Profiling on, CPU " + String(cpuMHz) + " MHz");
+}
+
+int8_t Perf_RegisterSection(const char* name)
+{
+    if (name == NULL || strlen(name) > PERF_NAME_MAX)
+    {
+        return -1;
+    }
+    // PERF_SCOPE() sites register from whichever task gets there first
+    uint8_t index = sectionCount.fetch_add(1);
+    if (index >= PERF_MAX_SECTIONS)
+    {
+        DEBUG_PRINTLN("[PERF] Section table full, " + String(name) + " not timed");
+        return -1;
+    }
+
+    PerfSection_t* section = &sections[index];
+    section->name = name;
+    perfClear(&section->stats);
+    section->seq.store(0, std::memory_order_relaxed);
+    section->resetPending.store(false, std::memory_order_relaxed);
+    section->registered.store(true, std::memory_order_release);
+    return (int8_t)index;
+}
+
+void Perf_Record(int8_t section, uint32_t cycles)
+{
+    if (section < 0 || section >= PERF_MAX_SECTIONS)
+    {
+        return;
+    }
+    PerfSection_t* s = &sections[section];
+    PerfStats_t* stats = &s->stats;
+
+    uint32_t seq = s->seq.load(std::memory_order_relaxed);
+    s->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (s->resetPending.load(std::memory_order_acquire))
+    {
+        perfClear(stats);
+        s->resetPending.store(false, std::memory_order_relaxed);
+    }
+    stats->count++;
+    stats->totalCycles += cycles;
+    stats->minCycles = cycles < stats->minCycles ? cycles : stats->minCycles;
+    stats->maxCycles = cycles > stats->maxCycles ? cycles : stats->maxCycles;
+    stats->histogram[perfBucket(cycles / cpuMHz)]++;
+
+    s->seq.store(seq + 2, std::memory_order_release);
+}
+
+void Perf_RegisterTask(TaskHandle_t task, const char* name, uint32_t stackSize)
+{
+    if (task == NULL || taskCount >= PERF_MAX_TASKS || strlen(name) > PERF_NAME_MAX)
+    {
+        return;
+    }
+    tasks[taskCount].handle = task;
+    tasks[taskCount].name = name;
+    tasks[taskCount].stackSize = stackSize;
+    taskCount++;
+}
+
+// Seqlock read, as in SensorRing
+static bool perfSnapshot(const PerfSection_t* s, PerfStats_t* out)
+{
+    for (uint8_t attempt = 0; attempt < PERF_SNAPSHOT_TRIES; attempt++)
+    {
+        uint32_t before = s->seq.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            continue;
+        }
+        *out = s->stats;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s->seq.load(std::memory_order_relaxed) == before)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool perfPublishTask(const PerfTask_t* task)
+{
+    JsonBuffer<MQTT_PERF_TASK_JSON_SIZE> json;
+    const char* payload = MQTT_Payload_PerfTask(&json, task->name, task->stackSize,
+                                                (uint32_t)uxTaskGetStackHighWaterMark(task->handle));
+    return payload != NULL && MQTT_Publish(MQTT_TOPIC_PERF, payload, 0, false);
+}
+
+// false when there was nothing to send: no runs yet, or the writer was busy
+static bool perfPublishSection(PerfSection_t* section)
+{
+    // A pending reset means the stats are the window already published
+    PerfStats_t stats;
+    if (!section->registered.load(std::memory_order_acquire) ||
+        section->resetPending.load(std::memory_order_acquire) || !perfSnapshot(section, &stats) ||
+        stats.count == 0)
+    {
+        return false;
+    }
+
+    uint32_t windowMs = millis() - stats.windowStartMs;
+    Perf_SectionReport_t report;
+    report.name = section->name;
+    report.count = stats.count;
+    report.minUs = stats.minCycles / cpuMHz;
+    report.avgUs = (uint32_t)(stats.totalCycles / stats.count / cpuMHz);
+    report.maxUs = stats.maxCycles / cpuMHz;
+    report.loadPct = windowMs > 0 ? (float)stats.totalCycles / cpuMHz / (windowMs * 10.0f) : 0.0f;
+    report.windowS = windowMs / 1000;
+    memcpy(report.histogram, stats.histogram, sizeof(report.histogram));
+
+    JsonBuffer<MQTT_PERF_SECTION_JSON_SIZE> json;
+    const char* payload = MQTT_Payload_PerfSection(&json, &report);
+    if (payload == NULL || !MQTT_Publish(MQTT_TOPIC_PERF, payload, 0, false))
+    {
+        // Not queued: keep counting into the same window
+        return false;
+    }
+    DEBUG_PRINTLN(payload);
+
+    // Runs recorded since the snapshot go with the reset; at most a few per step
+    section->resetPending.store(true, std::memory_order_release);
+    return true;
+}
+
+// One message per step keeps the outbox free for telemetry. Offline, reports
+// are not worth a place in the offline log; the windows just grow.
+void Perf_main(void)
+{
+    if (!MQTT_IsConnected())
+    {
+        return;
+    }
+
+    uint8_t registered = sectionCount.load(std::memory_order_relaxed);
+    uint8_t items = taskCount + (registered < PERF_MAX_SECTIONS ? registered : PERF_MAX_SECTIONS);
+
+    // The first task or section with something to report
+    for (uint8_t tried = 0; tried < items; tried++)
+    {
+        uint8_t item = reportCursor < items ? reportCursor : 0;
+        reportCursor = item + 1;
+        bool sent = item < taskCount ? perfPublishTask(&tasks[item])
+                                     : perfPublishSection(&sections[item - taskCount]);
+        if (sent)
+        {
+            return;
+        }
+    }
+}
+#endif // PERF_ENABLED
@@ -0,0 +1,77 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "../../APP_Cfg.h"
+
+// Profiling, compiled in with PERF_ENABLED
+// - Sections: execution time of a scheduler job (recorded by the scheduler) or
+//   of a scope marked with PERF_SCOPE("name"), counted in CPU cycles
+//   (ESP.getCycleCount()). Each section keeps count, min/avg/max and a
+//   histogram with buckets 4x apart: <64us, <256us, <1ms, ... , >=256ms.
+// - Tasks: stack high-water mark of every registered task.
+// Perf_main() publishes one task or section per run on MQTT_TOPIC_PERF, round
+// robin; a section's window restarts once it has been published.
+//
+// A section must only be recorded from one task (a job runs on one lane); the
+// reader takes a consistent copy without stopping the writer.
+
+#define PERF_NAME_MAX       24      // longest section or task name
+#define PERF_HIST_BUCKETS   8
+#define PERF_HIST_FIRST_US  64      // upper edge of the first bucket
+
+#if PERF_ENABLED == STD_ON
+
+// Section report, as published
+typedef struct
+{
+    const char* name;
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t avgUs;
+    uint32_t maxUs;
+    float loadPct;                  // share of the window spent in the section
+    uint32_t windowS;
+    uint32_t histogram[PERF_HIST_BUCKETS];
+} Perf_SectionReport_t;
+
+void Perf_Init(void);
+
+// Returns the section id, or -1 when the table is full or the name too long
+int8_t Perf_RegisterSection(const char* name);
+void Perf_Record(int8_t section, uint32_t cycles);
+
+void Perf_RegisterTask(TaskHandle_t task, const char* name, uint32_t stackSize);
+
+// Scheduler job, every PERF_REPORT_STEP_MS
+void Perf_main(void);
+
+// Times its own lifetime into a section
+class PerfScope
+{
+public:
+    explicit PerfScope(int8_t section) : section(section), start(ESP.getCycleCount()) {}
+    ~PerfScope() { Perf_Record(section, ESP.getCycleCount() - start); }
+
+private:
+    int8_t section;
+    uint32_t start;
+};
+
+#define PERF_CONCAT_(a, b)  a##b
+#define PERF_CONCAT(a, b)   PERF_CONCAT_(a, b)
+
+// Time the rest of the enclosing scope; the section is registered on first use
+#define PERF_SCOPE(name) \
+    static const int8_t PERF_CONCAT(perfSection, __LINE__) = Perf_RegisterSection(name); \
+    PerfScope PERF_CONCAT(perfScope, __LINE__)(PERF_CONCAT(perfSection, __LINE__))
+
+#else
+
+#define PERF_SCOPE(name)
+
+#endif // PERF_ENABLED
+
+#endif // PERF_H
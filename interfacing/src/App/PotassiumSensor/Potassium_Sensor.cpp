@@ -1,11 +1,7 @@
 #include "Potassium_Sensor.h"
 #include "../../APP_Cfg.h"
 #include "../../Hal/ADC/ADC.h"
-
-static uint8_t PotassiumValue[Potassium_QUEUE_SIZE];
-static uint8_t inK;
-static uint8_t outK;
-static uint8_t countK;
+#include "../SensorBus/SensorBus.h"
 
 #if Potassium_DEBUG == STD_ON
 #define DEBUG_PRINTLN(var) Serial.println(var)
@@ -13,41 +9,9 @@ static uint8_t countK;
 #define DEBUG_PRINTLN(var)
 #endif
 
-static void inqK(int data)
-{
-    if (inK == Potassium_QUEUE_SIZE)
-    {
-        inK = 0;
-    }
-    PotassiumValue[inK++] = data;
-    countK++;
-}
-
-static queue_t deqK(int *data)
-{
-    queue_t status = queue_ok;
-
-    if (outK == Potassium_QUEUE_SIZE)
-    {
-        outK = 0;
-    }
-
-    if ((inK == outK) && (countK == 0))
-    {
-        status = queue_empty;
-    }
-    else
-    {
-        *data = PotassiumValue[outK++];
-        countK--;
-        status = queue_ok;
-    }
-    return status;
-}
-
 static Potassium_t defaultPotassiumConfig =
 {
-    {Potassium_SENSOR_PIN, Potassium_RESOLUTION}
+    {Potassium_SENSOR_PIN, Potassium_RESOLUTION, Potassium_FILTER_CFG}
 };
 
 void PotassiumSensor_init(void)
@@ -64,14 +28,19 @@ void PotassiumSensor_main(void)
     int adcValue = ADC_ReadValue(defaultPotassiumConfig.adcConfig.channel);
     int potassiumValue = map(adcValue, Zero, ADC_MAX, Zero, POTASSIUM_MAX);
     DEBUG_PRINTLN("Potassium Value (mg/kg): " + String(potassiumValue));
-    inqK(potassiumValue);
+    SensorBus_Publish(SENSOR_CH_POTASSIUM, (float)potassiumValue);
 #endif
 }
 
 void PotassiumSensor_getvalue(int *value)
 {
 #if Potassium_ENABLED == STD_ON
-    if (deqK(value) == queue_empty)
+    SensorSample_t sample;
+    if (SensorBus_GetLatest(SENSOR_CH_POTASSIUM, &sample) != SENSOR_QUALITY_NONE)
+    {
+        *value = (int)sample.value;
+    }
+    else
     {
         *value = 0;
     }
@@ -13,12 +13,6 @@ typedef struct{
     ADC_t adcConfig;
 }Potassium_t;
 
-typedef enum
-{
-    queue_ok,
-    queue_empty,
-}queue_t;
-
 void PotassiumSensor_init(void);
 
 void PotassiumSensor_main(void);
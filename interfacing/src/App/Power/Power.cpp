@@ -0,0 +1,370 @@
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <esp_system.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Power.h"
+#include "../SensorBus/SensorBus.h"
+#include "../SoilMoisture/SoilMoisture.h"
+#include "../DHT/DHT11.h"
+#include "../ML/ML.h"
+#include "../ZoneManager/ZoneManager.h"
+#include "../MQTT_APP/mqtt_app.h"
+#include "../OfflineLog/OfflineLog.h"
+#include "../../Hal/ADC/ADC.h"
+#include "../../Hal/MQTT/mqtt_core.h"
+#include "../../Hal/WIFI/wifi.h"
+
+#if POWER_DEBUG == STD_ON
+#define DEBUG_PRINTLN(var) Serial.println(var)
+#else
+#define DEBUG_PRINTLN(var)
+#endif
+
+#define POWER_RTC_MAGIC      0x50575231UL   // "PWR1"
+#define POWER_NO_DECISION    0xFF
+#define POWER_HISTORY_STEP_S (SCHED_ML_HISTORY_PERIOD_MS / 1000)
+
+typedef struct
+{
+    uint32_t timeS;             // node time the record was sampled at
+    float soilMoisture;
+    float temperature;
+    float humidity;
+} Power_Record_t;
+
+// Everything that has to survive deep sleep
+typedef struct
+{
+    uint32_t magic;
+    uint32_t layoutSize;        // rejects state written by a build with another layout
+    uint32_t wakeCount;
+    uint32_t clockS;            // node time since cold boot, awake plus asleep
+    uint32_t clockId;           // drawn at cold boot, names the clock clockS counts on
+    uint32_t wakeIntervalS;
+    uint32_t historyS;          // node time of the newest ML history step
+    bool hasHistoryTime;
+    float lastMoisture;
+    uint32_t lastMoistureS;     // node time lastMoisture was sampled at
+    bool hasMoisture;
+    uint8_t lastSentDecision[ZONE_COUNT];
+    Power_Record_t pending[POWER_PENDING_MAX];
+    uint8_t pendingHead;        // oldest record
+    uint8_t pendingCount;
+} Power_RtcState_t;
+
+RTC_DATA_ATTR static Power_RtcState_t rtcState;
+
+#if POWER_MODE != POWER_MODE_ALWAYS_ON
+static uint32_t cycleStartMs = 0;
+
+static void powerResetState(void)
+{
+    memset(&rtcState, 0, sizeof(rtcState));
+    rtcState.magic = POWER_RTC_MAGIC;
+    rtcState.layoutSize = sizeof(Power_RtcState_t);
+    rtcState.wakeIntervalS = POWER_WAKE_DEFAULT_S;
+    memset(rtcState.lastSentDecision, POWER_NO_DECISION, sizeof(rtcState.lastSentDecision));
+    rtcState.clockId = esp_random() | 1;
+}
+
+static void powerQueueRecord(uint32_t timeS, float soilMoisture, float temperature, float humidity)
+{
+    if (rtcState.pendingCount == POWER_PENDING_MAX)
+    {
+        // Full: drop the oldest record
+        rtcState.pendingHead = (rtcState.pendingHead + 1) % POWER_PENDING_MAX;
+        rtcState.pendingCount--;
+    }
+    uint8_t slot = (rtcState.pendingHead + rtcState.pendingCount) % POWER_PENDING_MAX;
+    rtcState.pending[slot].timeS = timeS;
+    rtcState.pending[slot].soilMoisture = soilMoisture;
+    rtcState.pending[slot].temperature = temperature;
+    rtcState.pending[slot].humidity = humidity;
+    rtcState.pendingCount++;
+}
+
+static void powerFlushPending(uint32_t nowS)
+{
+    while (rtcState.pendingCount > 0)
+    {
+        const Power_Record_t* record = &rtcState.pending[rtcState.pendingHead];
+        if (!MQTT_APP_PublishTelemetrySample(record->soilMoisture, record->temperature,
+                                             record->humidity, nowS - record->timeS))
+        {
+            break;  // keep the rest for the next transmit
+        }
+        rtcState.pendingHead = (rtcState.pendingHead + 1) % POWER_PENDING_MAX;
+        rtcState.pendingCount--;
+
+        // This task owns the MQTT client here: send before the outbox fills
+        MQTT_Loop();
+    }
+}
+
+// Replay what the offline log holds, one outbox load at a time
+static void powerReplayOffline(void)
+{
+    uint16_t replayed = 0;
+    while (replayed < POWER_REPLAY_MAX)
+    {
+        uint16_t batch = POWER_REPLAY_MAX - replayed;
+        uint16_t sent = OfflineLog_Drain(batch < MQTT_OUTBOX_LOW_DEPTH ? batch : MQTT_OUTBOX_LOW_DEPTH);
+        if (sent == 0)
+        {
+            break;
+        }
+        replayed += sent;
+        MQTT_Loop();
+    }
+}
+
+// Faster wakes while moisture moves or the soil is dry, slower while it is stable.
+// The rate is over the time since the last good sample: that spans the awake
+// time too, and any cycles in between that had no good sample.
+static void powerAdaptInterval(float moisture, uint32_t nowS)
+{
+    uint32_t interval = rtcState.wakeIntervalS;
+
+    if (rtcState.hasMoisture && nowS > rtcState.lastMoistureS)
+    {
+        float elapsedS = (float)(nowS - rtcState.lastMoistureS);
+        float ratePerMin = fabsf(moisture - rtcState.lastMoisture) * 60.0f / elapsedS;
+
+        if (moisture < SOILMOISTURE_DRY_THRESHOLD)
+        {
+            interval = POWER_WAKE_MIN_S;
+        }
+        else if (ratePerMin >= POWER_RATE_FAST)
+        {
+            interval /= 2;
+        }
+        else if (ratePerMin <= POWER_RATE_SLOW)
+        {
+            interval *= 2;
+        }
+        DEBUG_PRINTLN("[POWER] Moisture rate: " + String(ratePerMin, 2) + " %/min");
+    }
+
+    rtcState.wakeIntervalS = constrain(interval, (uint32_t)POWER_WAKE_MIN_S, (uint32_t)POWER_WAKE_MAX_S);
+    rtcState.lastMoisture = moisture;
+    rtcState.lastMoistureS = nowS;
+    rtcState.hasMoisture = true;
+}
+
+// Node time now
+static uint32_t powerNowS(void)
+{
+    return rtcState.clockS + (millis() - cycleStartMs) / 1000;
+}
+
+// Decide locally. A wake is many history steps after the previous one; the
+// history catches up on all of them to stay on the model's trained step.
+// A zone gets no decision until its window is full; decisions[]/decided[]
+// keep what an earlier call decided for a zone that got none this time.
+static void powerDecide(uint32_t nowS, Decision_t* decisions, bool* decided)
+{
+    uint32_t steps = 1;
+    if (rtcState.hasHistoryTime)
+    {
+        steps = (nowS - rtcState.historyS + POWER_HISTORY_STEP_S / 2) / POWER_HISTORY_STEP_S;
+    }
+    ML_CatchUpHistory(steps);
+    rtcState.historyS = nowS;
+    rtcState.hasHistoryTime = true;
+
+    Decision_t latest[ZONE_COUNT];
+    bool decidedNow[ZONE_COUNT];
+    ML_DecideZones(latest, decidedNow);
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        if (decidedNow[zone])
+        {
+            decisions[zone] = latest[zone];
+            decided[zone] = true;
+            ZoneManager_SetDecision(zone, latest[zone]);
+        }
+    }
+}
+
+// Outputs do not hold through sleep (light sleep keeps a valve open for the
+// whole interval, deep sleep resets it), and ZONE_STOP_MOISTURE and the model
+// only act while the zone job runs. Stay awake running the zone job, the
+// probes and the model on their always-on periods while a zone waters, for at
+// most ZONE_MAX_RUN_S, then switch every output off. A zone still dry then
+// starts again on the next wake.
+static void powerIrrigate(Decision_t* decisions, bool* decided)
+{
+    uint32_t startMs = millis();
+    uint32_t stepMs = startMs;
+    while (ZoneManager_AnyWatering() && (millis() - startMs) < ZONE_MAX_RUN_S * 1000UL)
+    {
+        vTaskDelay(pdMS_TO_TICKS(SCHED_ZONE_PERIOD_MS));
+        SoilMoisture_main();
+        if ((millis() - stepMs) >= SCHED_ML_HISTORY_PERIOD_MS)
+        {
+            stepMs += SCHED_ML_HISTORY_PERIOD_MS;
+            DHT11_main();
+            powerDecide(powerNowS(), decisions, decided);
+        }
+        ZoneManager_main();
+    }
+    if (ZoneManager_AnyWatering())
+    {
+        DEBUG_PRINTLN("[POWER] Irrigation ran " + String(ZONE_MAX_RUN_S) + " s, stopping for this wake");
+    }
+    ZoneManager_StopAll();
+}
+
+static bool powerLinkUp(void)
+{
+    MQTT_APP_Setup();
+
+    TickType_t start = xTaskGetTickCount();
+    while ((xTaskGetTickCount() - start) < pdMS_TO_TICKS(POWER_LINK_TIMEOUT_MS))
+    {
+        wifi_loop();
+        if (WIFI_IsConnected())
+        {
+            MQTT_Loop();
+            if (MQTT_IsConnected())
+            {
+                return true;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+
+    DEBUG_PRINTLN("[POWER] Link timeout, keeping telemetry for the next wake");
+    return false;
+}
+
+static void powerLinkDown(void)
+{
+    // Empty the outbox, then give the stack a moment to push the last packets
+    // out before the radio goes off
+    TickType_t start = xTaskGetTickCount();
+    do
+    {
+        MQTT_Loop();
+    } while (MQTT_OutboxPending() > 0 && MQTT_IsConnected() &&
+             (xTaskGetTickCount() - start) < pdMS_TO_TICKS(POWER_FLUSH_TIMEOUT_MS));
+    OfflineLog_Sync();      // the next wake resumes the replay after what was acknowledged
+    vTaskDelay(pdMS_TO_TICKS(100));
+    MQTT_Disconnect();
+    WIFI_Deinit();
+}
+#endif
+
+void Power_Init(void)
+{
+#if POWER_MODE != POWER_MODE_ALWAYS_ON
+    if (rtcState.magic != POWER_RTC_MAGIC || rtcState.layoutSize != sizeof(Power_RtcState_t))
+    {
+        powerResetState();
+        DEBUG_PRINTLN("[POWER] Cold start");
+    }
+    else
+    {
+        DEBUG_PRINTLN("[POWER] Wake #" + String(rtcState.wakeCount) + ", cause " +
+                      String((int)esp_sleep_get_wakeup_cause()) + ", pending " +
+                      String(rtcState.pendingCount));
+    }
+    rtcState.wakeCount++;
+#endif
+}
+
+void Power_RunCycle(void)
+{
+#if POWER_MODE != POWER_MODE_ALWAYS_ON
+    cycleStartMs = millis();
+
+    // Sample: several rounds so the ADC filters and the DHT have settled
+    for (uint8_t round = 0; round < POWER_SAMPLE_ROUNDS; round++)
+    {
+        SoilMoisture_main();
+        DHT11_main();
+        vTaskDelay(pdMS_TO_TICKS(POWER_SAMPLE_SPACING_MS));
+    }
+
+    uint32_t nowS = powerNowS();
+    SensorSample_t moisture;
+    if (SensorBus_GetLatest(SENSOR_CH_SOIL_MOISTURE, &moisture) == SENSOR_QUALITY_GOOD)
+    {
+        // A DHT that failed this wake is left out of the record, not sent old
+        powerQueueRecord(nowS, moisture.value, SensorBus_GetGoodValue(SENSOR_CH_TEMPERATURE),
+                         SensorBus_GetGoodValue(SENSOR_CH_HUMIDITY));
+        powerAdaptInterval(moisture.value, nowS);
+    }
+
+    // Decide locally and switch the zone outputs; no scheduler runs on a duty cycle
+    Decision_t decisions[ZONE_COUNT];
+    bool decided[ZONE_COUNT] = {};
+    powerDecide(nowS, decisions, decided);
+    ZoneManager_main();
+    powerIrrigate(decisions, decided);
+
+    bool changed = false;
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        changed = changed || (decided[zone] && decisions[zone] != rtcState.lastSentDecision[zone]);
+    }
+
+    // Radio only when the batch is full or there is a new decision to act on
+    if (rtcState.pendingCount >= POWER_TELEMETRY_BATCH || changed)
+    {
+        if (powerLinkUp())
+        {
+            powerFlushPending(powerNowS());
+            for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+            {
+                if (decided[zone] && decisions[zone] != rtcState.lastSentDecision[zone])
+                {
+                    MQTT_APP_PublishDecision(decisions[zone], zone);
+                    rtcState.lastSentDecision[zone] = (uint8_t)decisions[zone];
+                }
+            }
+            powerReplayOffline();
+        }
+        powerLinkDown();
+    }
+
+    ADC_StopContinuous();
+
+    uint32_t awakeS = (millis() - cycleStartMs + 999) / 1000;
+    rtcState.clockS += awakeS + rtcState.wakeIntervalS;
+
+    DEBUG_PRINTLN("[POWER] Awake " + String(awakeS) + " s, sleeping " + String(rtcState.wakeIntervalS) +
+                  " s, pending " + String(rtcState.pendingCount));
+    Serial.flush();
+
+    esp_sleep_enable_timer_wakeup((uint64_t)rtcState.wakeIntervalS * 1000000ULL);
+#if POWER_MODE == POWER_MODE_DEEP_SLEEP
+    esp_deep_sleep_start();
+#else
+    esp_light_sleep_start();
+    rtcState.wakeCount++;
+#endif
+#endif
+}
+
+uint32_t Power_GetWakeIntervalS(void)
+{
+    return rtcState.wakeIntervalS;
+}
+
+uint8_t Power_GetPendingCount(void)
+{
+    return rtcState.pendingCount;
+}
+
+uint32_t Power_GetClockS(uint32_t* clockId)
+{
+#if POWER_MODE != POWER_MODE_ALWAYS_ON
+    *clockId = rtcState.clockId;
+    return powerNowS();
+#else
+    *clockId = 0;
+    return 0;
+#endif
+}
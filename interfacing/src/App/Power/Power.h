@@ -0,0 +1,31 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+#include "../../APP_Cfg.h"
+
+// Low-power duty cycle for battery/solar nodes (POWER_MODE != POWER_MODE_ALWAYS_ON)
+// Each wake: sample sensors, catch the ML history up to now on its trained
+// step, decide, and only bring up WiFi/MQTT when the telemetry batch is full
+// or the decision changed; then sleep for an interval that follows how fast
+// soil moisture is changing.
+// A zone that starts watering keeps the node awake until it stops, at most
+// ZONE_MAX_RUN_S; every zone output is off before the node sleeps.
+// Unsent telemetry lives in RTC memory across deep sleep; ML_Init() restores
+// the model history itself.
+
+// Restore RTC state after a wake
+void Power_Init(void);
+
+// Run one wake cycle and sleep. Never returns in deep sleep mode.
+void Power_RunCycle(void);
+
+uint32_t Power_GetWakeIntervalS(void);
+
+// Node time since cold boot, awake plus asleep, so it keeps counting across
+// deep sleep. *clockId is drawn at cold boot: two readings with the same id
+// are on the same clock. Duty cycle only; 0 with id 0 otherwise.
+uint32_t Power_GetClockS(uint32_t* clockId);
+uint8_t Power_GetPendingCount(void);
+
+#endif // POWER_H
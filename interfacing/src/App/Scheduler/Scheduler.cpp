@@ -0,0 +1,237 @@
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Scheduler.h"
+#include "../Perf/Perf.h"
+
+#if SCHED_DEBUG == STD_ON
+#define DEBUG_PRINTLN(var) Serial.println(var)
+#else
+#define DEBUG_PRINTLN(var)
+#endif
+
+typedef struct
+{
+    Sched_JobCfg_t cfg;
+    Sched_Lane_t lane;
+    TickType_t nextRelease;     // owned by the lane task
+    Sched_JobStats_t stats;
+#if PERF_ENABLED == STD_ON
+    int8_t perfSection;
+#endif
+} Sched_Job_t;
+
+typedef struct
+{
+    const char* name;
+    BaseType_t core;
+    UBaseType_t priority;
+    uint32_t stackSize;
+} Sched_LaneCfg_t;
+
+static const Sched_LaneCfg_t laneCfg[SCHED_LANE_COUNT] = {
+    {"schedNet", SCHED_NET_CORE, SCHED_NET_PRIORITY, SCHED_NET_STACK_SIZE},
+    {"schedIO",  SCHED_IO_CORE,  SCHED_IO_PRIORITY,  SCHED_IO_STACK_SIZE},
+    {"schedML",  SCHED_ML_CORE,  SCHED_ML_PRIORITY,  SCHED_ML_STACK_SIZE},
+};
+
+static Sched_Job_t jobs[SCHED_MAX_JOBS];
+static uint8_t jobCount = 0;
+static TaskHandle_t laneTask[SCHED_LANE_COUNT];
+static uint32_t laneEvents[SCHED_LANE_COUNT];     // union of the lane's job event masks
+static bool started = false;
+
+static void runJob(Sched_Job_t* job, TickType_t release)
+{
+    uint32_t startUs = micros();
+#if PERF_ENABLED == STD_ON
+    {
+        PerfScope scope(job->perfSection);
+        job->cfg.run();
+    }
+#else
+    job->cfg.run();
+#endif
+    uint32_t runUs = micros() - startUs;
+
+    job->stats.runs++;
+    job->stats.lastRunUs = runUs;
+    if (runUs > job->stats.maxRunUs) {
+        job->stats.maxRunUs = runUs;
+    }
+
+    // Deadline counts from release, so time spent waiting behind other jobs on the lane is included
+    if (job->cfg.deadlineMs != 0 &&
+        (xTaskGetTickCount() - release) > pdMS_TO_TICKS(job->cfg.deadlineMs)) {
+        job->stats.deadlineMisses++;
+        DEBUG_PRINTLN("[SCHED] Deadline miss: " + String(job->cfg.name) + " (" + String(runUs) + " us)");
+    }
+}
+
+static void laneLoop(void* parameter)
+{
+    Sched_Lane_t lane = (Sched_Lane_t)(uintptr_t)parameter;
+    uint32_t events = 0;
+
+    DEBUG_PRINTLN("[SCHED] " + String(laneCfg[lane].name) + " started on core: " + String(xPortGetCoreID()));
+
+    for (;;) {
+        TickType_t now = xTaskGetTickCount();
+
+        for (uint8_t i = 0; i < jobCount; i++) {
+            Sched_Job_t* job = &jobs[i];
+            if (job->lane != lane) {
+                continue;
+            }
+
+            bool triggered = (job->cfg.events & events) != 0;
+            bool due = job->cfg.periodMs != 0 && (int32_t)(now - job->nextRelease) >= 0;
+            if (!triggered && !due) {
+                continue;
+            }
+
+            runJob(job, due ? job->nextRelease : now);
+
+            if (job->cfg.periodMs != 0) {
+                TickType_t period = pdMS_TO_TICKS(job->cfg.periodMs);
+                if (due) {
+                    // Keep the phase; if we fell more than a period behind, skip the missed releases
+                    job->nextRelease += period;
+                    if ((int32_t)(xTaskGetTickCount() - job->nextRelease) >= 0) {
+                        job->nextRelease = xTaskGetTickCount() + period;
+                    }
+                } else {
+                    // An event run counts as this period's run
+                    job->nextRelease = now + period;
+                }
+            }
+        }
+
+        // Sleep until the earliest periodic release or an event, whichever comes first
+        TickType_t wait = portMAX_DELAY;
+        now = xTaskGetTickCount();
+        for (uint8_t i = 0; i < jobCount; i++) {
+            if (jobs[i].lane != lane || jobs[i].cfg.periodMs == 0) {
+                continue;
+            }
+            int32_t remaining = (int32_t)(jobs[i].nextRelease - now);
+            TickType_t ticks = remaining > 0 ? (TickType_t)remaining : 0;
+            if (ticks < wait) {
+                wait = ticks;
+            }
+        }
+
+        events = 0;
+        xTaskNotifyWait(0, 0xFFFFFFFFUL, &events, wait);
+    }
+}
+
+void Sched_Init(void)
+{
+    jobCount = 0;
+    started = false;
+    for (uint8_t lane = 0; lane < SCHED_LANE_COUNT; lane++) {
+        laneTask[lane] = NULL;
+        laneEvents[lane] = 0;
+    }
+    DEBUG_PRINTLN("Scheduler Initialized");
+}
+
+int8_t Sched_RegisterJob(Sched_Lane_t lane, const Sched_JobCfg_t* cfg)
+{
+    if (started || lane >= SCHED_LANE_COUNT || cfg == NULL || cfg->run == NULL) {
+        return -1;
+    }
+    if (cfg->periodMs == 0 && cfg->events == 0) {
+        return -1;  // would never run
+    }
+    if (jobCount >= SCHED_MAX_JOBS) {
+        DEBUG_PRINTLN("[SCHED] Job table full, " + String(cfg->name) + " not registered");
+        return -1;
+    }
+
+    Sched_Job_t* job = &jobs[jobCount];
+    job->cfg = *cfg;
+    job->lane = lane;
+    job->nextRelease = 0;
+    memset(&job->stats, 0, sizeof(job->stats));
+#if PERF_ENABLED == STD_ON
+    job->perfSection = Perf_RegisterSection(cfg->name);
+#endif
+    laneEvents[lane] |= cfg->events;
+
+    DEBUG_PRINTLN("[SCHED] Job registered: " + String(cfg->name));
+    return (int8_t)jobCount++;
+}
+
+bool Sched_Start(void)
+{
+    if (started) {
+        return true;
+    }
+
+    // First periodic release is immediate
+    TickType_t now = xTaskGetTickCount();
+    for (uint8_t i = 0; i < jobCount; i++) {
+        jobs[i].nextRelease = now;
+    }
+
+    bool ok = true;
+    for (uint8_t lane = 0; lane < SCHED_LANE_COUNT; lane++) {
+        bool used = false;
+        for (uint8_t i = 0; i < jobCount; i++) {
+            used = used || (jobs[i].lane == lane);
+        }
+        if (!used) {
+            continue;
+        }
+
+        BaseType_t created = xTaskCreatePinnedToCore(
+            laneLoop, laneCfg[lane].name, laneCfg[lane].stackSize,
+            (void*)(uintptr_t)lane, laneCfg[lane].priority,
+            &laneTask[lane], laneCfg[lane].core);
+
+        if (created != pdPASS) {
+            Serial.println("ERROR: Failed to create " + String(laneCfg[lane].name) + "!");
+            laneTask[lane] = NULL;
+            ok = false;
+        }
+#if PERF_ENABLED == STD_ON
+        Perf_RegisterTask(laneTask[lane], laneCfg[lane].name, laneCfg[lane].stackSize);
+#endif
+    }
+
+    started = true;
+    return ok;
+}
+
+void Sched_Signal(uint32_t events)
+{
+    for (uint8_t lane = 0; lane < SCHED_LANE_COUNT; lane++) {
+        // Only wake lanes that have a job waiting for one of these events
+        if (laneTask[lane] != NULL && (laneEvents[lane] & events) != 0) {
+            xTaskNotify(laneTask[lane], events & laneEvents[lane], eSetBits);
+        }
+    }
+}
+
+void Sched_SetPeriod(int8_t jobId, uint32_t periodMs)
+{
+    if (jobId < 0 || jobId >= jobCount || periodMs == 0 || jobs[jobId].cfg.periodMs == periodMs) {
+        return;
+    }
+    if (jobs[jobId].cfg.periodMs == 0) {
+        return;  // event-only jobs stay event-only
+    }
+    // The release already scheduled is kept; the new period applies from the one after
+    jobs[jobId].cfg.periodMs = periodMs;
+}
+
+bool Sched_GetStats(int8_t jobId, Sched_JobStats_t* stats)
+{
+    if (jobId < 0 || jobId >= jobCount || stats == NULL) {
+        return false;
+    }
+    *stats = jobs[jobId].stats;
+    return true;
+}
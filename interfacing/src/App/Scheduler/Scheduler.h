@@ -0,0 +1,65 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include "../../APP_Cfg.h"
+
+// Event-driven job scheduler
+// Jobs are registered on a lane; each lane is one FreeRTOS task (own core and
+// priority) that sleeps until its next periodic job is due or until one of
+// the events its jobs listen to is signalled. Jobs on a lane run cooperatively
+// in registration order, so jobs that are due at the same time share one wake-up.
+
+typedef enum
+{
+    SCHED_LANE_NET = 0,     // WiFi state machine, MQTT client
+    SCHED_LANE_IO,          // sensor sampling, MQTT application
+    SCHED_LANE_ML,          // history and inference
+    SCHED_LANE_COUNT
+} Sched_Lane_t;
+
+// Trigger events (bit mask)
+#define SCHED_EVT_NONE            0UL
+#define SCHED_EVT_LINK_UP         (1UL << 1)  // WiFi connected
+#define SCHED_EVT_LINK_DOWN       (1UL << 2)  // WiFi lost
+#define SCHED_EVT_THRESHOLD       (1UL << 3)  // soil moisture crossed its dry/wet threshold
+#define SCHED_EVT_HISTORY_READY   (1UL << 4)  // ML history window is full and has a new entry
+#define SCHED_EVT_OUTBOX          (1UL << 5)  // MQTT outbox has messages to send
+#define SCHED_EVT_ZONE_DEMAND     (1UL << 6)  // a zone's irrigation demand changed
+
+typedef void (*Sched_JobFn_t)(void);
+
+typedef struct
+{
+    const char* name;
+    Sched_JobFn_t run;
+    uint32_t periodMs;      // 0 = runs only on events
+    uint32_t deadlineMs;    // max time from release to completion, 0 = none
+    uint32_t events;        // SCHED_EVT_* that release the job immediately
+} Sched_JobCfg_t;
+
+typedef struct
+{
+    uint32_t runs;
+    uint32_t deadlineMisses;
+    uint32_t lastRunUs;
+    uint32_t maxRunUs;
+} Sched_JobStats_t;
+
+void Sched_Init(void);
+
+// Register before Sched_Start(); returns the job id or -1
+int8_t Sched_RegisterJob(Sched_Lane_t lane, const Sched_JobCfg_t* cfg);
+
+// Create the lane tasks
+bool Sched_Start(void);
+
+// Release every job listening to any of the given events (any task)
+void Sched_Signal(uint32_t events);
+
+// Change a periodic job's period from its next release on; call from a job on the same lane
+void Sched_SetPeriod(int8_t jobId, uint32_t periodMs);
+
+bool Sched_GetStats(int8_t jobId, Sched_JobStats_t* stats);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,161 @@
+#include <Arduino.h>
+#include "SensorBus.h"
+
+#if SENSORBUS_DEBUG == STD_ON
+#define DEBUG_PRINTLN(var) Serial.println(var)
+#else
+#define DEBUG_PRINTLN(var)
+#endif
+
+typedef struct
+{
+    SensorRing<SensorReading_t, SENSORBUS_DEPTH> ring;
+    LatestValue<SensorSample_t> latest;
+    uint32_t seq;                                   // producer-owned
+    uint32_t cursor[SENSORBUS_CONSUMER_COUNT];      // each entry owned by its consumer
+    uint32_t missed[SENSORBUS_CONSUMER_COUNT];
+} SensorBusChannel_t;
+
+static SensorBusChannel_t channels[SENSOR_CH_COUNT];
+
+void SensorBus_Init(void)
+{
+    for (uint8_t ch = 0; ch < SENSOR_CH_COUNT; ch++)
+    {
+        // Start every consumer at the current head so nothing old is replayed
+        uint32_t head = channels[ch].ring.published();
+        for (uint8_t c = 0; c < SENSORBUS_CONSUMER_COUNT; c++)
+        {
+            channels[ch].cursor[c] = head;
+            channels[ch].missed[c] = 0;
+        }
+    }
+    DEBUG_PRINTLN("Sensor Bus Initialized");
+}
+
+void SensorBus_Publish(SensorChannel_t channel, float value)
+{
+    if (channel >= SENSOR_CH_COUNT)
+    {
+        return;
+    }
+
+    SensorBusChannel_t *bus = &channels[channel];
+    SensorReading_t reading;
+    reading.value = value;
+    reading.tick = xTaskGetTickCount();
+    reading.seq = ++bus->seq;
+
+    bus->ring.push(reading);
+
+    SensorSample_t sample;
+    sample.value = value;
+    sample.tick = reading.tick;
+    sample.quality = SENSOR_QUALITY_GOOD;
+    bus->latest.store(sample);
+}
+
+void SensorBus_ReportFault(SensorChannel_t channel)
+{
+    if (channel >= SENSOR_CH_COUNT)
+    {
+        return;
+    }
+
+    // Keep the last good value and its tick, only flag the channel
+    SensorSample_t sample;
+    if (!channels[channel].latest.load(&sample))
+    {
+        sample.value = 0.0f;
+        sample.tick = xTaskGetTickCount();
+    }
+    sample.quality = SENSOR_QUALITY_FAULT;
+    channels[channel].latest.store(sample);
+}
+
+SensorQuality_t SensorBus_GetLatest(SensorChannel_t channel, SensorSample_t *sample)
+{
+    if (channel >= SENSOR_CH_COUNT || !channels[channel].latest.load(sample))
+    {
+        sample->value = 0.0f;
+        sample->tick = 0;
+        sample->quality = SENSOR_QUALITY_NONE;
+        return SENSOR_QUALITY_NONE;
+    }
+
+    if (sample->quality == SENSOR_QUALITY_GOOD &&
+        (xTaskGetTickCount() - sample->tick) > pdMS_TO_TICKS(SENSORBUS_STALE_MS))
+    {
+        sample->quality = SENSOR_QUALITY_STALE;
+    }
+    return sample->quality;
+}
+
+float SensorBus_GetGoodValue(SensorChannel_t channel)
+{
+    SensorSample_t sample;
+    return SensorBus_GetLatest(channel, &sample) == SENSOR_QUALITY_GOOD ? sample.value : NAN;
+}
+
+queue_t SensorBus_ReadNext(SensorBusConsumer_t consumer, SensorChannel_t channel, SensorReading_t *reading)
+{
+    if (channel >= SENSOR_CH_COUNT || consumer >= SENSORBUS_CONSUMER_COUNT)
+    {
+        return queue_empty;
+    }
+
+    SensorBusChannel_t *bus = &channels[channel];
+    return bus->ring.readFrom(&bus->cursor[consumer], reading, &bus->missed[consumer]);
+}
+
+queue_t SensorBus_ReadLatest(SensorBusConsumer_t consumer, SensorChannel_t channel, SensorReading_t *reading)
+{
+    if (channel >= SENSOR_CH_COUNT || consumer >= SENSORBUS_CONSUMER_COUNT)
+    {
+        return queue_empty;
+    }
+
+    SensorBusChannel_t *bus = &channels[channel];
+    if (bus->ring.published() == bus->cursor[consumer])
+    {
+        return queue_empty;
+    }
+    if (bus->ring.peek(reading) == queue_empty)
+    {
+        return queue_empty;
+    }
+
+    // seq is the ring position + 1, i.e. the cursor value just past this reading
+    bus->cursor[consumer] = reading->seq;
+    return queue_ok;
+}
+
+queue_t SensorBus_Peek(SensorChannel_t channel, SensorReading_t *reading)
+{
+    if (channel >= SENSOR_CH_COUNT)
+    {
+        return queue_empty;
+    }
+    return channels[channel].ring.peek(reading);
+}
+
+uint32_t SensorBus_Pending(SensorBusConsumer_t consumer, SensorChannel_t channel)
+{
+    if (channel >= SENSOR_CH_COUNT || consumer >= SENSORBUS_CONSUMER_COUNT)
+    {
+        return 0;
+    }
+
+    SensorBusChannel_t *bus = &channels[channel];
+    uint32_t pending = bus->ring.published() - bus->cursor[consumer];
+    return pending > SENSORBUS_DEPTH ? SENSORBUS_DEPTH : pending;
+}
+
+uint32_t SensorBus_Missed(SensorBusConsumer_t consumer, SensorChannel_t channel)
+{
+    if (channel >= SENSOR_CH_COUNT || consumer >= SENSORBUS_CONSUMER_COUNT)
+    {
+        return 0;
+    }
+    return channels[channel].missed[consumer];
+}
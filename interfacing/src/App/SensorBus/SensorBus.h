@@ -0,0 +1,93 @@
+#ifndef SENSORBUS_H
+#define SENSORBUS_H
+
+#include <stdint.h>
+#include "../../APP_Cfg.h"
+#include "../../Utils/SensorRing/SensorRing.h"
+#include "../../Utils/LatestValue/LatestValue.h"
+
+// Sensor Bus - publish/subscribe fan-out of sensor readings
+// Sensor modules publish each reading once; every consumer keeps its own read
+// cursor per channel, so reads are never destructive and one consumer cannot
+// steal samples from another. The last SENSORBUS_DEPTH readings stay in a
+// per-channel ring; a consumer that falls further behind has the readings it
+// lost counted in SensorBus_Missed().
+// Consumers that only need the current value use SensorBus_GetLatest(), a
+// wait-free read of a per-channel LatestValue cell with a quality flag.
+
+typedef enum
+{
+    SENSOR_CH_SOIL_MOISTURE = 0,
+    SENSOR_CH_TEMPERATURE,
+    SENSOR_CH_HUMIDITY,
+    SENSOR_CH_NITROGEN,
+    SENSOR_CH_PHOSPHORUS,
+    SENSOR_CH_POTASSIUM,
+    SENSOR_CH_PH,
+    SENSOR_CH_ZONE_MOISTURE,    // zones 1..ZONE_COUNT-1; zone 0 is SENSOR_CH_SOIL_MOISTURE
+    SENSOR_CH_COUNT = SENSOR_CH_ZONE_MOISTURE + ZONE_COUNT - 1
+} SensorChannel_t;
+
+// Soil moisture channel of a zone
+static inline SensorChannel_t SensorBus_ZoneMoistureChannel(uint8_t zone)
+{
+    return zone == 0 ? SENSOR_CH_SOIL_MOISTURE : (SensorChannel_t)(SENSOR_CH_ZONE_MOISTURE + zone - 1);
+}
+
+// Each consumer's cursor is only ever moved from that consumer's task
+typedef enum
+{
+    SENSORBUS_CONSUMER_ML = 0,
+    SENSORBUS_CONSUMER_TELEMETRY,
+    SENSORBUS_CONSUMER_PUMP_SAFETY,
+    SENSORBUS_CONSUMER_COUNT
+} SensorBusConsumer_t;
+
+typedef enum
+{
+    SENSOR_QUALITY_NONE = 0,    // nothing published yet
+    SENSOR_QUALITY_GOOD,
+    SENSOR_QUALITY_STALE,       // older than SENSORBUS_STALE_MS
+    SENSOR_QUALITY_FAULT        // last read attempt failed, value is the last good one
+} SensorQuality_t;
+
+typedef struct
+{
+    float value;
+    uint32_t tick;  // xTaskGetTickCount() at publish time
+    uint32_t seq;   // per-channel sequence number, starts at 1
+} SensorReading_t;
+
+typedef struct
+{
+    float value;
+    uint32_t tick;
+    SensorQuality_t quality;
+} SensorSample_t;
+
+void SensorBus_Init(void);
+
+// Producer side - called from the sensor sampling task
+void SensorBus_Publish(SensorChannel_t channel, float value);
+void SensorBus_ReportFault(SensorChannel_t channel);
+
+// Latest (value, tick, quality) of a channel, wait-free; returns sample->quality
+SensorQuality_t SensorBus_GetLatest(SensorChannel_t channel, SensorSample_t *sample);
+
+// Latest value if it is GOOD; NAN when the channel is stale, faulted or was
+// never published, for a field that should be left out rather than sent old
+float SensorBus_GetGoodValue(SensorChannel_t channel);
+
+// Oldest reading this consumer has not seen yet
+queue_t SensorBus_ReadNext(SensorBusConsumer_t consumer, SensorChannel_t channel, SensorReading_t *reading);
+
+// Newest reading if the consumer has anything unread; skips the rest
+queue_t SensorBus_ReadLatest(SensorBusConsumer_t consumer, SensorChannel_t channel, SensorReading_t *reading);
+
+// Newest reading regardless of any consumer cursor
+queue_t SensorBus_Peek(SensorChannel_t channel, SensorReading_t *reading);
+
+uint32_t SensorBus_Pending(SensorBusConsumer_t consumer, SensorChannel_t channel);
+uint32_t SensorBus_Missed(SensorBusConsumer_t consumer, SensorChannel_t channel);
+
+#endif // SENSORBUS_H
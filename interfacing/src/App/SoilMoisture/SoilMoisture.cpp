@@ -1,87 +1,111 @@
 #include <Arduino.h>
 #include "../../APP_Cfg.h"
 #include "../../Hal/ADC/ADC.h"
+#include "../SensorBus/SensorBus.h"
+#include "../Scheduler/Scheduler.h"
+#include "../Perf/Perf.h"
 #include "SoilMoisture.h"
 
-static uint8_t Soil_Moisture_Queue[Moisture_QUEUE_SIZE];
-static uint8_t in;
-static uint8_t out;
-static uint8_t count;
 #if SOILMOISTURE_DEBUG == STD_ON
 #define DEBUG_PRINTLN(var) Serial.println(var)
 #else
 #define DEBUG_PRINTLN(var)
 #endif
 
-static void inq(int data)
-{{
-        if (in == Moisture_QUEUE_SIZE)
-        {
-            in = 0;
-        }
-        else
-        {
-            ;
-        }
-        Soil_Moisture_Queue[in++] = data;
-        count++;
+static constexpr uint8_t zonePins[ZONE_COUNT] = ZONE_MOISTURE_PINS;
+
+// Every zone probe needs an ADC pin of its own: ADC_Init() keeps one channel
+// per pin, so a shared pin would hand one filtered value to two users.
+static constexpr bool adcPinClaimed(uint8_t pin)
+{
+    return (POT_ENABLED == STD_ON && pin == POT_PIN) ||
+           (LM35_ENABLED == STD_ON && pin == LM35_PIN) ||
+           (Nitrogen_ENABLED == STD_ON && pin == Nitrogen_SENSOR_PIN) ||
+           (Phosphorus_ENABLED == STD_ON && pin == Phosphorus_SENSOR_PIN) ||
+           (Potassium_ENABLED == STD_ON && pin == Potassium_SENSOR_PIN) ||
+           (PH_ENABLED == STD_ON && pin == PH_SENSOR_PIN);
 }
 
-static queue_t deq(int *data)
+static constexpr bool zonePinRepeated(uint8_t zone, uint8_t other)
 {
-    queue_t status = queue_ok;
-    if (out == Moisture_QUEUE_SIZE)
-    {
-        out = 0;
-    }
-    else
-    {
-        ;
-    }
-    if ((in == out) && (count == 0))
-    {
-        status = queue_empty;
-    }
-    else
-    {
-        *(data) = Soil_Moisture_Queue[out++];
-        status = queue_ok;
-        count--;
-    }
-    return status;
+    return other < ZONE_COUNT && (zonePins[other] == zonePins[zone] || zonePinRepeated(zone, other + 1));
 }
 
-static SoilMoisture_t defaultSoilMoistureConfig = {
-    {SOILMOISTURE_PIN, SOILMOISTURE_RESOLUTION}};
+static constexpr bool zonePinsFree(uint8_t zone)
+{
+    return zone >= ZONE_COUNT ||
+           (!adcPinClaimed(zonePins[zone]) && !zonePinRepeated(zone, zone + 1) && zonePinsFree(zone + 1));
+}
+
+static_assert(zonePinsFree(0), "ZONE_MOISTURE_PINS collides with another ADC user or repeats a pin");
+
+// One probe per irrigation zone
+static SoilMoisture_t zoneSoilMoistureConfig[ZONE_COUNT];
+
+static bool soilIsDry[ZONE_COUNT];
+static bool soilStateKnown[ZONE_COUNT];
 
 void SoilMoisture_Init(void)
 {
 #if SOILMOISTURE_ENABLED == STD_ON
     DEBUG_PRINTLN("Soil Moisture Sensor Initialized");
 
-    ADC_Init(&(defaultSoilMoistureConfig.adcConfig));
-    DEBUG_PRINTLN("Soil Moisture Channel: " + String(defaultSoilMoistureConfig.adcConfig.channel));
-    DEBUG_PRINTLN("Soil Moisture Resolution: " + String(defaultSoilMoistureConfig.adcConfig.resolution));
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        SoilMoisture_t config = {{zonePins[zone], SOILMOISTURE_RESOLUTION, SOILMOISTURE_FILTER_CFG}};
+        zoneSoilMoistureConfig[zone] = config;
+        soilStateKnown[zone] = false;
+
+        ADC_Init(&(zoneSoilMoistureConfig[zone].adcConfig));
+        DEBUG_PRINTLN("Soil Moisture Zone " + String(zone) + " Channel: " + String(zoneSoilMoistureConfig[zone].adcConfig.channel));
+    }
+    DEBUG_PRINTLN("Soil Moisture Resolution: " + String(SOILMOISTURE_RESOLUTION));
 #endif
 }
 
 void SoilMoisture_main(void)
 {
 #if SOILMOISTURE_ENABLED == STD_ON
-    uint32_t rawValue = ADC_ReadValue(defaultSoilMoistureConfig.adcConfig.channel);
-    uint8_t moisture = map(rawValue, DRY_VALUE, WET_VALUE, 0, 100);
-    DEBUG_PRINTLN("Soil Moisture Read Value: " + String(rawValue));
-    DEBUG_PRINTLN("Soil Moisture percentage: " + String(moisture));
-    inq(moisture);
+    PERF_SCOPE("SoilMoisture_main");
+    bool crossed = false;
+
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        uint32_t rawValue = ADC_ReadValue(zoneSoilMoistureConfig[zone].adcConfig.channel);
+        // Clamp: a filtered reading outside the calibration range must not wrap the uint8_t
+        uint8_t moisture = constrain(map(rawValue, DRY_VALUE, WET_VALUE, 0, 100), 0L, 100L);
+        DEBUG_PRINTLN("Soil Moisture Zone " + String(zone) + " Read Value: " + String(rawValue));
+        DEBUG_PRINTLN("Soil Moisture percentage: " + String(moisture));
+        SensorBus_Publish(SensorBus_ZoneMoistureChannel(zone), (float)moisture);
 
+        // Dry/wet crossing with hysteresis wakes the decision job without waiting for its timer
+        bool dry = soilIsDry[zone] ? (moisture < SOILMOISTURE_DRY_THRESHOLD + SOILMOISTURE_THRESHOLD_HYST)
+                                   : (moisture < SOILMOISTURE_DRY_THRESHOLD);
+        if (soilStateKnown[zone] && dry != soilIsDry[zone]) {
+            DEBUG_PRINTLN(dry ? "Soil moisture below threshold" : "Soil moisture above threshold");
+            crossed = true;
+        }
+        soilIsDry[zone] = dry;
+        soilStateKnown[zone] = true;
+    }
+
+    // One decision run covers every zone
+    if (crossed) {
+        Sched_Signal(SCHED_EVT_THRESHOLD);
+    }
 #endif
 }
 void SoilMoisture_getMoisture(uint8_t *moisture)
 {
 #if SOILMOISTURE_ENABLED == STD_ON
-    if (deq((int *)moisture) == queue_empty)
+    SensorSample_t sample;
+    if (SensorBus_GetLatest(SENSOR_CH_SOIL_MOISTURE, &sample) != SENSOR_QUALITY_NONE)
+    {
+        *moisture = (uint8_t)sample.value;
+    }
+    else
     {
-        *moisture = 0; // Indicate that the queue is empty
+        *moisture = 0; // No reading published yet
     }
 #endif
 }
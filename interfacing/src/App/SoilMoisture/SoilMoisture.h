@@ -8,11 +8,6 @@ typedef struct{
     ADC_t adcConfig;
 }SoilMoisture_t;
 
-typedef enum
-{
-    queue_ok,
-    queue_empty,
-}queue_t;
 #define DRY_VALUE   3800
 
 #define WET_VALUE   1250    
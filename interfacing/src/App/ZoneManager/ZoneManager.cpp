@@ -0,0 +1,297 @@
+#include <Arduino.h>
+#include <atomic>
+#include "ZoneManager.h"
+#include "../SensorBus/SensorBus.h"
+#include "../Scheduler/Scheduler.h"
+#include "../../Hal/Pump/Pump.h"
+
+#if ZONE_DEBUG == STD_ON
+#define DEBUG_PRINTLN(var) Serial.println(var)
+#else
+#define DEBUG_PRINTLN(var)
+#endif
+
+static const uint8_t zoneOutputPins[] = ZONE_OUTPUT_PINS;
+static const uint16_t zoneCurrentMa[] = ZONE_CURRENT_MA;
+static const float zoneFlowLpm[] = ZONE_FLOW_LPM;
+
+static_assert(sizeof(zoneOutputPins) / sizeof(zoneOutputPins[0]) == ZONE_COUNT &&
+              sizeof(zoneCurrentMa) / sizeof(zoneCurrentMa[0]) == ZONE_COUNT &&
+              sizeof(zoneFlowLpm) / sizeof(zoneFlowLpm[0]) == ZONE_COUNT,
+              "ZONE_OUTPUT_PINS, ZONE_CURRENT_MA and ZONE_FLOW_LPM need one entry per zone");
+
+typedef struct
+{
+    Pump_t output;
+    bool fits;                  // can run at all within the limits
+    bool on;
+    bool queued;                // wants water and is waiting for a turn
+    TickType_t queuedTick;
+    TickType_t startTick;       // current turn
+    bool wet;                   // a probe reading since the last run was at ZONE_STOP_MOISTURE
+    uint32_t missed;            // probe readings lost before the zone job saw them
+} Zone_t;
+
+// Written by the ML lane / MQTT, read by the zone job
+static std::atomic<uint8_t> zoneDecision[ZONE_COUNT];
+static std::atomic<uint8_t> zoneOverride[ZONE_COUNT];
+
+// Owned by the zone job
+static Zone_t zones[ZONE_COUNT];
+
+// Published by the zone job
+static std::atomic<bool> zoneWatering[ZONE_COUNT];
+static std::atomic<uint32_t> currentMa(0);
+
+// Pump safety reads every probe reading since the last run through its own
+// bus cursor, so a wet reading between two zone jobs still stops the zone.
+// Readings lost to a full ring were never checked: a running zone stops.
+static void zoneCheckMoisture(uint8_t zone)
+{
+    Zone_t* z = &zones[zone];
+    SensorChannel_t channel = SensorBus_ZoneMoistureChannel(zone);
+    SensorReading_t reading;
+    bool seen = false;
+    bool wet = false;
+
+    while (SensorBus_ReadNext(SENSORBUS_CONSUMER_PUMP_SAFETY, channel, &reading) == queue_ok)
+    {
+        seen = true;
+        wet = wet || reading.value >= ZONE_STOP_MOISTURE;
+    }
+
+    uint32_t missed = SensorBus_Missed(SENSORBUS_CONSUMER_PUMP_SAFETY, channel);
+    if (missed != z->missed)
+    {
+        Serial.println("[ZONE] Zone " + String(zone) + " missed " + String(missed - z->missed) + " moisture readings");
+        z->missed = missed;
+        wet = wet || z->on;
+    }
+
+    if (seen || wet)
+    {
+        z->wet = wet;
+    }
+}
+
+// Should the zone be on, ignoring the limits
+static bool zoneWants(uint8_t zone)
+{
+    ZoneOverride_t override = (ZoneOverride_t)zoneOverride[zone].load(std::memory_order_relaxed);
+    if (override == ZONE_OVERRIDE_OFF)
+    {
+        return false;
+    }
+
+    SensorSample_t moisture;
+    SensorQuality_t quality = SensorBus_GetLatest(SensorBus_ZoneMoistureChannel(zone), &moisture);
+    if (quality == SENSOR_QUALITY_GOOD && zones[zone].wet)
+    {
+        return false;
+    }
+    if (override == ZONE_OVERRIDE_ON)
+    {
+        return true;
+    }
+
+    // The model only waters on a current reading
+    return quality == SENSOR_QUALITY_GOOD &&
+           zoneDecision[zone].load(std::memory_order_relaxed) == DECISION_IRRIGATE;
+}
+
+void ZoneManager_Init(void)
+{
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        Zone_t* z = &zones[zone];
+        z->output.pwmConfig.channel = zoneOutputPins[zone];
+        z->output.pwmConfig.resolution = 8;
+        z->output.speed = 0.0f;
+        Pump_Init(&z->output);
+
+        z->fits = zoneCurrentMa[zone] <= ZONE_CURRENT_LIMIT_MA && zoneFlowLpm[zone] <= ZONE_FLOW_LIMIT_LPM;
+        z->on = false;
+        z->queued = false;
+        z->wet = false;
+        z->missed = SensorBus_Missed(SENSORBUS_CONSUMER_PUMP_SAFETY, SensorBus_ZoneMoistureChannel(zone));
+        zoneDecision[zone].store(DECISION_NO_IRRIGATION);
+        zoneOverride[zone].store(ZONE_OVERRIDE_AUTO);
+        zoneWatering[zone].store(false);
+
+        if (!z->fits)
+        {
+            Serial.println("[ZONE] Zone " + String(zone) + " exceeds the current/flow limit and will never run");
+        }
+    }
+    currentMa.store(0);
+    DEBUG_PRINTLN("[ZONE] " + String(ZONE_COUNT) + " zones initialized");
+}
+
+void ZoneManager_main(void)
+{
+    TickType_t now = xTaskGetTickCount();
+    bool next[ZONE_COUNT];
+    bool anyWaiting = false;
+
+    // Keep what still wants water; queue what newly does
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        Zone_t* z = &zones[zone];
+        zoneCheckMoisture(zone);
+        bool wants = z->fits && zoneWants(zone);
+        next[zone] = z->on && wants;
+
+        if (wants && !z->on)
+        {
+            if (!z->queued)
+            {
+                z->queued = true;
+                z->queuedTick = now;
+            }
+            anyWaiting = true;
+        }
+        else if (!wants)
+        {
+            z->queued = false;
+        }
+    }
+
+    // A zone that had its turn goes to the back of the queue
+    if (anyWaiting)
+    {
+        for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+        {
+            Zone_t* z = &zones[zone];
+            if (next[zone] && now - z->startTick >= pdMS_TO_TICKS(ZONE_MAX_RUN_S * 1000UL))
+            {
+                next[zone] = false;
+                z->queued = true;
+                z->queuedTick = now;
+            }
+        }
+    }
+
+    uint32_t totalMa = 0;
+    float totalLpm = 0.0f;
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        if (next[zone])
+        {
+            totalMa += zoneCurrentMa[zone];
+            totalLpm += zoneFlowLpm[zone];
+        }
+    }
+
+    // Admit queued zones, longest waiting first, while they fit
+    for (;;)
+    {
+        int8_t pick = -1;
+        for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+        {
+            const Zone_t* z = &zones[zone];
+            if (z->queued && !next[zone] &&
+                totalMa + zoneCurrentMa[zone] <= ZONE_CURRENT_LIMIT_MA &&
+                totalLpm + zoneFlowLpm[zone] <= ZONE_FLOW_LIMIT_LPM &&
+                (pick < 0 || (int32_t)(z->queuedTick - zones[pick].queuedTick) < 0))
+            {
+                pick = (int8_t)zone;
+            }
+        }
+        if (pick < 0)
+        {
+            break;
+        }
+        next[pick] = true;
+        zones[pick].queued = false;
+        zones[pick].startTick = now;    // a zone that yielded and got straight back starts a new turn
+        totalMa += zoneCurrentMa[pick];
+        totalLpm += zoneFlowLpm[pick];
+    }
+
+    // Stops before starts, so the supply never sees both at once
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        if (zones[zone].on && !next[zone])
+        {
+            Pump_Run(&zones[zone].output, 0.0f);
+            zones[zone].on = false;
+            zoneWatering[zone].store(false);
+            DEBUG_PRINTLN("[ZONE] Zone " + String(zone) + " off");
+        }
+    }
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        if (!zones[zone].on && next[zone])
+        {
+            Pump_Run(&zones[zone].output, 100.0f);
+            zones[zone].on = true;
+            zoneWatering[zone].store(true);
+            DEBUG_PRINTLN("[ZONE] Zone " + String(zone) + " on, " + String(totalMa) + " mA total");
+        }
+    }
+    currentMa.store(totalMa);
+}
+
+void ZoneManager_StopAll(void)
+{
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        if (zones[zone].on)
+        {
+            Pump_Run(&zones[zone].output, 0.0f);
+            zones[zone].on = false;
+            zoneWatering[zone].store(false);
+            DEBUG_PRINTLN("[ZONE] Zone " + String(zone) + " off");
+        }
+        zones[zone].queued = false;
+    }
+    currentMa.store(0);
+}
+
+bool ZoneManager_SetDecision(uint8_t zone, Decision_t decision)
+{
+    if (zone >= ZONE_COUNT)
+    {
+        return false;
+    }
+    if (zoneDecision[zone].exchange((uint8_t)decision) != (uint8_t)decision)
+    {
+        Sched_Signal(SCHED_EVT_ZONE_DEMAND);
+    }
+    return true;
+}
+
+bool ZoneManager_SetOverride(uint8_t zone, ZoneOverride_t override)
+{
+    if (zone >= ZONE_COUNT)
+    {
+        return false;
+    }
+    if (zoneOverride[zone].exchange((uint8_t)override) != (uint8_t)override)
+    {
+        Sched_Signal(SCHED_EVT_ZONE_DEMAND);
+    }
+    return true;
+}
+
+bool ZoneManager_IsWatering(uint8_t zone)
+{
+    return zone < ZONE_COUNT && zoneWatering[zone].load();
+}
+
+bool ZoneManager_AnyWatering(void)
+{
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        if (zoneWatering[zone].load())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t ZoneManager_GetCurrentMa(void)
+{
+    return currentMa.load();
+}
@@ -0,0 +1,43 @@
+#ifndef ZONE_MANAGER_H
+#define ZONE_MANAGER_H
+
+#include <stdint.h>
+#include "../../APP_Cfg.h"
+#include "../MQTT_APP/mqtt_app.h"
+
+// Zone Manager - one soil moisture probe and one pump/valve output per zone
+// The ML lane hands in a decision per zone and MQTT may override a zone; the
+// zone job on the IO lane is the only one that switches outputs. It turns on
+// as many waiting zones as fit ZONE_CURRENT_LIMIT_MA and ZONE_FLOW_LIMIT_LPM,
+// longest waiting first. A zone that has run ZONE_MAX_RUN_S gives its turn to
+// a waiting one. A zone stops when any probe reading since the last zone
+// job reached ZONE_STOP_MOISTURE (read through the pump safety bus cursor,
+// with a good current reading), or when readings were lost unchecked.
+
+typedef enum
+{
+    ZONE_OVERRIDE_AUTO = 0,     // follow the model
+    ZONE_OVERRIDE_ON,           // water regardless of the model, within the limits
+    ZONE_OVERRIDE_OFF
+} ZoneOverride_t;
+
+void ZoneManager_Init(void);
+
+// Scheduler job (IO lane), released by SCHED_EVT_ZONE_DEMAND
+void ZoneManager_main(void);
+
+// Switch every output off and drop the queue; from the zone job's task only.
+// The duty cycle calls it before sleeping, as outputs do not hold through sleep.
+void ZoneManager_StopAll(void);
+
+// Any task; false for an unknown zone
+bool ZoneManager_SetDecision(uint8_t zone, Decision_t decision);
+bool ZoneManager_SetOverride(uint8_t zone, ZoneOverride_t override);
+
+bool ZoneManager_IsWatering(uint8_t zone);
+bool ZoneManager_AnyWatering(void);
+
+// Draw of all zones that are on
+uint32_t ZoneManager_GetCurrentMa(void);
+
+#endif // ZONE_MANAGER_H
@@ -2,6 +2,16 @@
 #include "../../APP_Cfg.h"
 #include "ADC.h"
 
+#if ADC_MODE == ADC_MODE_CONTINUOUS
+#include <esp_arduino_version.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "../../Utils/LatestValue/LatestValue.h"
+#if ESP_ARDUINO_VERSION_MAJOR < 3
+#error "ADC_MODE_CONTINUOUS needs arduino-esp32 3.x (analogContinuous API)"
+#endif
+#endif
+
 
 #if ADC_DEBUG == STD_ON
 #define DEBUG_PRINTLN(var) Serial.println(var)
@@ -9,22 +19,210 @@
 #define DEBUG_PRINTLN(var)
 #endif
 
+#define ADC_NO_SLOT 0xFF
+#define ADC_PIN_COUNT 40
+
+// Registered channels, shared by both modes; each has its own filter pipeline
+static uint8_t adcPins[ADC_MAX_CHANNELS];
+static uint8_t adcPinCount = 0;
+static uint8_t adcSlot[ADC_PIN_COUNT];          // pin -> index in adcPins
+static bool adcSlotsReady = false;
+static ADC_FilterCfg_t adcFilterCfg[ADC_MAX_CHANNELS];
+static ADC_FilterState_t adcFilterState[ADC_MAX_CHANNELS];
+
+static void adcRegisterChannel(const ADC_t* config)
+{
+    if (!adcSlotsReady) {
+        memset(adcSlot, ADC_NO_SLOT, sizeof(adcSlot));
+        adcSlotsReady = true;
+    }
+    uint8_t pin = config->channel;
+    if (pin >= ADC_PIN_COUNT || adcSlot[pin] != ADC_NO_SLOT) {
+        return;
+    }
+    if (adcPinCount >= ADC_MAX_CHANNELS) {
+        DEBUG_PRINTLN("ADC channel table full, pin " + String(pin) + " ignored");
+        return;
+    }
+    adcSlot[pin] = adcPinCount;
+    adcFilterCfg[adcPinCount] = config->filter;
+    ADC_Filter_Reset(&adcFilterState[adcPinCount]);
+    adcPins[adcPinCount++] = pin;
+}
+
+static uint8_t adcSlotOf(uint8_t pin)
+{
+    return (adcSlotsReady && pin < ADC_PIN_COUNT) ? adcSlot[pin] : ADC_NO_SLOT;
+}
+
+#if ADC_MODE == ADC_MODE_CONTINUOUS
+// One averaged reading of every registered channel. Published through a
+// LatestValue latch, which is the double buffer between the ADC task and readers.
+typedef struct {
+    uint16_t raw[ADC_MAX_CHANNELS];
+    uint32_t frame;
+} ADC_Frame_t;
+
+static volatile bool adcRunning = false;
+static bool adcStartFailed = false;     // reads stay oneshot until ADC_StartContinuous() is called again
+static TaskHandle_t adcTaskHandle = NULL;
+static LatestValue<ADC_Frame_t> adcFrame;
+
+// Called from the ADC driver ISR each time a DMA frame is complete
+static void ARDUINO_ISR_ATTR adcConversionDone(void)
+{
+    BaseType_t woken = pdFALSE;
+    if (adcTaskHandle != NULL) {
+        vTaskNotifyGiveFromISR(adcTaskHandle, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+// Drains DMA frames, decimates and filters them; all averaging happens here so
+// readers only copy the last published frame
+static void adcTask(void*)
+{
+    uint32_t acc[ADC_MAX_CHANNELS] = {0};
+    uint32_t frames = 0;
+    ADC_Frame_t out = {};
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        adc_continuous_data_t* result = NULL;
+        if (!analogContinuousRead(&result, 0) || result == NULL) {
+            continue;
+        }
+
+        for (uint8_t i = 0; i < adcPinCount; i++) {
+            uint8_t slot = adcSlotOf(result[i].pin);
+            if (slot != ADC_NO_SLOT) {
+                acc[slot] += (uint32_t)result[i].avg_read_raw;
+            }
+        }
+
+        if (++frames >= ADC_CONT_DECIMATION) {
+            for (uint8_t i = 0; i < adcPinCount; i++) {
+                out.raw[i] = ADC_Filter_Apply(&adcFilterCfg[i], &adcFilterState[i],
+                                              (uint16_t)(acc[i] / frames));
+                acc[i] = 0;
+            }
+            out.frame++;
+            adcFrame.store(out);
+            frames = 0;
+        }
+    }
+}
+
+#endif
 
 
 void ADC_Init(ADC_t* config) {
 #if ADC_ENABLED == STD_ON
     DEBUG_PRINTLN("ADC Initialized");
-    
+
     DEBUG_PRINTLN("Channel: " + String(config->channel));
 
     DEBUG_PRINTLN("Resolution: " + String(config->resolution));
     analogReadResolution(config->resolution);
+    adcRegisterChannel(config);
+#endif
+}
+
+#if ADC_MODE == ADC_MODE_CONTINUOUS
+// Seed the frame, start the ADC task and the DMA scan
+static bool adcStartScan(void) {
+    if (adcRunning) {
+        return true;
+    }
+    if (adcPinCount == 0) {
+        DEBUG_PRINTLN("ADC continuous: no channels registered");
+        return false;
+    }
+
+    // Seed the frame with one blocking read per channel so readers have data
+    // before the first decimated frame is ready
+    ADC_Frame_t seed = {};
+    for (uint8_t i = 0; i < adcPinCount; i++) {
+        seed.raw[i] = (uint16_t)analogRead(adcPins[i]);
+    }
+    adcFrame.store(seed);
+
+    if (adcTaskHandle == NULL) {
+        xTaskCreatePinnedToCore(adcTask, "adcTask", ADC_TASK_STACK_SIZE, NULL,
+                                ADC_TASK_PRIORITY, &adcTaskHandle, ADC_TASK_CORE);
+    }
+
+    analogContinuousSetWidth(ADC_CONT_RESOLUTION);
+    if (!analogContinuous(adcPins, adcPinCount, ADC_CONT_CONVERSIONS_PER_PIN,
+                          ADC_CONT_SAMPLE_FREQ_HZ, adcConversionDone)) {
+        DEBUG_PRINTLN("ADC continuous: driver setup failed");
+        return false;
+    }
+    if (!analogContinuousStart()) {
+        DEBUG_PRINTLN("ADC continuous: start failed");
+        analogContinuousDeinit();
+        return false;
+    }
+
+    adcRunning = true;
+    DEBUG_PRINTLN("ADC continuous mode started on " + String(adcPinCount) + " channels");
+    return true;
+}
+#endif
+
+bool ADC_StartContinuous(void) {
+#if ADC_ENABLED == STD_ON && ADC_MODE == ADC_MODE_CONTINUOUS
+    bool started = adcStartScan();
+    adcStartFailed = !started;
+    return started;
+#else
+    return false;
+#endif
+}
+
+void ADC_StopContinuous(void) {
+#if ADC_ENABLED == STD_ON && ADC_MODE == ADC_MODE_CONTINUOUS
+    if (!adcRunning) {
+        return;
+    }
+    adcRunning = false;
+    analogContinuousStop();
+    analogContinuousDeinit();
+    DEBUG_PRINTLN("ADC continuous mode stopped");
+#endif
+}
+
+uint32_t ADC_GetFrameCount(void) {
+#if ADC_ENABLED == STD_ON && ADC_MODE == ADC_MODE_CONTINUOUS
+    ADC_Frame_t frame;
+    return adcFrame.load(&frame) ? frame.frame : 0;
+#else
+    return 0;
 #endif
 }
 
 uint32_t ADC_ReadValue(uint8_t channel) {
 #if ADC_ENABLED == STD_ON
+#if ADC_MODE == ADC_MODE_CONTINUOUS
+    if (!adcRunning && !adcStartFailed) {
+        ADC_StartContinuous();
+    }
+    uint8_t slot = adcSlotOf(channel);
+    ADC_Frame_t frame;
+    if (adcRunning && slot != ADC_NO_SLOT && adcFrame.load(&frame)) {
+        DEBUG_PRINTLN("Read Value from channel " + String(channel) + ": " + String(frame.raw[slot]));
+        return frame.raw[slot];
+    }
+    // Not part of the DMA scan (or scan failed to start): fall back to a blocking read
+#endif
     int rawValue = analogRead(channel);
+#if ADC_MODE == ADC_MODE_ONESHOT
+    uint8_t slot = adcSlotOf(channel);
+    if (slot != ADC_NO_SLOT) {
+        rawValue = ADC_Filter_Apply(&adcFilterCfg[slot], &adcFilterState[slot], (uint16_t)rawValue);
+    }
+#endif
     DEBUG_PRINTLN("Read Value from channel " + String(channel) + ": " + String(rawValue));
     return rawValue;
 #else
@@ -1,17 +1,27 @@
 #ifndef ADC_H
 #define ADC_H
 #include <stdint.h>
+#include "ADC_Filter.h"
 
 
 typedef struct{
     uint8_t channel;
     uint8_t resolution;
+    ADC_FilterCfg_t filter;     // zero = unfiltered
 }ADC_t;
 
 
-
 void ADC_Init(ADC_t* config);
 
 uint32_t ADC_ReadValue(uint8_t channel);
 
+// Continuous mode: start the DMA scan over every channel passed to ADC_Init().
+// Called automatically by the first ADC_ReadValue(); no-op in oneshot mode.
+// After a failed start reads stay oneshot until this is called again.
+bool ADC_StartContinuous(void);
+void ADC_StopContinuous(void);
+
+// Number of averaged frames published since start (0 in oneshot mode)
+uint32_t ADC_GetFrameCount(void);
+
 #endif
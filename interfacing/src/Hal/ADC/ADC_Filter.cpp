@@ -0,0 +1,85 @@
+#include <string.h>
+#include "ADC_Filter.h"
+
+
+static uint16_t medianOf(const uint16_t* window, uint8_t count)
+{
+    // Insertion sort of at most ADC_FILTER_MEDIAN_N values - constant cost
+    uint16_t sorted[ADC_FILTER_MEDIAN_N];
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t v = window[i];
+        int8_t j = (int8_t)i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+    return sorted[count / 2];
+}
+
+void ADC_Filter_Reset(ADC_FilterState_t* state)
+{
+    memset(state, 0, sizeof(*state));
+}
+
+uint16_t ADC_Filter_Apply(const ADC_FilterCfg_t* cfg, ADC_FilterState_t* state, uint16_t raw)
+{
+    uint16_t x = raw;
+
+    if (cfg == NULL || cfg->stages == ADC_FILTER_NONE) {
+        return x;
+    }
+
+    // Outlier rejection against the last accepted sample
+    if (cfg->stages & ADC_FILTER_OUTLIER) {
+        if (state->primed) {
+            int32_t jump = (int32_t)x - (int32_t)state->lastAccepted;
+            if (jump < 0) jump = -jump;
+            if (jump > cfg->outlierThreshold && state->rejects < ADC_FILTER_MAX_REJECTS) {
+                state->rejects++;
+                x = state->lastAccepted;
+            } else {
+                state->rejects = 0;
+                state->lastAccepted = x;
+            }
+        } else {
+            state->lastAccepted = x;
+        }
+    }
+
+    // Median of the last N
+    if (cfg->stages & ADC_FILTER_MEDIAN) {
+        state->median[state->medianIndex] = x;
+        state->medianIndex = (state->medianIndex + 1) % ADC_FILTER_MEDIAN_N;
+        if (state->medianCount < ADC_FILTER_MEDIAN_N) state->medianCount++;
+        x = medianOf(state->median, state->medianCount);
+    }
+
+    // Moving average with a running sum
+    if (cfg->stages & ADC_FILTER_AVERAGE) {
+        if (state->averageCount == ADC_FILTER_AVERAGE_N) {
+            state->averageSum -= state->average[state->averageIndex];
+        } else {
+            state->averageCount++;
+        }
+        state->average[state->averageIndex] = x;
+        state->averageSum += x;
+        state->averageIndex = (state->averageIndex + 1) & (ADC_FILTER_AVERAGE_N - 1);
+        x = (uint16_t)(state->averageSum / state->averageCount);
+    }
+
+    // Exponential moving average in Q24.8
+    if (cfg->stages & ADC_FILTER_EMA) {
+        int32_t xQ8 = (int32_t)x << 8;
+        if (!state->primed) {
+            state->emaQ8 = xQ8;
+        } else {
+            state->emaQ8 += (xQ8 - state->emaQ8) >> cfg->emaShift;
+        }
+        x = (uint16_t)((state->emaQ8 + 128) >> 8);
+    }
+
+    state->primed = true;
+    return x;
+}
@@ -0,0 +1,42 @@
+#ifndef ADC_FILTER_H
+#define ADC_FILTER_H
+#include <stdint.h>
+
+// Per-channel fixed-point filter pipeline for raw ADC samples.
+// Stages run in the order listed below and each costs O(1) per sample.
+#define ADC_FILTER_NONE       0x00
+#define ADC_FILTER_OUTLIER    0x01  // hold the last accepted value on a jump > outlierThreshold
+#define ADC_FILTER_MEDIAN     0x02  // median of the last ADC_FILTER_MEDIAN_N samples
+#define ADC_FILTER_AVERAGE    0x04  // moving average over ADC_FILTER_AVERAGE_N samples
+#define ADC_FILTER_EMA        0x08  // y += (x - y) / 2^emaShift
+
+#define ADC_FILTER_MEDIAN_N        5
+#define ADC_FILTER_AVERAGE_N       8   // power of two
+#define ADC_FILTER_MAX_REJECTS     3   // consecutive outliers accepted as a real step
+
+typedef struct{
+    uint8_t stages;             // ADC_FILTER_* flags
+    uint8_t emaShift;           // EMA smoothing, 1..8
+    uint16_t outlierThreshold;  // raw counts
+}ADC_FilterCfg_t;
+
+typedef struct{
+    uint16_t median[ADC_FILTER_MEDIAN_N];
+    uint16_t average[ADC_FILTER_AVERAGE_N];
+    uint32_t averageSum;
+    int32_t emaQ8;              // EMA state in Q24.8
+    uint16_t lastAccepted;
+    uint8_t medianIndex;
+    uint8_t medianCount;
+    uint8_t averageIndex;
+    uint8_t averageCount;
+    uint8_t rejects;
+    bool primed;
+}ADC_FilterState_t;
+
+
+void ADC_Filter_Reset(ADC_FilterState_t* state);
+
+uint16_t ADC_Filter_Apply(const ADC_FilterCfg_t* cfg, ADC_FilterState_t* state, uint16_t raw);
+
+#endif
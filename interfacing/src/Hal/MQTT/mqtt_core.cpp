@@ -2,7 +2,11 @@
 #include <WiFi.h>
 #include <PubSubClient.h>
 #include <string.h>
+#include <atomic>
+#include "mqtt_sniff_client.h"
+#include "mqtt_dispatch.h"
 #include "../WIFI/wifi.h"
+#include "../../Utils/BoundedQueue/BoundedQueue.h"
 #include "../../APP_Cfg.h"
 
 #if MQTT_DEBUG == STD_ON
@@ -11,16 +15,69 @@
 #define DEBUG_PRINTLN(var)
 #endif
 
+static void onPubAck(uint16_t packetId);
+
 // Internal MQTT client
-static WiFiClient wifiClient;
+static MqttSniffClient wifiClient(onPubAck);
 static PubSubClient mqttClient(wifiClient);
 
 // Configuration storage
 static MQTT_Config_t g_config;
 
-// Subscription and handler management
+// Connection state machine
+static MQTT_State_t mqttState = MQTT_STATE_OFFLINE;
+// Session up, as last seen by the MQTT_Loop() task. The only connection state
+// other tasks read: PubSubClient::connected() may stop the socket, so it is
+// never called from a producer.
+static std::atomic<bool> linkUp(false);
+static TickType_t nextAttempt = 0;
+static uint8_t failedAttempts = 0;
+static char clientId[24];
+
+// Outbox: filled by any task, drained by the MQTT_Loop() task
+typedef struct {
+    char topic[MQTT_OUTBOX_TOPIC_MAX];
+    uint8_t payload[MQTT_OUTBOX_PAYLOAD_MAX];
+    uint16_t length;
+    uint8_t qos;
+    bool retain;
+} OutboxMsg_t;
+
+typedef struct {
+    std::atomic<uint32_t> queued;
+    std::atomic<uint32_t> sent;
+    std::atomic<uint32_t> dropped;
+    std::atomic<uint32_t> rejected;
+    std::atomic<uint32_t> failed;
+    std::atomic<uint32_t> retransmitted;
+} OutboxCounters_t;
+
+static BoundedQueue<OutboxMsg_t, MQTT_OUTBOX_HIGH_DEPTH> outboxHigh;
+static BoundedQueue<OutboxMsg_t, MQTT_OUTBOX_LOW_DEPTH> outboxLow;
+static OutboxCounters_t outboxCounters[MQTT_PRIO_COUNT];
+
+// Dequeued message waiting for a free QoS 1 slot (MQTT_Loop() task only)
+static OutboxMsg_t heldMsg;
+static MQTT_Priority_t heldPriority;
+static std::atomic<bool> heldValid(false);      // read by MQTT_OutboxPending() from any task
+
+// QoS 1 in-flight window: sent, waiting for PUBACK (MQTT_Loop() task only)
+typedef struct {
+    OutboxMsg_t msg;
+    MQTT_Priority_t priority;
+    uint16_t packetId;
+    uint8_t retries;
+    bool used;
+    TickType_t sentTick;
+} InFlight_t;
+
+static InFlight_t inFlight[MQTT_QOS1_WINDOW];
+static std::atomic<uint8_t> inFlightCount(0);
+static uint16_t lastPacketId = 0;
+static uint8_t packetBuffer[MQTT_OUTBOX_TOPIC_MAX + MQTT_OUTBOX_PAYLOAD_MAX + 9];
+
+// Subscription management
 #define MAX_SUBSCRIPTIONS 10
-#define MAX_HANDLERS 10
 
 typedef struct {
     char topic[128];
@@ -28,19 +85,16 @@ typedef struct {
     bool active;
 } Subscription_t;
 
-typedef struct {
-    char topic[128];
-    MQTT_MessageHandler_t handler;
-    bool active;
-} Handler_t;
-
 static Subscription_t subscriptions[MAX_SUBSCRIPTIONS];
-static Handler_t handlers[MAX_HANDLERS];
 static uint8_t subscriptionCount = 0;
-static uint8_t handlerCount = 0;
 
 // Forward declarations
-static void MQTT_Reconnect(void);
+static void MQTT_Reconnect(TickType_t now);
+static void scheduleRetry(TickType_t now);
+static bool outboxPost(const char* topic, const uint8_t* payload, uint16_t length,
+                       uint8_t qos, bool retain, MQTT_Priority_t priority);
+static void outboxDrain(TickType_t now);
+static void inFlightResendAll(void);
 static void mqttCallback(char* topic, byte* payload, unsigned int length);
 static void resubscribeAll(void);
 
@@ -56,29 +110,68 @@ void MQTT_Init(const MQTT_Config_t* cfg)
     // Initialize PubSubClient
     mqttClient.setServer(g_config.broker, g_config.port);
     mqttClient.setCallback(mqttCallback);
+    mqttClient.setKeepAlive(MQTT_KEEPALIVE_S);
+    mqttClient.setSocketTimeout(MQTT_SOCKET_TIMEOUT_S);
+    // Shared by both directions: the largest outbox message or the largest
+    // accepted incoming one, plus fixed header, topic length and packet id
+    mqttClient.setBufferSize(MQTT_OUTBOX_TOPIC_MAX + MQTT_OUTBOX_PAYLOAD_MAX > MQTT_HANDLER_TOPIC_MAX + MQTT_MAX_PAYLOAD_SIZE
+                             ? MQTT_OUTBOX_TOPIC_MAX + MQTT_OUTBOX_PAYLOAD_MAX + 9
+                             : MQTT_HANDLER_TOPIC_MAX + MQTT_MAX_PAYLOAD_SIZE + 9);
+
+    // Stable per device, so a persistent session is found again after a reconnect
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    snprintf(clientId, sizeof(clientId), "SoilMind-%02X%02X%02X%02X%02X%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    mqttState = MQTT_STATE_OFFLINE;
+    linkUp.store(false, std::memory_order_release);
+    failedAttempts = 0;
 
     // Initialize tables
     memset(subscriptions, 0, sizeof(subscriptions));
-    memset(handlers, 0, sizeof(handlers));
+    MqttDispatch_Clear();
     subscriptionCount = 0;
-    handlerCount = 0;
 
     DEBUG_PRINTLN("MQTT Core initialized successfully");
 #endif
 }
 
 // Main MQTT loop - non-blocking, designed for RTOS task
+// Each call does at most one bounded step, so a dead broker never holds the caller
 void MQTT_Loop(void)
 {
 #if MQTT_ENABLED == STD_ON
     // Only process MQTT if WiFi is connected
-    if (WIFI_IsConnected())
+    if (!WIFI_IsConnected())
     {
-        if (!mqttClient.connected())
+        if (mqttState != MQTT_STATE_OFFLINE)
         {
-            MQTT_Reconnect();
+            linkUp.store(false, std::memory_order_release);
+            wifiClient.stop();
+            mqttState = MQTT_STATE_OFFLINE;
         }
-        mqttClient.loop();
+        return;
+    }
+
+    TickType_t now = xTaskGetTickCount();
+
+    if (mqttState == MQTT_STATE_CONNECTED)
+    {
+        if (mqttClient.loop())
+        {
+            outboxDrain(now);
+        }
+        else
+        {
+            DEBUG_PRINTLN("MQTT connection lost, state " + String(mqttClient.state()));
+            linkUp.store(false, std::memory_order_release);
+            failedAttempts = 0;
+            scheduleRetry(now);
+        }
+    }
+    else
+    {
+        MQTT_Reconnect(now);
     }
 #endif
 }
@@ -87,37 +180,71 @@ void MQTT_Loop(void)
 bool MQTT_IsConnected(void)
 {
 #if MQTT_ENABLED == STD_ON
-    return mqttClient.connected();
+    return linkUp.load(std::memory_order_acquire);
 #else
     return false;
 #endif
 }
 
-// Publish message to topic
-bool MQTT_Publish(const char* topic, const char* payload, uint8_t qos, bool retain)
+MQTT_State_t MQTT_GetState(void)
+{
+    return mqttState;
+}
+
+// Close the broker session (before the radio is switched off)
+void MQTT_Disconnect(void)
 {
 #if MQTT_ENABLED == STD_ON
-    if (!WIFI_IsConnected() || !mqttClient.connected())
+    if (mqttClient.connected())
     {
-        DEBUG_PRINTLN("MQTT publish failed: Not connected");
-        return false;
+        mqttClient.disconnect();
+        DEBUG_PRINTLN("MQTT Disconnected");
     }
+    linkUp.store(false, std::memory_order_release);
+    wifiClient.stop();
+    mqttState = MQTT_STATE_OFFLINE;
+    failedAttempts = 0;
+#endif
+}
 
-    bool result = mqttClient.publish(topic, payload, retain);
-    if (result)
-    {
-        DEBUG_PRINTLN("Published to " + String(topic) + ": " + String(payload));
-    }
-    else
-    {
-        DEBUG_PRINTLN("MQTT publish failed");
-    }
-    return result;
+// Publish message to topic
+bool MQTT_Publish(const char* topic, const char* payload, uint8_t qos, bool retain, MQTT_Priority_t priority)
+{
+#if MQTT_ENABLED == STD_ON
+    return outboxPost(topic, (const uint8_t*)payload, (uint16_t)strlen(payload), qos, retain, priority);
+#else
+    return false;
+#endif
+}
+
+// Publish binary payload to topic
+bool MQTT_PublishRaw(const char* topic, const uint8_t* payload, uint16_t length, uint8_t qos, bool retain,
+                     MQTT_Priority_t priority)
+{
+#if MQTT_ENABLED == STD_ON
+    return outboxPost(topic, payload, length, qos, retain, priority);
 #else
     return false;
 #endif
 }
 
+uint32_t MQTT_OutboxPending(void)
+{
+    return outboxHigh.size() + outboxLow.size() + (heldValid.load(std::memory_order_relaxed) ? 1 : 0) +
+           inFlightCount.load(std::memory_order_relaxed);
+}
+
+void MQTT_GetOutboxStats(MQTT_Priority_t priority, MQTT_OutboxStats_t* stats)
+{
+    const OutboxCounters_t* c = &outboxCounters[priority < MQTT_PRIO_COUNT ? priority : MQTT_PRIO_LOW];
+    stats->queued = c->queued.load(std::memory_order_relaxed);
+    stats->sent = c->sent.load(std::memory_order_relaxed);
+    stats->dropped = c->dropped.load(std::memory_order_relaxed);
+    stats->rejected = c->rejected.load(std::memory_order_relaxed);
+    stats->failed = c->failed.load(std::memory_order_relaxed);
+    stats->retransmitted = c->retransmitted.load(std::memory_order_relaxed);
+}
+
 // Subscribe to a topic
 bool MQTT_Subscribe(const char* topic, uint8_t qos)
 {
@@ -162,104 +289,405 @@ bool MQTT_Subscribe(const char* topic, uint8_t qos)
 #endif
 }
 
-// Register a message handler for a topic
+// Register a message handler for a topic or topic filter
 bool MQTT_RegisterHandler(const char* topic, MQTT_MessageHandler_t handler)
 {
 #if MQTT_ENABLED == STD_ON
-    if (handlerCount >= MAX_HANDLERS)
+    if (!MqttDispatch_Add(topic, handler))
     {
-        DEBUG_PRINTLN("MQTT handler limit reached");
+        DEBUG_PRINTLN("MQTT handler not registered (table full or bad filter): " + String(topic));
         return false;
     }
 
-    // Check if handler already registered for this topic
-    for (uint8_t i = 0; i < handlerCount; i++)
+    DEBUG_PRINTLN("Handler registered for: " + String(topic));
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Internal: MQTT callback function - dispatches to registered handlers
+// The payload is passed on in place, without a copy
+static void mqttCallback(char* topic, byte* payload, unsigned int length)
+{
+#if MQTT_ENABLED == STD_ON
+    if (length > MQTT_MAX_PAYLOAD_SIZE)
+    {
+        DEBUG_PRINTLN("MQTT message dropped, " + String(length) + " bytes on " + String(topic));
+        return;
+    }
+
+    if (!MqttDispatch_Deliver(topic, payload, (uint16_t)length))
+    {
+        DEBUG_PRINTLN("MQTT message without handler on " + String(topic));
+    }
+#endif
+}
+
+// Internal: Reconnect to MQTT broker, one step per call
+// OFFLINE -> TCP_CONNECT right away when WiFi comes up; a failed step goes to
+// BACKOFF, and the wait doubles per failure up to MQTT_BACKOFF_MAX_MS
+static void MQTT_Reconnect(TickType_t now)
+{
+#if MQTT_ENABLED == STD_ON
+    switch (mqttState)
     {
-        if (strcmp(handlers[i].topic, topic) == 0)
+        case MQTT_STATE_OFFLINE:
+            failedAttempts = 0;
+            mqttState = MQTT_STATE_TCP_CONNECT;
+            break;
+
+        case MQTT_STATE_BACKOFF:
+            if ((int32_t)(now - nextAttempt) >= 0)
+            {
+                mqttState = MQTT_STATE_TCP_CONNECT;
+            }
+            break;
+
+        case MQTT_STATE_TCP_CONNECT:
+            DEBUG_PRINTLN("MQTT Reconnecting...");
+            if (wifiClient.connect(g_config.broker, g_config.port, MQTT_CONNECT_TIMEOUT_MS))
+            {
+                mqttState = MQTT_STATE_SESSION;
+            }
+            else
+            {
+                DEBUG_PRINTLN("MQTT broker unreachable");
+                scheduleRetry(now);
+            }
+            break;
+
+        case MQTT_STATE_SESSION:
+        {
+            // PubSubClient reuses the open socket and only waits for CONNACK
+            bool authenticate = g_config.username != NULL && strlen(g_config.username) > 0 &&
+                                g_config.password != NULL && strlen(g_config.password) > 0;
+
+            // Connect with or without authentication, no will
+            bool connected = mqttClient.connect(clientId,
+                                                authenticate ? g_config.username : NULL,
+                                                authenticate ? g_config.password : NULL,
+                                                NULL, 0, false, NULL,
+                                                MQTT_CLEAN_SESSION == STD_ON);
+
+            if (connected)
+            {
+                DEBUG_PRINTLN("MQTT Connected with ID: " + String(clientId));
+                mqttState = MQTT_STATE_CONNECTED;
+                failedAttempts = 0;
+                resubscribeAll();
+                inFlightResendAll();
+                linkUp.store(true, std::memory_order_release);
+            }
+            else
+            {
+                DEBUG_PRINTLN("MQTT Connection refused, state " + String(mqttClient.state()));
+                wifiClient.stop();
+                scheduleRetry(now);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+#endif
+}
+
+// Internal: Wait before the next attempt. Equal jitter (half fixed, half
+// random) keeps a fleet that lost the broker together from retrying in lockstep.
+static void scheduleRetry(TickType_t now)
+{
+#if MQTT_ENABLED == STD_ON
+    uint32_t delayMs = MQTT_BACKOFF_MIN_MS;
+    for (uint8_t i = 0; i < failedAttempts && delayMs < MQTT_BACKOFF_MAX_MS; i++)
+    {
+        delayMs *= 2;
+    }
+    if (delayMs > MQTT_BACKOFF_MAX_MS)
+    {
+        delayMs = MQTT_BACKOFF_MAX_MS;
+    }
+    delayMs = delayMs / 2 + esp_random() % (delayMs / 2 + 1);
+
+    if (failedAttempts < UINT8_MAX)
+    {
+        failedAttempts++;
+    }
+    nextAttempt = now + pdMS_TO_TICKS(delayMs);
+    mqttState = MQTT_STATE_BACKOFF;
+
+    DEBUG_PRINTLN("MQTT retry in " + String(delayMs) + " ms");
+#endif
+}
+
+// Internal: Push onto one outbox queue, applying its drop policy when full
+template <uint32_t N>
+static bool outboxPush(BoundedQueue<OutboxMsg_t, N>* queue, const OutboxMsg_t* msg,
+                       uint8_t policy, OutboxCounters_t* counters)
+{
+    if (queue->push(*msg))
+    {
+        return true;
+    }
+
+    if (policy == MQTT_DROP_OLDEST)
+    {
+        // Another producer may refill the freed cell first; one retry is enough
+        // to keep producers wait-free, losing the race counts as a rejection
+        OutboxMsg_t evicted;
+        if (queue->pop(&evicted))
+        {
+            counters->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (queue->push(*msg))
         {
-            DEBUG_PRINTLN("Handler already registered for: " + String(topic));
-            handlers[i].handler = handler; // Update handler
             return true;
         }
     }
 
-    // Add to handler table
-    strcpy(handlers[handlerCount].topic, topic);
-    handlers[handlerCount].handler = handler;
-    handlers[handlerCount].active = true;
-    handlerCount++;
+    counters->rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
 
-    DEBUG_PRINTLN("Handler registered for: " + String(topic));
+// Internal: Copy a message into the outbox and wake the MQTT_Loop() task
+static bool outboxPost(const char* topic, const uint8_t* payload, uint16_t length,
+                       uint8_t qos, bool retain, MQTT_Priority_t priority)
+{
+#if MQTT_ENABLED == STD_ON
+    // The flag only: the client belongs to the MQTT_Loop() task
+    if (!linkUp.load(std::memory_order_acquire))
+    {
+        DEBUG_PRINTLN("MQTT publish failed: Not connected");
+        return false;
+    }
+    if (strlen(topic) >= MQTT_OUTBOX_TOPIC_MAX || length > MQTT_OUTBOX_PAYLOAD_MAX)
+    {
+        DEBUG_PRINTLN("MQTT publish failed: message too large for the outbox");
+        return false;
+    }
+    if (priority >= MQTT_PRIO_COUNT)
+    {
+        priority = MQTT_PRIO_LOW;
+    }
+
+    OutboxMsg_t msg;
+    strcpy(msg.topic, topic);
+    memcpy(msg.payload, payload, length);
+    msg.length = length;
+    msg.qos = qos > 0 ? 1 : 0;     // QoS 2 is sent as QoS 1
+    msg.retain = retain;
+
+    OutboxCounters_t* counters = &outboxCounters[priority];
+    bool queued = (priority == MQTT_PRIO_HIGH)
+        ? outboxPush(&outboxHigh, &msg, MQTT_OUTBOX_HIGH_POLICY, counters)
+        : outboxPush(&outboxLow, &msg, MQTT_OUTBOX_LOW_POLICY, counters);
+
+    if (!queued)
+    {
+        DEBUG_PRINTLN("MQTT publish failed: outbox full");
+        return false;
+    }
+
+    counters->queued.fetch_add(1, std::memory_order_relaxed);
+    if (g_config.on_tx_pending != NULL)
+    {
+        g_config.on_tx_pending();
+    }
     return true;
 #else
     return false;
 #endif
 }
 
-// Internal: MQTT callback function - dispatches to registered handlers
-static void mqttCallback(char* topic, byte* payload, unsigned int length)
+// Internal: Write a QoS 1 PUBLISH for an in-flight slot; PubSubClient only
+// builds QoS 0 packets, so the packet is assembled here
+static bool inFlightSend(InFlight_t* slot, bool dup)
 {
 #if MQTT_ENABLED == STD_ON
-    // Safely copy payload
-    char buffer[256];
-    if (length >= sizeof(buffer)) length = sizeof(buffer) - 1;
-    for (unsigned int i = 0; i < length; i++) buffer[i] = (char)payload[i];
-    buffer[length] = '\0';
-
-    DEBUG_PRINTLN("MQTT Message received - Topic: " + String(topic) + ", Payload: " + String(buffer));
+    const OutboxMsg_t* msg = &slot->msg;
+    uint16_t topicLength = (uint16_t)strlen(msg->topic);
+    uint32_t remaining = 2 + topicLength + 2 + msg->length;
+
+    // Fixed header: PUBLISH, DUP, QoS 1, RETAIN; then the remaining length
+    size_t pos = 0;
+    packetBuffer[pos++] = 0x32 | (dup ? 0x08 : 0x00) | (msg->retain ? 0x01 : 0x00);
+    do
+    {
+        uint8_t digit = remaining & 0x7F;
+        remaining >>= 7;
+        packetBuffer[pos++] = digit | (remaining > 0 ? 0x80 : 0x00);
+    } while (remaining > 0);
+
+    packetBuffer[pos++] = (uint8_t)(topicLength >> 8);
+    packetBuffer[pos++] = (uint8_t)topicLength;
+    memcpy(&packetBuffer[pos], msg->topic, topicLength);
+    pos += topicLength;
+    packetBuffer[pos++] = (uint8_t)(slot->packetId >> 8);
+    packetBuffer[pos++] = (uint8_t)slot->packetId;
+    memcpy(&packetBuffer[pos], msg->payload, msg->length);
+    pos += msg->length;
+
+    slot->sentTick = xTaskGetTickCount();
+    return wifiClient.write(packetBuffer, pos) == pos;
+#else
+    return false;
+#endif
+}
 
-    // Dispatch to registered handlers
-    for (uint8_t i = 0; i < handlerCount; i++)
+// Internal: Next packet id, never 0 and never one still waiting for its PUBACK
+static uint16_t nextPacketId(void)
+{
+    for (;;)
     {
-        if (handlers[i].active && strcmp(handlers[i].topic, topic) == 0)
+        if (++lastPacketId == 0)
         {
-            if (handlers[i].handler != NULL)
+            lastPacketId = 1;
+        }
+
+        bool inUse = false;
+        for (uint8_t i = 0; i < MQTT_QOS1_WINDOW; i++)
+        {
+            if (inFlight[i].used && inFlight[i].packetId == lastPacketId)
             {
-                handlers[i].handler(buffer);
-                break; // Only one handler per topic
+                inUse = true;
+                break;
             }
         }
+        if (!inUse)
+        {
+            return lastPacketId;
+        }
     }
-#endif
 }
 
-// Internal: Reconnect to MQTT broker
-static void MQTT_Reconnect(void)
+// Internal: Put a QoS 1 message in the window and send it; false when the window is full
+static bool inFlightStart(const OutboxMsg_t* msg, MQTT_Priority_t priority)
 {
-#if MQTT_ENABLED == STD_ON
-    DEBUG_PRINTLN("MQTT Reconnecting...");
-    while (!mqttClient.connected())
+    for (uint8_t i = 0; i < MQTT_QOS1_WINDOW; i++)
+    {
+        InFlight_t* slot = &inFlight[i];
+        if (!slot->used)
+        {
+            slot->msg = *msg;
+            slot->priority = priority;
+            slot->packetId = nextPacketId();
+            slot->retries = 0;
+            slot->used = true;
+            inFlightCount++;
+
+            // A failed write is picked up by the retransmit timer
+            inFlightSend(slot, false);
+            DEBUG_PRINTLN("Published QoS 1 id " + String(slot->packetId) + " to " + String(msg->topic));
+            return true;
+        }
+    }
+    return false;
+}
+
+// Internal: PUBACK seen by the sniffing client, inside mqttClient.loop()
+static void onPubAck(uint16_t packetId)
+{
+    for (uint8_t i = 0; i < MQTT_QOS1_WINDOW; i++)
+    {
+        InFlight_t* slot = &inFlight[i];
+        if (slot->used && slot->packetId == packetId)
+        {
+            slot->used = false;
+            inFlightCount--;
+            outboxCounters[slot->priority].sent.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+// Internal: Resend with DUP what has not been acknowledged in time; give up
+// after MQTT_QOS1_MAX_RETRIES
+static void inFlightRetransmit(TickType_t now)
+{
+    for (uint8_t i = 0; i < MQTT_QOS1_WINDOW; i++)
     {
-        if (!WIFI_IsConnected())
+        InFlight_t* slot = &inFlight[i];
+        if (!slot->used || (now - slot->sentTick) < pdMS_TO_TICKS(MQTT_QOS1_RETRY_MS))
+        {
+            continue;
+        }
+
+        if (slot->retries >= MQTT_QOS1_MAX_RETRIES)
         {
-            delay(1000); // Wait until WiFi reconnects
+            DEBUG_PRINTLN("MQTT QoS 1 id " + String(slot->packetId) + " not acknowledged, dropped");
+            slot->used = false;
+            inFlightCount--;
+            outboxCounters[slot->priority].failed.fetch_add(1, std::memory_order_relaxed);
             continue;
         }
 
-        String clientId = "ESP32-SoilMind-" + String(random(0xffff), HEX);
-        bool connected = false;
+        slot->retries++;
+        outboxCounters[slot->priority].retransmitted.fetch_add(1, std::memory_order_relaxed);
+        inFlightSend(slot, true);
+    }
+}
 
-        // Connect with or without authentication
-        if (g_config.username != NULL && strlen(g_config.username) > 0 &&
-            g_config.password != NULL && strlen(g_config.password) > 0)
+// Internal: After a reconnect the protocol wants every unacknowledged PUBLISH sent again
+static void inFlightResendAll(void)
+{
+    for (uint8_t i = 0; i < MQTT_QOS1_WINDOW; i++)
+    {
+        if (inFlight[i].used)
         {
-            connected = mqttClient.connect(clientId.c_str(), g_config.username, g_config.password);
+            outboxCounters[inFlight[i].priority].retransmitted.fetch_add(1, std::memory_order_relaxed);
+            inFlightSend(&inFlight[i], true);
         }
-        else
+    }
+}
+
+// Internal: Send up to MQTT_OUTBOX_BURST messages, high priority first. QoS 1
+// messages go out without waiting for each PUBACK, up to MQTT_QOS1_WINDOW at once.
+static void outboxDrain(TickType_t now)
+{
+#if MQTT_ENABLED == STD_ON
+    inFlightRetransmit(now);
+
+    for (uint8_t i = 0; i < MQTT_OUTBOX_BURST; i++)
+    {
+        if (!heldValid.load(std::memory_order_relaxed))
         {
-            connected = mqttClient.connect(clientId.c_str());
+            heldPriority = MQTT_PRIO_HIGH;
+            if (!outboxHigh.pop(&heldMsg))
+            {
+                heldPriority = MQTT_PRIO_LOW;
+                if (!outboxLow.pop(&heldMsg))
+                {
+                    return;
+                }
+            }
+            heldValid.store(true, std::memory_order_relaxed);
         }
 
-        if (connected)
+        if (heldMsg.qos > 0)
+        {
+            if (!inFlightStart(&heldMsg, heldPriority))
+            {
+                return;     // window full: keep the message until a PUBACK frees a slot
+            }
+        }
+        else if (mqttClient.publish(heldMsg.topic, heldMsg.payload, heldMsg.length, heldMsg.retain))
         {
-            DEBUG_PRINTLN("MQTT Connected with ID: " + clientId);
-            resubscribeAll();
+            outboxCounters[heldPriority].sent.fetch_add(1, std::memory_order_relaxed);
+            DEBUG_PRINTLN("Published " + String(heldMsg.length) + " bytes to " + String(heldMsg.topic));
         }
         else
         {
-            DEBUG_PRINTLN("MQTT Connection failed, retrying in 2 seconds...");
-            delay(2000);
+            outboxCounters[heldPriority].failed.fetch_add(1, std::memory_order_relaxed);
+            DEBUG_PRINTLN("MQTT publish failed");
         }
+        heldValid.store(false, std::memory_order_relaxed);
+    }
+
+    // Burst used up with more waiting: come straight back
+    if ((outboxHigh.size() + outboxLow.size()) > 0 && g_config.on_tx_pending != NULL)
+    {
+        g_config.on_tx_pending();
     }
 #endif
 }
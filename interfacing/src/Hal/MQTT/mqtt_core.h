@@ -9,25 +9,78 @@ typedef struct {
     int port;
     const char* username;
     const char* password;
+    void (*on_tx_pending)(void);    // wake whoever calls MQTT_Loop(), may be NULL
 } MQTT_Config_t;
 
-// Message Handler Function Pointer
-typedef void (*MQTT_MessageHandler_t)(const char* payload);
+// Outbox priority; every HIGH message is sent before any LOW one
+typedef enum {
+    MQTT_PRIO_HIGH = 0,         // decisions, commands, status
+    MQTT_PRIO_LOW,              // telemetry, replay
+    MQTT_PRIO_COUNT
+} MQTT_Priority_t;
+
+typedef struct {
+    uint32_t queued;
+    uint32_t sent;
+    uint32_t dropped;           // evicted by a newer message (MQTT_DROP_OLDEST)
+    uint32_t rejected;          // refused because the queue was full (MQTT_DROP_NEWEST)
+    uint32_t failed;            // socket write failed, or QoS 1 never acknowledged
+    uint32_t retransmitted;     // QoS 1 resent with DUP
+} MQTT_OutboxStats_t;
+
+// Connection state, advanced one step per MQTT_Loop() call
+typedef enum {
+    MQTT_STATE_OFFLINE = 0,     // no WiFi
+    MQTT_STATE_BACKOFF,         // waiting for the next attempt
+    MQTT_STATE_TCP_CONNECT,     // open the socket, at most MQTT_CONNECT_TIMEOUT_MS
+    MQTT_STATE_SESSION,         // CONNECT/CONNACK, at most MQTT_SOCKET_TIMEOUT_S
+    MQTT_STATE_CONNECTED
+} MQTT_State_t;
+
+// Message handler. topic and payload point into the client's receive buffer:
+// valid only during the call, payload not NUL terminated.
+typedef void (*MQTT_MessageHandler_t)(const char* topic, const uint8_t* payload, uint16_t length);
 
 // Public API for MQTT Core Module
 // Generic and reusable - handles connection, reconnection, and message dispatching
 // Contains NO business logic
+//
+// Only the task that calls MQTT_Loop() touches the client. MQTT_Publish*() from
+// any task copy the message into a lock-free outbox and return at once; the
+// MQTT_Loop() task sends it. MQTT_Init/Subscribe/RegisterHandler belong to the
+// MQTT_Loop() task as well (they run from the WiFi connect callback).
 
 void MQTT_Init(const MQTT_Config_t* cfg);
 void MQTT_Loop(void);                 // Called inside RTOS task - non-blocking
-bool MQTT_IsConnected(void);
+bool MQTT_IsConnected(void);           // Any task: the session as last seen by MQTT_Loop()
+MQTT_State_t MQTT_GetState(void);
+void MQTT_Disconnect(void);
 
+// Queue a message; false when not connected, too large, or refused by the
+// queue's drop policy. Never blocks. QoS 1 messages are resent until the broker
+// acknowledges them (MQTT_QOS1_*), across reconnects; QoS 2 is sent as QoS 1.
 bool MQTT_Publish(const char* topic,
                   const char* payload,
                   uint8_t qos = 0,
-                  bool retain = false);
+                  bool retain = false,
+                  MQTT_Priority_t priority = MQTT_PRIO_LOW);
+
+// Binary payload (may contain NUL bytes)
+bool MQTT_PublishRaw(const char* topic,
+                     const uint8_t* payload,
+                     uint16_t length,
+                     uint8_t qos = 0,
+                     bool retain = false,
+                     MQTT_Priority_t priority = MQTT_PRIO_LOW);
+
+// Messages waiting in the outbox or for a PUBACK; any task
+uint32_t MQTT_OutboxPending(void);
+void MQTT_GetOutboxStats(MQTT_Priority_t priority, MQTT_OutboxStats_t* stats);
 
 bool MQTT_Subscribe(const char* topic, uint8_t qos = 0);
+
+// topic may be a filter with '+' and '#' wildcards; an exact topic wins over
+// a wildcard match. Messages above MQTT_MAX_PAYLOAD_SIZE are dropped.
 bool MQTT_RegisterHandler(const char* topic,
                           MQTT_MessageHandler_t handler);
 
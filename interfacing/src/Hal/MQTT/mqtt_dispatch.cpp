@@ -0,0 +1,227 @@
+#include "mqtt_dispatch.h"
+#include <string.h>
+#include "../../Utils/Fnv1a/Fnv1a.h"
+#include "../../APP_Cfg.h"
+
+#define DISPATCH_MAX_LEVELS   8     // literal levels in front of a wildcard
+
+// Hash slots: a power of two, at most half full
+static constexpr uint32_t dispatchSlots(uint32_t n)
+{
+    return n >= 2 * MQTT_MAX_HANDLERS ? n : dispatchSlots(n * 2);
+}
+#define DISPATCH_SLOTS        dispatchSlots(1)
+
+typedef struct {
+    char filter[MQTT_HANDLER_TOPIC_MAX];
+    MQTT_MessageHandler_t handler;
+    uint32_t hash;              // exact: whole topic; wildcard: literal prefix incl. '/'
+    uint32_t parentHash;        // "a/b/#" also matches "a/b": hash of "a/b"
+    uint8_t levels;             // wildcard: literal levels in front of it
+    bool wildcard;
+} DispatchEntry_t;
+
+static DispatchEntry_t entries[MQTT_MAX_HANDLERS];
+static uint8_t entryCount = 0;
+
+// Exact topics: slot holds entry index + 1, 0 = empty
+static uint8_t exactSlots[DISPATCH_SLOTS];
+
+// Wildcard filters in registration order
+static uint8_t wildcards[MQTT_MAX_HANDLERS];
+static uint8_t wildcardCount = 0;
+
+// MQTT filter match, level by level
+static bool topicMatches(const char* filter, const char* topic)
+{
+    // '$SYS'-style topics are never matched by a leading wildcard
+    if (topic[0] == '$' && (filter[0] == '+' || filter[0] == '#'))
+    {
+        return false;
+    }
+
+    for (;;)
+    {
+        if (*filter == '#')
+        {
+            return true;
+        }
+        if (*filter == '+')
+        {
+            filter++;
+            while (*topic != '\0' && *topic != '/')
+            {
+                topic++;
+            }
+        }
+        else
+        {
+            while (*filter != '\0' && *filter != '/')
+            {
+                if (*filter++ != *topic++)
+                {
+                    return false;
+                }
+            }
+        }
+
+        if (*filter == '\0')
+        {
+            return *topic == '\0';
+        }
+        // *filter == '/'
+        if (*topic != '/')
+        {
+            return *topic == '\0' && strcmp(filter, "/#") == 0;
+        }
+        filter++;
+        topic++;
+    }
+}
+
+// '+' and '#' must fill a whole level, '#' only as the last one
+static bool filterValid(const char* filter, bool* wildcard)
+{
+    *wildcard = false;
+    for (const char* p = filter; *p != '\0'; p++)
+    {
+        if (*p != '+' && *p != '#')
+        {
+            continue;
+        }
+        bool levelStart = (p == filter) || (p[-1] == '/');
+        bool levelEnd = (p[1] == '\0') || (p[1] == '/');
+        if (!levelStart || !levelEnd || (*p == '#' && p[1] != '\0'))
+        {
+            return false;
+        }
+        *wildcard = true;
+    }
+    return true;
+}
+
+static int16_t exactFind(uint32_t hash, const char* topic)
+{
+    for (uint32_t i = hash & (DISPATCH_SLOTS - 1); exactSlots[i] != 0; i = (i + 1) & (DISPATCH_SLOTS - 1))
+    {
+        const DispatchEntry_t* entry = &entries[exactSlots[i] - 1];
+        if (entry->hash == hash && strcmp(entry->filter, topic) == 0)
+        {
+            return exactSlots[i] - 1;
+        }
+    }
+    return -1;
+}
+
+void MqttDispatch_Clear(void)
+{
+    memset(exactSlots, 0, sizeof(exactSlots));
+    entryCount = 0;
+    wildcardCount = 0;
+}
+
+bool MqttDispatch_Add(const char* filter, MQTT_MessageHandler_t handler)
+{
+    bool wildcard;
+    if (handler == NULL || filter[0] == '\0' || strlen(filter) >= MQTT_HANDLER_TOPIC_MAX ||
+        !filterValid(filter, &wildcard))
+    {
+        return false;
+    }
+
+    // Same filter again: replace its handler
+    for (uint8_t i = 0; i < entryCount; i++)
+    {
+        if (strcmp(entries[i].filter, filter) == 0)
+        {
+            entries[i].handler = handler;
+            return true;
+        }
+    }
+    if (entryCount >= MQTT_MAX_HANDLERS)
+    {
+        return false;
+    }
+
+    DispatchEntry_t* entry = &entries[entryCount];
+    uint32_t hash = FNV1A_OFFSET;
+    uint32_t parentHash = 0;
+    uint8_t levels = 0;
+    const char* p = filter;
+
+    // Hash up to the first wildcard (the whole filter when there is none)
+    for (; *p != '\0' && !(wildcard && (*p == '+' || *p == '#')); p++)
+    {
+        if (*p == '/')
+        {
+            parentHash = hash;
+            levels++;
+        }
+        hash = Fnv1a_Step(hash, (uint8_t)*p);
+    }
+    if (wildcard && levels > DISPATCH_MAX_LEVELS)
+    {
+        return false;
+    }
+
+    strcpy(entry->filter, filter);
+    entry->handler = handler;
+    entry->hash = hash;
+    entry->parentHash = (*p == '#' && levels > 0) ? parentHash : 0;
+    entry->levels = levels;
+    entry->wildcard = wildcard;
+
+    if (wildcard)
+    {
+        wildcards[wildcardCount++] = entryCount;
+    }
+    else
+    {
+        uint32_t i = hash & (DISPATCH_SLOTS - 1);
+        while (exactSlots[i] != 0)
+        {
+            i = (i + 1) & (DISPATCH_SLOTS - 1);
+        }
+        exactSlots[i] = entryCount + 1;
+    }
+    entryCount++;
+    return true;
+}
+
+bool MqttDispatch_Deliver(const char* topic, const uint8_t* payload, uint16_t length)
+{
+    // One pass: whole-topic hash plus the hash after each of the first levels
+    uint32_t levelHash[DISPATCH_MAX_LEVELS + 1];
+    uint8_t levels = 0;
+    uint32_t hash = FNV1A_OFFSET;
+    levelHash[0] = hash;
+
+    for (const char* p = topic; *p != '\0'; p++)
+    {
+        hash = Fnv1a_Step(hash, (uint8_t)*p);
+        if (*p == '/' && levels < DISPATCH_MAX_LEVELS)
+        {
+            levelHash[++levels] = hash;
+        }
+    }
+
+    int16_t index = exactFind(hash, topic);
+    if (index >= 0)
+    {
+        entries[index].handler(topic, payload, length);
+        return true;
+    }
+
+    for (uint8_t i = 0; i < wildcardCount; i++)
+    {
+        const DispatchEntry_t* entry = &entries[wildcards[i]];
+        bool candidate = (entry->levels <= levels && levelHash[entry->levels] == entry->hash) ||
+                         (entry->parentHash != 0 && entry->parentHash == hash);
+        if (candidate && topicMatches(entry->filter, topic))
+        {
+            entry->handler(topic, payload, length);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,29 @@
+#ifndef MQTT_DISPATCH_H
+#define MQTT_DISPATCH_H
+
+#include <stdint.h>
+#include "mqtt_core.h"
+
+// Internal to mqtt_core: maps incoming topics to message handlers.
+//
+// - Exact topics sit in an open-addressing table keyed by their FNV-1a hash.
+//   A message hashes its topic once and normally costs one probe and one
+//   string compare, however many handlers are registered.
+// - Filters with MQTT wildcards ('+' one level, '#' the rest) are kept apart
+//   with the hash of their literal levels in front of the first wildcard.
+//   While hashing the topic the hash at every '/' is noted, so a filter is
+//   only matched level by level when its prefix hash already agrees.
+// - An exact handler wins over wildcard ones; among wildcards the first
+//   registered match wins. One handler per message.
+//
+// Only the MQTT_Loop() task calls these.
+
+void MqttDispatch_Clear(void);
+
+// False when the table is full or the filter is malformed/too long
+bool MqttDispatch_Add(const char* filter, MQTT_MessageHandler_t handler);
+
+// Call the handler for topic; false when there is none
+bool MqttDispatch_Deliver(const char* topic, const uint8_t* payload, uint16_t length);
+
+#endif // MQTT_DISPATCH_H
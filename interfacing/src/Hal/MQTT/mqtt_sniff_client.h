@@ -0,0 +1,133 @@
+#ifndef MQTT_SNIFF_CLIENT_H
+#define MQTT_SNIFF_CLIENT_H
+
+#include <WiFi.h>
+
+// Internal to mqtt_core: the WiFiClient PubSubClient talks through.
+//
+// PubSubClient only speaks QoS 0 on the publish side and drops PUBACKs in
+// loop(). This wrapper forwards everything to the socket unchanged and follows
+// the MQTT framing of the bytes PubSubClient reads, so mqtt_core learns about
+// every PUBACK without a second reader on the socket.
+class MqttSniffClient : public Client
+{
+public:
+    typedef void (*PubAckFn_t)(uint16_t packetId);
+
+    explicit MqttSniffClient(PubAckFn_t onPubAck) : onPubAck(onPubAck)
+    {
+        resetParser();
+    }
+
+    int connect(IPAddress ip, uint16_t port) { resetParser(); return socket.connect(ip, port); }
+    int connect(const char* host, uint16_t port) { resetParser(); return socket.connect(host, port); }
+    int connect(IPAddress ip, uint16_t port, int32_t timeout) { resetParser(); return socket.connect(ip, port, timeout); }
+    int connect(const char* host, uint16_t port, int32_t timeout) { resetParser(); return socket.connect(host, port, timeout); }
+
+    size_t write(uint8_t b) { return socket.write(b); }
+    size_t write(const uint8_t* buf, size_t size) { return socket.write(buf, size); }
+    int available() { return socket.available(); }
+    int peek() { return socket.peek(); }
+    void flush() { socket.flush(); }
+    void stop() { socket.stop(); resetParser(); }
+    uint8_t connected() { return socket.connected(); }
+    operator bool() { return (bool)socket; }
+
+    int read()
+    {
+        int b = socket.read();
+        if (b >= 0)
+        {
+            feed((uint8_t)b);
+        }
+        return b;
+    }
+
+    int read(uint8_t* buf, size_t size)
+    {
+        int n = socket.read(buf, size);
+        for (int i = 0; i < n; i++)
+        {
+            feed(buf[i]);
+        }
+        return n;
+    }
+
+private:
+    enum { PARSE_HEADER, PARSE_LENGTH, PARSE_BODY };
+
+    WiFiClient socket;
+    PubAckFn_t onPubAck;
+
+    uint8_t parseState;
+    uint8_t header;
+    uint32_t remaining;
+    uint32_t multiplier;
+    uint8_t bodyPos;
+    uint8_t packetId[2];
+
+    void resetParser(void)
+    {
+        parseState = PARSE_HEADER;
+        remaining = 0;
+        bodyPos = 0;
+    }
+
+    // Fixed header, variable-length remaining length, body
+    void feed(uint8_t b)
+    {
+        switch (parseState)
+        {
+            case PARSE_HEADER:
+                header = b;
+                remaining = 0;
+                multiplier = 1;
+                bodyPos = 0;
+                parseState = PARSE_LENGTH;
+                break;
+
+            case PARSE_LENGTH:
+                remaining += (uint32_t)(b & 0x7F) * multiplier;
+                multiplier <<= 7;
+                if ((b & 0x80) == 0)
+                {
+                    if (remaining == 0)
+                    {
+                        packetDone();
+                    }
+                    else
+                    {
+                        parseState = PARSE_BODY;
+                    }
+                }
+                break;
+
+            case PARSE_BODY:
+                if (bodyPos < sizeof(packetId))
+                {
+                    packetId[bodyPos] = b;
+                }
+                if (bodyPos < 0xFF)
+                {
+                    bodyPos++;
+                }
+                if (--remaining == 0)
+                {
+                    packetDone();
+                }
+                break;
+        }
+    }
+
+    void packetDone(void)
+    {
+        // PUBACK: type 4, body is the packet id
+        if ((header & 0xF0) == 0x40 && bodyPos >= sizeof(packetId) && onPubAck != NULL)
+        {
+            onPubAck((uint16_t)((packetId[0] << 8) | packetId[1]));
+        }
+        parseState = PARSE_HEADER;
+    }
+};
+
+#endif // MQTT_SNIFF_CLIENT_H
@@ -10,12 +10,15 @@
 #endif
 
 
+// Target of the single-pump API
 static Pump_t* pumpConfig = NULL;
 
-//This function initializes the Pump by initializing the PWM with 20 kHz frequency
+//This function initializes a Pump by initializing its PWM with 20 kHz frequency
 void Pump_Init(Pump_t* config) {
 #if PUMP_ENABLED == STD_ON
-    pumpConfig = config;
+    if(pumpConfig == NULL) {
+        pumpConfig = config;
+    }
     DEBUG_PRINTLN("Pump Initialized");
     
     // Set PWM frequency to 20 kHz for pump
@@ -28,49 +31,51 @@ void Pump_Init(Pump_t* config) {
     PWM_initChannel(&(config->pwmConfig));
     
     // Initialize pump to stopped state (0% duty cycle)
-    Pump_Stop();
+    Pump_Run(config, 0.0);
 #endif
 }
 
-//This function starts the pump by setting PWM duty cycle to 100%
-void Pump_Start(void) {
+//This function sets a pump's speed by setting its PWM duty cycle to the specified percentage
+void Pump_Run(Pump_t* pump, float speedPercentage) {
 #if PUMP_ENABLED == STD_ON
-    if(pumpConfig == NULL) {
+    if(pump == NULL) {
         DEBUG_PRINTLN("Pump not initialized");
         return;
     }
-    PWM_setDutyCycle(pumpConfig->pwmConfig.channel, 100.0);
-    DEBUG_PRINTLN("Pump Started");
+    // Clamp speed between 0 and 100
+    if(speedPercentage < 0.0) {
+        speedPercentage = 0.0;
+    }
+    if(speedPercentage > 100.0) {
+        speedPercentage = 100.0;
+    }
+    PWM_setDutyCycle(pump->pwmConfig.channel, speedPercentage);
+    pump->speed = speedPercentage;
+    DEBUG_PRINTLN("Pump " + String(pump->pwmConfig.channel) + " Speed Set to: " + String(speedPercentage) + "%");
+#endif
+}
+
+float Pump_GetSpeed(const Pump_t* pump) {
+    return pump != NULL ? pump->speed : 0.0f;
+}
+
+//This function starts the pump by setting PWM duty cycle to 100%
+void Pump_Start(void) {
+#if PUMP_ENABLED == STD_ON
+    Pump_Run(pumpConfig, 100.0);
 #endif
 }
 
 //This function stops the pump by setting PWM duty cycle to 0%
 void Pump_Stop(void) {
 #if PUMP_ENABLED == STD_ON
-    if(pumpConfig == NULL) {
-        DEBUG_PRINTLN("Pump not initialized");
-        return;
-    }
-    PWM_setDutyCycle(pumpConfig->pwmConfig.channel, 0.0);
-    DEBUG_PRINTLN("Pump Stopped");
+    Pump_Run(pumpConfig, 0.0);
 #endif
 }
 
 //This function sets the pump speed by setting PWM duty cycle to the specified percentage
 void Pump_SetSpeed(float speedPercentage) {
 #if PUMP_ENABLED == STD_ON
-    if(pumpConfig == NULL) {
-        DEBUG_PRINTLN("Pump not initialized");
-        return;
-    }
-    // Clamp speed between 0 and 100
-    if(speedPercentage < 0.0) {
-        speedPercentage = 0.0;
-    }
-    if(speedPercentage > 100.0) {
-        speedPercentage = 100.0;
-    }
-    PWM_setDutyCycle(pumpConfig->pwmConfig.channel, speedPercentage);
-    DEBUG_PRINTLN("Pump Speed Set to: " + String(speedPercentage) + "%");
+    Pump_Run(pumpConfig, speedPercentage);
 #endif
-}
\ No newline at end of file
+}
@@ -4,18 +4,26 @@
 #include "../PWM/PWM.h"
 
 
+// One pump or valve output; the caller owns the instance
 typedef struct{
     PWM_t pwmConfig;
+    float speed;            // current duty cycle in percent, 0 = stopped
 }Pump_t;
 
 
 
 void Pump_Init(Pump_t* config);
 
+// Instance API, for nodes with several outputs (see App/ZoneManager)
+void Pump_Run(Pump_t* pump, float speedPercentage);
+
+float Pump_GetSpeed(const Pump_t* pump);
+
+// Single-pump API, drives the first pump passed to Pump_Init()
 void Pump_Start(void);
 
 void Pump_Stop(void);
 
 void Pump_SetSpeed(float speedPercentage);
 
-#endif
\ No newline at end of file
+#endif
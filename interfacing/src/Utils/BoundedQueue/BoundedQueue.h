@@ -0,0 +1,130 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Bounded lock-free queue for many producers (D. Vyukov's array queue).
+//
+// - N must be a power of two so indexing is a mask instead of a modulo.
+// - push() and pop() never block and never allocate: a full queue makes
+//   push() fail, an empty one makes pop() fail.
+// - Every cell carries a sequence number. A producer claims a cell by moving
+//   enqueuePos forward with a CAS, writes the value, then publishes it by
+//   bumping the cell's sequence; the consumer does the mirror image. A value
+//   is never visible half written.
+// - Any thread may pop as well, which lets a producer evict the oldest entry
+//   to make room (drop-oldest) without taking a lock.
+template <typename T, uint32_t N>
+class BoundedQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "BoundedQueue capacity must be a power of two");
+
+public:
+    BoundedQueue() : enqueuePos(0), dequeuePos(0)
+    {
+        for (uint32_t i = 0; i < N; i++)
+        {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Producer: append a copy of value, false when full
+    bool push(const T &value)
+    {
+        uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+
+        for (;;)
+        {
+            cell = &cells[pos & MASK];
+            uint32_t seq = cell->seq.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(seq - pos);
+
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;   // full: the cell still holds a value from the previous lap
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = value;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: take the oldest value, false when empty
+    bool pop(T *value)
+    {
+        uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+
+        for (;;)
+        {
+            cell = &cells[pos & MASK];
+            uint32_t seq = cell->seq.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(seq - (pos + 1));
+
+            if (diff == 0)
+            {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;   // empty: the producer has not published this cell yet
+            }
+            else
+            {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        *value = cell->data;
+        cell->seq.store(pos + MASK + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate while producers or the consumer are active
+    uint32_t size() const
+    {
+        return enqueuePos.load(std::memory_order_relaxed) - dequeuePos.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    static constexpr uint32_t capacity()
+    {
+        return N;
+    }
+
+private:
+    static constexpr uint32_t MASK = N - 1;
+
+    struct Cell
+    {
+        std::atomic<uint32_t> seq;
+        T data;
+    };
+
+    Cell cells[N];
+    std::atomic<uint32_t> enqueuePos;
+    std::atomic<uint32_t> dequeuePos;
+};
+
+#endif // BOUNDED_QUEUE_H
@@ -0,0 +1,22 @@
+#ifndef FNV1A_H
+#define FNV1A_H
+
+#include <stdint.h>
+
+// 32-bit FNV-1a: one xor and one multiply per byte, no table. Good enough to
+// index short strings such as MQTT topics; compare the strings on a hash hit.
+#define FNV1A_OFFSET 2166136261UL
+#define FNV1A_PRIME  16777619UL
+
+static inline uint32_t Fnv1a_Step(uint32_t hash, uint8_t byte)
+{
+    return (hash ^ byte) * FNV1A_PRIME;
+}
+
+// Also usable at compile time: constexpr uint32_t h = Fnv1a_Hash("a/b");
+constexpr uint32_t Fnv1a_Hash(const char *text, uint32_t hash = FNV1A_OFFSET)
+{
+    return *text ? Fnv1a_Hash(text + 1, (uint32_t)((hash ^ (uint8_t)*text) * FNV1A_PRIME)) : hash;
+}
+
+#endif // FNV1A_H
@@ -0,0 +1,343 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+// Heap-free JSON object writer over a caller-owned buffer.
+//
+// A payload is described by a schema: a constexpr array of JsonField_t giving
+// each key, its value type and its widest rendering. JsonWriter_MaxLength()
+// folds a schema into the worst-case payload size at compile time, so
+//     static char buf[JsonWriter_MaxLength(schema) + 1];
+// can never overflow. Numbers are formatted here rather than with printf,
+// whose float path allocates on newlib. On overflow the writer stops and
+// ok() returns false.
+//
+// An object may hold one level of arrays of objects ("key":[{..},{..}]); size
+// those with the element schema times the element count on top of the outer
+// schema, where an array field counts as "[]".
+
+typedef enum
+{
+    JSON_TYPE_STRING = 0,
+    JSON_TYPE_INT,
+    JSON_TYPE_FLOAT,
+    JSON_TYPE_BOOL,
+    JSON_TYPE_ARRAY         // of objects, see beginArray()
+} JsonType_t;
+
+typedef struct
+{
+    const char *key;
+    JsonType_t type;
+    uint8_t decimals;       // JSON_TYPE_FLOAT
+    uint8_t maxLength;      // JSON_TYPE_STRING: longest value, unescaped
+} JsonField_t;
+
+#define JSON_FIELD_STRING(key, maxLength) {key, JSON_TYPE_STRING, 0, maxLength}
+#define JSON_FIELD_INT(key)               {key, JSON_TYPE_INT, 0, 0}
+#define JSON_FIELD_FLOAT(key, decimals)   {key, JSON_TYPE_FLOAT, decimals, 0}
+#define JSON_FIELD_BOOL(key)              {key, JSON_TYPE_BOOL, 0, 0}
+#define JSON_FIELD_ARRAY(key)             {key, JSON_TYPE_ARRAY, 0, 0}
+
+// Nesting levels below the root object
+#define JSON_MAX_DEPTH 3
+
+// Float values are limited to +-JSON_FLOAT_LIMIT so the integer part fits in
+// 10 digits; anything outside is written as null
+#define JSON_FLOAT_LIMIT 2.0e9f
+
+constexpr size_t JsonWriter_KeyLength(const char *key)
+{
+    return *key ? 1 + JsonWriter_KeyLength(key + 1) : 0;
+}
+
+constexpr size_t JsonWriter_ValueLength(const JsonField_t &field)
+{
+    return field.type == JSON_TYPE_STRING ? 2 + 2 * (size_t)field.maxLength  // quoted, every char escaped
+         : field.type == JSON_TYPE_INT    ? 11                                // -2147483648
+         : field.type == JSON_TYPE_FLOAT  ? 12 + (size_t)field.decimals       // sign, 10 digits, point
+         : field.type == JSON_TYPE_ARRAY  ? 2                                 // [], elements sized separately
+         :                                  5;                                // false
+}
+
+// {"k":v,"k":v}
+template <size_t N>
+constexpr size_t JsonWriter_MaxLength(const JsonField_t (&schema)[N])
+{
+    size_t length = 2;
+    for (size_t i = 0; i < N; i++)
+    {
+        length += JsonWriter_KeyLength(schema[i].key) + 3 + JsonWriter_ValueLength(schema[i]) + 1;
+    }
+    return length;
+}
+
+class JsonWriter
+{
+public:
+    JsonWriter(char *buffer, size_t size) : buf(buffer), cap(size), len(0), fields(0), depth(0), overflow(false)
+    {
+        if (cap > 0)
+        {
+            buf[0] = '\0';
+        }
+    }
+
+    void beginObject()
+    {
+        len = 0;
+        fields = 0;
+        depth = 0;
+        overflow = false;
+        put('{');
+    }
+
+    // "key":[ in the current object; close with endArray()
+    void beginArray(const JsonField_t &field)
+    {
+        beginField(field.key);
+        put('[');
+        enter();
+    }
+
+    void endArray()
+    {
+        leave();
+        put(']');
+    }
+
+    // Next {..} element of the open array; close with endElement()
+    void beginElement()
+    {
+        if (fields++ > 0)
+        {
+            put(',');
+        }
+        put('{');
+        enter();
+    }
+
+    void endElement()
+    {
+        leave();
+        put('}');
+    }
+
+    // Returns the finished, NUL-terminated payload (or NULL on overflow)
+    const char *endObject()
+    {
+        put('}');
+        terminate();
+        return overflow ? NULL : buf;
+    }
+
+    void add(const JsonField_t &field, const char *value)
+    {
+        beginField(field.key);
+        putString(value);
+    }
+
+    void add(const JsonField_t &field, int32_t value)
+    {
+        beginField(field.key);
+        putInt(value);
+    }
+
+    void add(const JsonField_t &field, uint32_t value)
+    {
+        beginField(field.key);
+        putUnsigned(value, 1);
+    }
+
+    void add(const JsonField_t &field, float value)
+    {
+        beginField(field.key);
+        putFloat(value, field.decimals);
+    }
+
+    void add(const JsonField_t &field, bool value)
+    {
+        beginField(field.key);
+        putRaw(value ? "true" : "false");
+    }
+
+    bool ok() const { return !overflow; }
+    size_t length() const { return len; }
+    const char *c_str() const { return buf; }
+
+private:
+    char *buf;
+    size_t cap;
+    size_t len;
+    uint8_t fields;
+    uint8_t depth;
+    uint8_t outerFields[JSON_MAX_DEPTH];
+    bool overflow;
+
+    // Each level keeps its own field count for the commas
+    void enter()
+    {
+        if (depth < JSON_MAX_DEPTH)
+        {
+            outerFields[depth++] = fields;
+            fields = 0;
+        }
+        else
+        {
+            overflow = true;
+        }
+    }
+
+    void leave()
+    {
+        if (depth > 0)
+        {
+            fields = outerFields[--depth];
+        }
+    }
+
+    void put(char c)
+    {
+        // Always keep room for the terminator
+        if (len + 1 < cap)
+        {
+            buf[len++] = c;
+        }
+        else
+        {
+            overflow = true;
+        }
+    }
+
+    void putRaw(const char *s)
+    {
+        while (*s)
+        {
+            put(*s++);
+        }
+    }
+
+    void terminate()
+    {
+        if (cap > 0)
+        {
+            buf[len < cap ? len : cap - 1] = '\0';
+        }
+    }
+
+    void beginField(const char *key)
+    {
+        if (fields++ > 0)
+        {
+            put(',');
+        }
+        putString(key);
+        put(':');
+    }
+
+    void putString(const char *s)
+    {
+        put('"');
+        for (; s != NULL && *s; s++)
+        {
+            char c = *s;
+            if (c == '"' || c == '\\')
+            {
+                put('\\');
+                put(c);
+            }
+            else if ((uint8_t)c < 0x20)
+            {
+                put(' ');   // control characters have no place in our payloads
+            }
+            else
+            {
+                put(c);
+            }
+        }
+        put('"');
+    }
+
+    void putUnsigned(uint32_t value, uint8_t minDigits)
+    {
+        char digits[10];
+        uint8_t n = 0;
+        do
+        {
+            digits[n++] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value != 0 && n < sizeof(digits));
+        while (n < minDigits && n < sizeof(digits))
+        {
+            digits[n++] = '0';
+        }
+        while (n > 0)
+        {
+            put(digits[--n]);
+        }
+    }
+
+    void putInt(int32_t value)
+    {
+        uint32_t magnitude = (uint32_t)value;
+        if (value < 0)
+        {
+            put('-');
+            magnitude = 0U - magnitude;
+        }
+        putUnsigned(magnitude, 1);
+    }
+
+    void putFloat(float value, uint8_t decimals)
+    {
+        if (isnan(value) || isinf(value) || fabsf(value) >= JSON_FLOAT_LIMIT)
+        {
+            putRaw("null");
+            return;
+        }
+        if (decimals > 6)
+        {
+            decimals = 6;
+        }
+
+        uint32_t scale = 1;
+        for (uint8_t i = 0; i < decimals; i++)
+        {
+            scale *= 10;
+        }
+
+        // Round half away from zero, like printf
+        double magnitude = fabs((double)value) * scale + 0.5;
+        uint64_t fixed = (uint64_t)magnitude;
+        uint32_t whole = (uint32_t)(fixed / scale);
+        uint32_t fraction = (uint32_t)(fixed % scale);
+
+        if (value < 0 && fixed != 0)
+        {
+            put('-');
+        }
+        putUnsigned(whole, 1);
+        if (decimals > 0)
+        {
+            put('.');
+            putUnsigned(fraction, decimals);
+        }
+    }
+};
+
+// Writer with its own storage sized for a schema
+template <size_t SIZE>
+class JsonBuffer : public JsonWriter
+{
+public:
+    JsonBuffer() : JsonWriter(storage, SIZE) {}
+
+private:
+    char storage[SIZE];
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,68 @@
+#ifndef LATEST_VALUE_H
+#define LATEST_VALUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Sequence-locked single-writer cell holding the most recent value of T.
+//
+// The cell keeps two copies of the value (a seqlock "latch"): while the writer
+// updates one copy the sequence number steers readers to the other, so
+// - the writer never waits for readers,
+// - a reader never waits for a writer that was preempted mid-update, it only
+//   repeats its copy if a whole new store() completed while it was copying.
+// T must be trivially copyable (plain structs of numbers).
+template <typename T>
+class LatestValue
+{
+public:
+    LatestValue() : seq(0), copies() {}
+
+    // Single writer only
+    void store(const T &value)
+    {
+        uint32_t s = seq.load(std::memory_order_relaxed);
+
+        // Odd: readers use copies[1] while copies[0] is rewritten
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        copies[0] = value;
+
+        // Even: readers use copies[0] while copies[1] is rewritten
+        seq.store(s + 2, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        copies[1] = value;
+    }
+
+    // Any task; returns false if nothing was ever stored
+    bool load(T *out) const
+    {
+        for (;;)
+        {
+            uint32_t before = seq.load(std::memory_order_acquire);
+            if (before < 2)
+            {
+                return false;
+            }
+            T copy = copies[before & 1u];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == before)
+            {
+                *out = copy;
+                return true;
+            }
+        }
+    }
+
+    // Number of completed stores
+    uint32_t version(void) const
+    {
+        return seq.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    std::atomic<uint32_t> seq;
+    T copies[2];
+};
+
+#endif // LATEST_VALUE_H
@@ -0,0 +1,211 @@
+#ifndef ROLLING_WINDOW_H
+#define ROLLING_WINDOW_H
+
+#include <stdint.h>
+
+// The last N samples of one signal with their statistics kept up to date.
+//
+// - push() adds a sample and, once the window is full, drops the oldest.
+//   Every accessor is O(1), so N can be hundreds of samples.
+// - Mean and variance follow Welford's update, extended to the sample that
+//   leaves the window. Float error would creep in over a long run, so they
+//   are recomputed from the samples once per lap of the window: O(N) every
+//   N pushes.
+// - Min and max come from monotonic queues of sample slots: each slot is
+//   queued and dropped at most once, amortized O(1) per push.
+// - One owner; there is no locking.
+template <uint32_t N>
+class RollingWindow
+{
+    static_assert(N >= 2 && N <= 0xFFFF, "RollingWindow size must be 2..65535");
+
+public:
+    RollingWindow()
+    {
+        clear();
+    }
+
+    void clear(void)
+    {
+        for (uint32_t i = 0; i < N; i++)
+        {
+            samples[i] = 0.0f;
+        }
+        head = 0;
+        count = 0;
+        meanValue = 0.0f;
+        m2 = 0.0f;
+        minQueue.clear();
+        maxQueue.clear();
+    }
+
+    void push(float x)
+    {
+        uint32_t slot = head;
+
+        if (count == N)
+        {
+            // Take the oldest sample out before its slot is reused
+            float old = samples[slot];
+            float newMean = meanValue + (x - old) / N;
+            m2 += (x - old) * (x - newMean + old - meanValue);
+            meanValue = newMean;
+            if (m2 < 0.0f)
+            {
+                m2 = 0.0f;
+            }
+            minQueue.expire(slot);
+            maxQueue.expire(slot);
+        }
+        else
+        {
+            count++;
+            float delta = x - meanValue;
+            meanValue += delta / count;
+            m2 += delta * (x - meanValue);
+        }
+
+        samples[slot] = x;
+        minQueue.add(samples, slot, false);
+        maxQueue.add(samples, slot, true);
+        head = (slot + 1 == N) ? 0 : slot + 1;
+
+        if (head == 0 && count == N)
+        {
+            resync();
+        }
+    }
+
+    uint32_t size(void) const
+    {
+        return count;
+    }
+
+    bool full(void) const
+    {
+        return count == N;
+    }
+
+    // stepsAgo = 0 is the newest sample
+    float at(uint32_t stepsAgo) const
+    {
+        return samples[(head + N - 1 - stepsAgo % N) % N];
+    }
+
+    float mean(void) const
+    {
+        return meanValue;
+    }
+
+    // Population variance, as numpy and pandas' std(ddof=0)
+    float variance(void) const
+    {
+        return count > 0 ? m2 / count : 0.0f;
+    }
+
+    float min(void) const
+    {
+        return count > 0 ? samples[minQueue.front()] : 0.0f;
+    }
+
+    float max(void) const
+    {
+        return count > 0 ? samples[maxQueue.front()] : 0.0f;
+    }
+
+    // Newest minus oldest; 0 until there are two samples
+    float trend(void) const
+    {
+        return count >= 2 ? at(0) - at(count - 1) : 0.0f;
+    }
+
+    // Copy the samples, oldest first; returns how many. Pushing them into a
+    // cleared window restores it, statistics included.
+    uint32_t snapshot(float *out) const
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            out[i] = at(count - 1 - i);
+        }
+        return count;
+    }
+
+    static constexpr uint32_t capacity(void)
+    {
+        return N;
+    }
+
+private:
+    // Slots whose samples are increasing (min) or decreasing (max) from the
+    // front; the front is the extreme of the window
+    struct MonotonicQueue
+    {
+        uint16_t slots[N];
+        uint32_t first;
+        uint32_t length;
+
+        void clear(void)
+        {
+            first = 0;
+            length = 0;
+        }
+
+        uint32_t front(void) const
+        {
+            return slots[first];
+        }
+
+        // The sample in slot is leaving the window
+        void expire(uint32_t slot)
+        {
+            if (length > 0 && slots[first] == slot)
+            {
+                first = (first + 1 == N) ? 0 : first + 1;
+                length--;
+            }
+        }
+
+        // Samples the new one beats can never be the extreme again
+        void add(const float *values, uint32_t slot, bool keepLargest)
+        {
+            while (length > 0)
+            {
+                float back = values[slots[(first + length - 1) % N]];
+                if (keepLargest ? back > values[slot] : back < values[slot])
+                {
+                    break;
+                }
+                length--;
+            }
+            slots[(first + length) % N] = (uint16_t)slot;
+            length++;
+        }
+    };
+
+    // Exact mean and M2 from the samples, two passes
+    void resync(void)
+    {
+        float sum = 0.0f;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            sum += samples[i];
+        }
+        meanValue = sum / count;
+        m2 = 0.0f;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            float delta = samples[i] - meanValue;
+            m2 += delta * delta;
+        }
+    }
+
+    float samples[N];
+    uint32_t head;              // slot the next sample goes to
+    uint32_t count;
+    float meanValue;
+    float m2;                   // sum of squared deviations from the mean
+    MonotonicQueue minQueue;
+    MonotonicQueue maxQueue;
+};
+
+#endif // ROLLING_WINDOW_H
@@ -0,0 +1,158 @@
+#ifndef SENSOR_RING_H
+#define SENSOR_RING_H
+
+#include <stdint.h>
+#include <atomic>
+
+typedef enum
+{
+    queue_ok,
+    queue_empty,
+}queue_t;
+
+// Lock-free single-producer / multi-reader ring for sensor samples.
+//
+// - N must be a power of two so indexing is a mask instead of a modulo.
+// - When the ring is full the producer overwrites the oldest sample, it never
+//   blocks and never fails.
+// - Every slot carries a sequence stamp (seqlock style). A reader checks the
+//   stamp before and after copying, so a slot overwritten while it is being read
+//   is detected and skipped instead of returning a torn value. A reader retries
+//   at most READ_TRIES times and then reports no data: on a single core a
+//   preempted producer cannot finish its write while the reader spins.
+// - Only the producer writes head. Readers never write the ring: each one
+//   keeps its own cursor and reads with readFrom(), so any number of readers
+//   can follow the same ring (SensorBus keeps one per consumer).
+template <typename T, uint32_t N>
+class SensorRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SensorRing capacity must be a power of two");
+
+public:
+    SensorRing() : head(0)
+    {
+        for (uint32_t i = 0; i < N; i++)
+        {
+            slots[i].seq.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Producer: append a sample, overwriting the oldest one when full
+    void push(const T &value)
+    {
+        uint32_t pos = head.load(std::memory_order_relaxed);
+        Slot &slot = slots[pos & MASK];
+
+        slot.seq.store(SLOT_BUSY, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.data = value;
+        slot.seq.store(stamp(pos), std::memory_order_release);
+
+        head.store(pos + 1, std::memory_order_release);
+    }
+
+    // Read the oldest sample at or after *cursor.
+    // On success *cursor is advanced past the returned sample; samples the
+    // producer overwrote before the reader got to them are added to *lost.
+    // queue_empty also covers a slot still being written: the cursor stays
+    // put and the next call reads it.
+    queue_t readFrom(uint32_t *cursor, T *value, uint32_t *lost) const
+    {
+        for (uint32_t attempt = 0; attempt < READ_TRIES; attempt++)
+        {
+            uint32_t pos = *cursor;
+            uint32_t newest = head.load(std::memory_order_acquire);
+
+            if (pos == newest)
+            {
+                return queue_empty;
+            }
+
+            // Producer lapped the reader: jump to the oldest sample still in the ring
+            if ((uint32_t)(newest - pos) > N)
+            {
+                *lost += (newest - pos) - N;
+                pos = newest - N;
+                *cursor = pos;
+            }
+
+            if (readSlot(pos, value))
+            {
+                *cursor = pos + 1;
+                return queue_ok;
+            }
+            // Slot was rewritten while copying, re-evaluate against the new head
+        }
+        return queue_empty;
+    }
+
+    // Latest sample without consuming anything
+    queue_t peek(T *value) const
+    {
+        for (uint32_t attempt = 0; attempt < READ_TRIES; attempt++)
+        {
+            uint32_t newest = head.load(std::memory_order_acquire);
+            if (newest == 0)
+            {
+                return queue_empty;
+            }
+            if (readSlot(newest - 1, value))
+            {
+                return queue_ok;
+            }
+        }
+        return queue_empty;
+    }
+
+    // Total samples ever pushed; also the cursor value meaning "fully caught up"
+    uint32_t published(void) const
+    {
+        return head.load(std::memory_order_acquire);
+    }
+
+    static constexpr uint32_t capacity(void)
+    {
+        return N;
+    }
+
+private:
+    static constexpr uint32_t MASK = N - 1;
+    static constexpr uint32_t SLOT_BUSY = 0;
+    static constexpr uint32_t READ_TRIES = 3;
+
+    struct Slot
+    {
+        std::atomic<uint32_t> seq; // stamp(position) once published, SLOT_BUSY while being written
+        T data;
+    };
+
+    // position + 1, skipping SLOT_BUSY when the position wraps
+    static uint32_t stamp(uint32_t pos)
+    {
+        return (pos + 1 == SLOT_BUSY) ? 1 : pos + 1;
+    }
+
+    bool readSlot(uint32_t pos, T *value) const
+    {
+        const Slot &slot = slots[pos & MASK];
+
+        uint32_t before = slot.seq.load(std::memory_order_acquire);
+        if (before != stamp(pos))
+        {
+            return false;
+        }
+        T copy = slot.data;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != before)
+        {
+            return false;
+        }
+        *value = copy;
+        return true;
+    }
+
+    Slot slots[N];
+    std::atomic<uint32_t> head;
+};
+
+#endif // SENSOR_RING_H